@@ -0,0 +1,299 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 19 Oct 2026 9:02:31pm
+    Author:  ashigam
+
+    Renders decks through DJAudioPlayer and DeckMixer without a sound card,
+    over a matrix of block sizes, speed ratios and deck counts, and reports
+    for each run:
+      - ns per sample:      render time per output sample, all decks together
+      - allocations/block:  heap allocations the rendering thread makes
+      - worst block:        the slowest block, and its share of the block duration
+
+    usage: OtoDecksBench [--quick] [--seconds n] [--csv file] [audio files...]
+
+    A synthetic track is always rendered; audio files given on the command
+    line are rendered as well. With --csv the results are appended to a file,
+    one row per run, so builds can be compared.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "DeckMixer.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//==============================================================================
+// allocations are counted on the thread that renders, while a block is measured
+namespace
+{
+    thread_local bool countingAllocations = false;
+    std::atomic<juce::int64> allocationCount{ 0 };
+
+    inline void countAllocation()
+    {
+        if (countingAllocations)
+            ++allocationCount;
+    }
+}
+
+#if defined(__GLIBC__)
+// glibc: catch malloc itself, which covers operator new, HeapBlock and AudioBuffer
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+
+    void* malloc(size_t size)
+    {
+        countAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        countAllocation();
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        countAllocation();
+        return __libc_realloc(ptr, size);
+    }
+}
+#else
+// elsewhere only operator new is counted
+void* operator new(std::size_t size)
+{
+    countAllocation();
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept              { std::free(ptr); }
+void operator delete[](void* ptr) noexcept            { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept   { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+//==============================================================================
+namespace
+{
+    const double sampleRate = 44100.0;
+    const double syntheticSeconds = 60.0;
+    const double syntheticBpm = 128.0;
+
+    // decks start this far apart, so they never read the same windows
+    const double deckSpacing = 1.7;
+
+    struct Run
+    {
+        juce::String source;
+        int numDecks = 1;
+        int blockSize = 512;
+        double speed = 1.0;
+    };
+
+    struct Result
+    {
+        double nanosecondsPerSample = 0.0;
+        double allocationsPerBlock = 0.0;
+        double worstBlockMicroseconds = 0.0;
+        double worstBlockShare = 0.0;
+    };
+
+    /**
+    *   Write a track with a beat, a bass line and hats, so every stage has
+    *   something to do.
+    *   @param file the WAV file to write
+    *   @return true if it was written
+    */
+    bool writeSyntheticTrack(const juce::File& file)
+    {
+        auto numSamples = (int) (syntheticSeconds * sampleRate);
+        juce::AudioBuffer<float> track(2, numSamples);
+        juce::Random random(42);
+
+        auto beatLength = 60.0 / syntheticBpm * sampleRate;
+        for (int i = 0; i < numSamples; ++i) {
+            auto sinceBeat = std::fmod((double) i, beatLength) / sampleRate;
+            auto time = i / sampleRate;
+
+            auto kick = std::sin(juce::MathConstants<double>::twoPi * 55.0 * sinceBeat) * std::exp(-sinceBeat * 12.0);
+            auto bass = 0.3 * std::sin(juce::MathConstants<double>::twoPi * 110.0 * time);
+            auto hat = std::fmod(sinceBeat * 2.0 * sampleRate, beatLength) < 800.0 ? 0.1 * (random.nextFloat() * 2.0 - 1.0) : 0.0;
+
+            track.setSample(0, i, (float) (0.5 * (kick + bass + hat)));
+            track.setSample(1, i, (float) (0.5 * (kick + bass - hat)));
+        }
+
+        file.deleteFile();
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(new juce::FileOutputStream(file),
+                                                                             sampleRate, 2, 16, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(track, 0, numSamples);
+    }
+
+    /**
+    *   Render one configuration.
+    *   @param file the track every deck plays
+    *   @param run the configuration
+    *   @param seconds how much output to measure
+    */
+    Result render(juce::AudioFormatManager& formatManager, const juce::File& file, const Run& run, double seconds)
+    {
+        juce::OwnedArray<DJAudioPlayer> players;
+        juce::Array<DJAudioPlayer*> decks;
+        for (int i = 0; i < run.numDecks; ++i)
+            decks.add(players.add(new DJAudioPlayer(formatManager)));
+
+        DeckMixer mixer(decks);
+        mixer.prepareToPlay(run.blockSize, sampleRate);
+
+        for (int i = 0; i < decks.size(); ++i) {
+            auto* deck = decks.getUnchecked(i);
+            deck->loadURL(juce::URL(file));
+
+            // far enough in to play forwards or backwards for the whole run
+            auto length = deck->getLengthInSeconds();
+            deck->setPosition(std::fmod(length * 0.3 + i * deckSpacing, juce::jmax(1.0, length)));
+            deck->setSpeed(run.speed);
+            deck->start();
+        }
+
+        juce::AudioBuffer<float> output(2, run.blockSize);
+        juce::AudioSourceChannelInfo info(&output, 0, run.blockSize);
+
+        // let the prefetchers fill their windows and the gain ramps settle
+        for (int i = 0; i < (int) (0.5 * sampleRate) / run.blockSize; ++i)
+            mixer.getNextAudioBlock(info);
+
+        auto numBlocks = juce::jmax(1, (int) (seconds * sampleRate) / run.blockSize);
+        juce::int64 totalTicks = 0, worstTicks = 0, allocations = 0;
+
+        for (int i = 0; i < numBlocks; ++i) {
+            allocationCount = 0;
+            countingAllocations = true;
+            auto start = juce::Time::getHighResolutionTicks();
+
+            mixer.getNextAudioBlock(info);
+
+            auto ticks = juce::Time::getHighResolutionTicks() - start;
+            countingAllocations = false;
+            allocations += allocationCount.load();
+
+            totalTicks += ticks;
+            worstTicks = juce::jmax(worstTicks, ticks);
+        }
+
+        mixer.releaseResources();
+
+        Result result;
+        auto totalSeconds = juce::Time::highResolutionTicksToSeconds(totalTicks);
+        result.nanosecondsPerSample = totalSeconds * 1.0e9 / ((double) numBlocks * run.blockSize);
+        result.allocationsPerBlock = (double) allocations / numBlocks;
+        result.worstBlockMicroseconds = juce::Time::highResolutionTicksToSeconds(worstTicks) * 1.0e6;
+        result.worstBlockShare = result.worstBlockMicroseconds * 1.0e-6 * sampleRate / run.blockSize;
+        return result;
+    }
+
+    /** append a row to the CSV file, with a header if the file is new */
+    void appendToCsv(const juce::File& csv, const Run& run, const Result& result)
+    {
+        juce::String row;
+        if (!csv.existsAsFile())
+            row << "source,decks,block,speed,ns_per_sample,allocs_per_block,worst_block_us,worst_block_share\n";
+
+        row << run.source << "," << run.numDecks << "," << run.blockSize << "," << run.speed << ","
+            << juce::String(result.nanosecondsPerSample, 2) << "," << juce::String(result.allocationsPerBlock, 3) << ","
+            << juce::String(result.worstBlockMicroseconds, 1) << "," << juce::String(result.worstBlockShare, 4) << "\n";
+
+        if (!csv.appendText(row))
+            std::cout << "EngineBenchmark could not write " << csv.getFullPathName() << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // the decks send change messages, which need a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    bool quick = false;
+    double seconds = 10.0;
+    juce::File csv;
+    juce::Array<juce::File> files;
+
+    for (int i = 1; i < argc; ++i) {
+        juce::String arg(argv[i]);
+        if (arg == "--quick")
+            quick = true;
+        else if (arg == "--seconds" && i + 1 < argc)
+            seconds = juce::jmax(0.1, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--csv" && i + 1 < argc)
+            csv = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else
+            files.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    auto synthetic = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("OtoDecksBench.wav");
+    if (!writeSyntheticTrack(synthetic)) {
+        std::cout << "EngineBenchmark could not write " << synthetic.getFullPathName() << std::endl;
+        return 1;
+    }
+    files.insert(0, synthetic);
+
+    // reverse play goes through the scratch path instead of the resampler
+    juce::Array<int> blockSizes = quick ? juce::Array<int>{ 256 } : juce::Array<int>{ 64, 128, 256, 512, 1024 };
+    juce::Array<double> speeds = quick ? juce::Array<double>{ 1.0, 1.08 } : juce::Array<double>{ 1.0, 0.92, 1.08, -1.0 };
+    juce::Array<int> deckCounts = quick ? juce::Array<int>{ 2 } : juce::Array<int>{ 1, 2, 4, 8 };
+
+    std::cout << "source                  decks  block   speed    ns/sample  allocs/block   worst block" << std::endl;
+
+    for (auto& file : files) {
+        if (!file.existsAsFile()) {
+            std::cout << "EngineBenchmark skipped " << file.getFullPathName() << ", it does not exist" << std::endl;
+            continue;
+        }
+
+        for (auto numDecks : deckCounts) {
+            for (auto blockSize : blockSizes) {
+                for (auto speed : speeds) {
+                    Run run{ file == synthetic ? juce::String("synthetic") : file.getFileName(), numDecks, blockSize, speed };
+                    auto result = render(formatManager, file, run, seconds);
+
+                    std::cout << run.source.paddedRight(' ', 22).substring(0, 22)
+                              << juce::String(numDecks).paddedLeft(' ', 7)
+                              << juce::String(blockSize).paddedLeft(' ', 7)
+                              << juce::String(speed, 2).paddedLeft(' ', 8)
+                              << juce::String(result.nanosecondsPerSample, 1).paddedLeft(' ', 13)
+                              << juce::String(result.allocationsPerBlock, 2).paddedLeft(' ', 14)
+                              << juce::String(result.worstBlockMicroseconds, 1).paddedLeft(' ', 10) << " us ("
+                              << juce::String(result.worstBlockShare * 100.0, 1) << "%)" << std::endl;
+
+                    if (csv != juce::File())
+                        appendToCsv(csv, run, result);
+                }
+            }
+        }
+    }
+
+    synthetic.deleteFile();
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    LibraryBenchmark.cpp
+    Created: 19 Oct 2026 10:14:52pm
+    Author:  ashigam
+
+    Builds a synthetic library of short audio files and times what the
+    playlist does with it, offscreen and without an audio device:
+      - startup:  constructing PlaylistComponent, before the window can show
+      - load:     loadLibraryAsync() until the library is listed, which loads the index and the lengths
+      - restore:  restoreLibrary() again, with the files in the OS cache
+      - search:   searchLibrary() with a common, a rare and a missing keyword
+      - sort:     sortOrderChanged() on every sortable column, both ways
+      - paint:    painting the table, and scrolling it through the library
+      - import:   copyFileToLibrary() of new files, per file
+
+    usage: OtoDecksLibraryBench [--tracks n] [--csv file] [--keep]
+
+    The library is written to a temporary folder which is the working
+    directory during the run, where PlaylistComponent looks for Tracks, and
+    the app data folder, where it looks for library.xml. Every track is in the index already, so no analysis runs
+    in the background. With --csv the results are appended to a file, one
+    row per measurement, so builds can be compared.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AppData.h"
+#include "DJAudioPlayer.h"
+#include "DeckMixer.h"
+#include "LibraryIndex.h"
+#include "PlaylistComponent.h"
+
+//==============================================================================
+namespace
+{
+    // the scan only reads the file headers, so a few samples per second keep 50k tracks small
+    const double trackSampleRate = 10.0;
+
+    const char* const words[] = { "Night", "Drive", "Deep", "House", "Sunset", "Echo", "Acid", "Groove",
+                                  "Tokyo", "Dub", "Velvet", "Rain", "Signal", "Fever", "Orbit", "Tide" };
+    const int numWords = (int) (sizeof(words) / sizeof(words[0]));
+
+    struct Measurement
+    {
+        juce::String metric;
+        double milliseconds = 0.0;
+        int rows = 0;
+    };
+
+    /** a title like "Deep Orbit - Tide Fever 01234.wav", unique by its number */
+    juce::String makeTitle(juce::Random& random, int number)
+    {
+        return juce::String(words[random.nextInt(numWords)]) + " " + words[random.nextInt(numWords)] + " - "
+             + words[random.nextInt(numWords)] + " " + words[random.nextInt(numWords)] + " "
+             + juce::String(number).paddedLeft('0', 5) + ".wav";
+    }
+
+    /**
+    *   Write a mono 8 bit track of one to ten minutes.
+    *   @param file the WAV file to write
+    *   @return true if it was written
+    */
+    bool writeTrack(const juce::File& file, juce::Random& random)
+    {
+        auto numSamples = (int) ((60 + random.nextInt(540)) * trackSampleRate);
+        juce::AudioBuffer<float> track(1, numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            track.setSample(0, i, random.nextFloat() * 0.5f - 0.25f);
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(new juce::FileOutputStream(file),
+                                                                             trackSampleRate, 1, 8, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(track, 0, numSamples);
+    }
+
+    /** time a function in milliseconds */
+    template <typename Function>
+    double measure(Function&& function)
+    {
+        auto start = juce::Time::getMillisecondCounterHiRes();
+        function();
+        return juce::Time::getMillisecondCounterHiRes() - start;
+    }
+
+    /** the table inside the playlist, which is painted and scrolled on its own */
+    juce::TableListBox* findTable(juce::Component& playlist)
+    {
+        for (auto* child : playlist.getChildren())
+            if (auto* table = dynamic_cast<juce::TableListBox*>(child))
+                return table;
+        return nullptr;
+    }
+
+    /** append a row to the CSV file, with a header if the file is new */
+    void appendToCsv(const juce::File& csv, int numTracks, const Measurement& measurement)
+    {
+        juce::String row;
+        if (!csv.existsAsFile())
+            row << "tracks,metric,milliseconds,rows\n";
+
+        row << numTracks << "," << measurement.metric << "," << juce::String(measurement.milliseconds, 3)
+            << "," << measurement.rows << "\n";
+
+        if (!csv.appendText(row))
+            std::cout << "LibraryBenchmark could not write " << csv.getFullPathName() << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // the playlist is a component, and the decks send change messages
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    int numTracks = 50000;
+    bool keep = false;
+    juce::File csv;
+
+    for (int i = 1; i < argc; ++i) {
+        juce::String arg(argv[i]);
+        if (arg == "--tracks" && i + 1 < argc)
+            numTracks = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--csv" && i + 1 < argc)
+            csv = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--keep")
+            keep = true;
+        else
+            std::cout << "LibraryBenchmark ignored " << arg << std::endl;
+    }
+
+    auto originalDirectory = juce::File::getCurrentWorkingDirectory();
+    auto root = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("OtoDecksLibraryBench");
+    root.deleteRecursively();
+    auto tracksFolder = root.getChildFile("Tracks");
+    auto importFolder = root.getChildFile("Import");
+    tracksFolder.createDirectory();
+    importFolder.createDirectory();
+
+    // the library, and a few more tracks to import later, about 1 in 50
+    juce::Random random(42);
+    auto numImports = juce::jlimit(1, 1000, numTracks / 50);
+    std::cout << "writing " << numTracks << " tracks to " << root.getFullPathName() << std::endl;
+
+    LibraryIndex index(root.getChildFile("library.xml"));
+    for (int i = 0; i < numTracks + numImports; ++i) {
+        auto file = (i < numTracks ? tracksFolder : importFolder).getChildFile(makeTitle(random, i));
+        if (!writeTrack(file, random)) {
+            std::cout << "LibraryBenchmark could not write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        // analysed already, so the analyser stays idle while the playlist is measured
+        if (i < numTracks) {
+            TrackAnalysis analysis;
+            analysis.bpm = 80.0 + random.nextInt(800) / 10.0;
+            analysis.key = random.nextInt(24);
+            index.setAnalysis(file, analysis);
+        }
+    }
+    index.save();
+
+    root.setAsCurrentWorkingDirectory();
+    AppData::setFolder(root);
+
+    juce::Array<Measurement> results;
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        juce::AudioThumbnailCache thumbCache{ 100 };
+
+        DJAudioPlayer player1{ formatManager };
+        DJAudioPlayer player2{ formatManager };
+        DeckMixer mixer{ { &player1, &player2 } };
+
+        std::unique_ptr<PlaylistComponent> playlist;
+        results.add({ "startup", measure([&] {
+            playlist = std::make_unique<PlaylistComponent>(&player1, &player2, &mixer,
+                                                           formatManager, thumbCache, formatManager, thumbCache);
+        }), playlist->getNumRows() });
+
+        // the list is filled in by a message posted from the loader thread
+        bool loaded = false;
+        playlist->onLibraryLoaded = [&loaded] { loaded = true; };
+        results.add({ "library load", measure([&] {
+            playlist->loadLibraryAsync();
+            while (!loaded)
+                juce::MessageManager::getInstance()->runDispatchLoopUntil(1);
+        }), playlist->getNumRows() });
+
+        results.add({ "restore", measure([&] {
+            playlist->resetAll();
+            playlist->restoreLibrary();
+        }), playlist->getNumRows() });
+
+        // a word in many titles, two words in a row, a number in one title only, and no match
+        for (auto keyword : { juce::String("Deep"), juce::String("Orbit Tide"), juce::String("00042"), juce::String("nothing") }) {
+            auto milliseconds = measure([&] { playlist->searchLibrary(keyword); });
+            results.add({ "search '" + keyword + "'", milliseconds, playlist->getNumRows() });
+        }
+        playlist->searchLibrary({});
+
+        // title, length, BPM, key, artist and bitrate
+        for (auto columnId : { 6, 3, 4, 5, 7, 10 }) {
+            for (auto forwards : { true, false }) {
+                auto milliseconds = measure([&] { playlist->sortOrderChanged(columnId, forwards); });
+                results.add({ "sort column " + juce::String(columnId) + (forwards ? " up" : " down"), milliseconds, playlist->getNumRows() });
+            }
+        }
+
+        // paint offscreen, at the size of the table in a 1200 x 800 window
+        playlist->setSize(1200, 800);
+        if (auto* table = findTable(*playlist)) {
+            auto visibleRows = table->getHeight() / table->getRowHeight();
+            results.add({ "paint visible rows", measure([&] {
+                table->createComponentSnapshot(table->getLocalBounds());
+            }), visibleRows });
+
+            // jump a page at a time, from the top to the bottom
+            double totalScroll = 0.0, worstScroll = 0.0;
+            int pages = 0;
+            for (int row = 0; row < playlist->getNumRows(); row += juce::jmax(1, visibleRows), ++pages) {
+                auto milliseconds = measure([&] {
+                    table->scrollToEnsureRowIsOnscreen(row);
+                    table->createComponentSnapshot(table->getLocalBounds());
+                });
+                totalScroll += milliseconds;
+                worstScroll = juce::jmax(worstScroll, milliseconds);
+            }
+            results.add({ "scroll page (mean)", totalScroll / juce::jmax(1, pages), visibleRows });
+            results.add({ "scroll page (worst)", worstScroll, visibleRows });
+        }
+
+        // the new tracks are analysed in the background, so this goes last
+        auto importFiles = importFolder.findChildFiles(juce::File::findFiles, false, "*.wav");
+        auto importMilliseconds = measure([&] {
+            for (auto& file : importFiles)
+                playlist->copyFileToLibrary(file);
+        });
+        results.add({ "import (per file)", importMilliseconds / juce::jmax(1, importFiles.size()), playlist->getNumRows() });
+
+        playlist.reset();
+    }
+
+    originalDirectory.setAsCurrentWorkingDirectory();
+
+    std::cout << "metric                           ms        rows" << std::endl;
+    for (auto& result : results) {
+        std::cout << result.metric.paddedRight(' ', 26)
+                  << juce::String(result.milliseconds, 3).paddedLeft(' ', 12)
+                  << juce::String(result.rows).paddedLeft(' ', 10) << std::endl;
+
+        if (csv != juce::File())
+            appendToCsv(csv, numTracks, result);
+    }
+
+    if (!keep)
+        root.deleteRecursively();
+    return 0;
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    AppData.cpp
+    Created: 21 Oct 2026 9:14:52am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "AppData.h"
+
+juce::File AppData::getFolder()
+{
+    auto folder = getOverride();
+    if (folder == juce::File()) {
+        folder = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
+       #if JUCE_MAC
+        folder = folder.getChildFile("Application Support");
+       #endif
+        folder = folder.getChildFile("OtoDecks");
+    }
+
+    if (!folder.isDirectory() && !folder.createDirectory())
+        std::cout << "AppData::getFolder could not create " << folder.getFullPathName() << std::endl;
+    return folder;
+}
+
+juce::File AppData::getFile(const juce::String& name)
+{
+    auto file = getFolder().getChildFile(name);
+
+    // earlier versions kept their files wherever the application was started
+    auto oldFile = juce::File::getCurrentWorkingDirectory().getChildFile(name);
+    if (getOverride() == juce::File() && !file.exists() && oldFile.existsAsFile())
+        oldFile.moveFileTo(file);
+    return file;
+}
+
+void AppData::setFolder(const juce::File& folder)
+{
+    getOverride() = folder;
+}
+
+juce::File& AppData::getOverride()
+{
+    static juce::File folder;
+    return folder;
+}
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    AppData.h
+    Created: 21 Oct 2026 9:14:52am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    The folder where the application keeps its own files between sessions:
+    the library index, the session, the MIDI mapping and the startup log.
+    It is under the user's application data, so it does not depend on the
+    directory the application is started from.
+*/
+class AppData
+{
+public:
+    /** get the folder, creating it the first time */
+    static juce::File getFolder();
+
+    /**
+    *   Get a file of the application. A file written to the working directory
+    *   by an earlier version is moved into the folder the first time.
+    *   @param name the file name
+    *   @return the file in the folder
+    */
+    static juce::File getFile(const juce::String& name);
+
+    /**
+    *   Use another folder, e.g. for a benchmark which must not touch the user's files.
+    *   Set it before the files are asked for.
+    *   @param folder the folder to use, a default File for the usual one
+    */
+    static void setFolder(const juce::File& folder);
+
+private:
+    static juce::File& getOverride();
+};
@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    Automix.cpp
+    Created: 19 Oct 2026 6:31:40am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "Automix.h"
+
+namespace
+{
+    // crossfades are handed to the audio thread this early; the message thread
+    // may stall for this long without the transition being late
+    const double scheduleAheadSeconds = 2.0;
+
+    const int beatsPerBar = 4;
+}
+
+Automix::Automix(DeckMixer* _mixer, DJAudioPlayer* deck1, DJAudioPlayer* deck2)
+    : mixer(_mixer), decks{ deck1, deck2 }
+{
+}
+
+Automix::~Automix()
+{
+    stopTimer();
+}
+
+void Automix::start(const juce::Array<juce::File>& tracks)
+{
+    queue = tracks;
+    nextTrack = 0;
+    nextLoaded = false;
+    transitionStart = transitionEnd = -1;
+
+    if (queue.isEmpty()) {
+        std::cout << "Automix::start the queue is empty" << std::endl;
+        return;
+    }
+
+    // follow a deck that is already playing
+    if (decks[0]->isPlaying() || decks[1]->isPlaying()) {
+        current = decks[0]->isPlaying() ? 0 : 1;
+    }
+    else {
+        current = 0;
+        if (onLoadTrack != nullptr)
+            onLoadTrack(decks[current], queue[nextTrack]);
+        ++nextTrack;
+        decks[current]->setPosition(getStartPoint(decks[current]));
+        mixer->scheduleStart(decks[current]);
+    }
+
+    running = true;
+    startTimer(100);
+}
+
+void Automix::stop()
+{
+    running = false;
+    stopTimer();
+
+    // a crossfade handed to the mixer already would still run
+    for (auto* deck : decks)
+        mixer->cancelCrossfade(deck);
+    transitionStart = transitionEnd = -1;
+}
+
+bool Automix::isRunning() const
+{
+    return running;
+}
+
+void Automix::setCrossfadeLength(double seconds)
+{
+    if (seconds < 1.0 || seconds > 30.0)
+        std::cout << "Automix::setCrossfadeLength seconds should be between 1 and 30" << std::endl;
+    else
+        crossfadeSeconds = seconds;
+}
+
+void Automix::timerCallback()
+{
+    auto clock = mixer->getMasterClock();
+
+    // the crossfade is over, the incoming deck carries the set now
+    if (transitionEnd >= 0 && clock >= transitionEnd) {
+        current = 1 - current;
+        nextLoaded = false;
+        transitionStart = transitionEnd = -1;
+    }
+    if (transitionStart >= 0)
+        return;
+
+    // stopped by hand, or the last track has ended
+    if (!decks[current]->isPlaying()) {
+        // the first track may not have reached the audio thread yet
+        if (clock > 0 && decks[current]->getPositionRelative() > 0.0)
+            stop();
+        return;
+    }
+
+    if (!nextLoaded)
+        preloadNext();
+    else
+        scheduleTransition();
+}
+
+void Automix::preloadNext()
+{
+    auto* idle = decks[1 - current];
+    if (nextTrack >= queue.size() || idle->isPlaying())
+        return;
+
+    if (onLoadTrack != nullptr)
+        onLoadTrack(idle, queue[nextTrack]);
+    ++nextTrack;
+
+    // parked at its start, the prefetcher decodes it from there in the background
+    idle->setPosition(getStartPoint(idle));
+    nextLoaded = true;
+}
+
+void Automix::scheduleTransition()
+{
+    auto* outgoing = decks[current];
+    auto* incoming = decks[1 - current];
+    auto sampleRate = mixer->getSampleRate();
+
+    auto endTime = outgoing->getClockTimeOfPosition(getEndPoint(outgoing));
+    if (endTime < 0)
+        return;
+
+    auto fadeLength = (juce::int64) (crossfadeSeconds * sampleRate);
+    auto startTime = endTime - fadeLength;
+
+    // start on the bar at or before that, the fade then runs up to the end point
+    auto bpm = outgoing->getBpm();
+    auto speed = outgoing->getSpeed();
+    if (bpm > 0 && speed > 0) {
+        auto samplesPerBar = (juce::int64) (beatsPerBar * 60.0 / bpm / speed * sampleRate);
+        auto bar = outgoing->getNextBarTime(startTime - samplesPerBar + 1, beatsPerBar);
+        if (bar >= 0 && bar <= startTime)
+            startTime = bar;
+    }
+
+    auto clock = mixer->getMasterClock();
+    if (startTime - clock > (juce::int64) (scheduleAheadSeconds * sampleRate))
+        return;
+
+    // a track shorter than the fade starts it right away
+    transitionStart = juce::jmax(startTime, clock);
+    transitionEnd = juce::jmax(transitionStart + 1, endTime);
+    mixer->scheduleCrossfade(outgoing, incoming, transitionStart, transitionEnd - transitionStart);
+}
+
+double Automix::getStartPoint(DJAudioPlayer* deck) const
+{
+    return deck->getAutoCue();
+}
+
+double Automix::getEndPoint(DJAudioPlayer* deck) const
+{
+    return deck->getAutoEnd();
+}
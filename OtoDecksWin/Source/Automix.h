@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    Automix.h
+    Created: 19 Oct 2026 6:31:40am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include "DJAudioPlayer.h"
+#include "DeckMixer.h"
+
+//==============================================================================
+/*
+    Plays a queue of tracks on two decks unattended.
+
+    While one deck plays, the next track is loaded onto the idle deck and
+    parked at its start point, so the prefetcher has decoded its start long
+    before it is needed. The crossfade is worked out ahead of time from the
+    end point of the playing track, moved back onto a bar when the track has
+    a beatgrid, and handed to DeckMixer a couple of seconds early. From then
+    on the audio thread carries it out at the exact sample, so a busy message
+    thread can neither delay it nor leave a gap.
+*/
+class Automix  : private juce::Timer
+{
+public:
+    /**
+    *   @param mixer the mixer that carries out the crossfades
+    *   @param deck1 one of the decks
+    *   @param deck2 the other deck
+    */
+    Automix(DeckMixer* mixer, DJAudioPlayer* deck1, DJAudioPlayer* deck2);
+    ~Automix() override;
+
+    /** loads a track onto a deck, together with its waveform and analysis */
+    std::function<void(DJAudioPlayer* deck, const juce::File& trackFile)> onLoadTrack;
+
+    /**
+    *   Start playing a queue. A deck that is already playing carries on and the
+    *   queue follows it, otherwise the first track starts straight away.
+    *   @param tracks the tracks in the order they are played
+    */
+    void start(const juce::Array<juce::File>& tracks);
+
+    /** stop taking tracks from the queue, the playing track carries on */
+    void stop();
+
+    /** true while the queue is being played */
+    bool isRunning() const;
+
+    /**
+    *   Set the length of the crossfades.
+    *   @param seconds the length, between 1 and 30 seconds
+    */
+    void setCrossfadeLength(double seconds);
+
+private:
+    void timerCallback() override;
+
+    /** load the next track of the queue onto the idle deck */
+    void preloadNext();
+
+    /** hand the crossfade to the mixer once it is close enough */
+    void scheduleTransition();
+
+    /** where a deck's track starts playing, in seconds */
+    double getStartPoint(DJAudioPlayer* deck) const;
+
+    /** where a deck's track should have faded out, in seconds */
+    double getEndPoint(DJAudioPlayer* deck) const;
+
+    DeckMixer* mixer;
+    DJAudioPlayer* decks[2];
+
+    juce::Array<juce::File> queue;
+    int nextTrack = 0;
+
+    bool running = false;
+    int current = 0;  // the deck playing the current track
+    bool nextLoaded = false;
+    double crossfadeSeconds = 8.0;
+
+    // master clock times of the scheduled crossfade, -1 while none is
+    juce::int64 transitionStart = -1;
+    juce::int64 transitionEnd = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Automix)
+};
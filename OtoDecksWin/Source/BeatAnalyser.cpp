@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+    BeatAnalyser.cpp
+    Created: 18 Oct 2026 1:21:47pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "BeatAnalyser.h"
+#include <cmath>
+
+namespace
+{
+    // four independent accumulators so the compiler can keep them in one vector register
+    float sumOf(const float* data, int num)
+    {
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        int i = 0;
+        for (; i + 4 <= num; i += 4) {
+            s0 += data[i];
+            s1 += data[i + 1];
+            s2 += data[i + 2];
+            s3 += data[i + 3];
+        }
+        for (; i < num; ++i)
+            s0 += data[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    float dotProduct(const float* a, const float* b, int num)
+    {
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        int i = 0;
+        for (; i + 4 <= num; i += 4) {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < num; ++i)
+            s0 += a[i] * b[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    // cut off of the low band, where kick drums live
+    const double lowBandHz = 150.0;
+
+    // the range of tempos searched, and the tempo the search is biased towards
+    const double minBpm = 60.0, maxBpm = 200.0, preferredBpm = 120.0;
+}
+
+BeatAnalyser::BeatAnalyser()
+{
+}
+
+BeatAnalyser::~BeatAnalyser()
+{
+}
+
+void BeatAnalyser::prepare(double _sampleRate, juce::int64 lengthInSamples)
+{
+    sampleRate = _sampleRate;
+    hopSize = juce::jmax(64, juce::roundToInt(sampleRate / 172.0));  // ~5.8 ms per envelope value
+
+    lowState = 0.0f;
+    hopEnergy = hopLowEnergy = 0.0;
+    hopFill = 0;
+    lastLogEnergy = lastLogLowEnergy = 0.0f;
+
+    onsets.clear();
+    lowOnsets.clear();
+    onsets.reserve((size_t) (lengthInSamples / hopSize + 1));
+    lowOnsets.reserve((size_t) (lengthInSamples / hopSize + 1));
+}
+
+void BeatAnalyser::process(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (numSamples > scratchSize) {
+        mono.allocate((size_t) numSamples, false);
+        low.allocate((size_t) numSamples, false);
+        scratchSize = numSamples;
+    }
+
+    // downmix to mono
+    juce::FloatVectorOperations::copy(mono, buffer.getReadPointer(0), numSamples);
+    if (buffer.getNumChannels() > 1) {
+        juce::FloatVectorOperations::add(mono, buffer.getReadPointer(1), numSamples);
+        juce::FloatVectorOperations::multiply(mono, 0.5f, numSamples);
+    }
+
+    // the low band needs a recursive filter, which is the only serial step
+    auto coeff = (float) (1.0 - std::exp(-2.0 * juce::MathConstants<double>::pi * lowBandHz / sampleRate));
+    auto state = lowState;
+    for (int i = 0; i < numSamples; ++i) {
+        state += coeff * (mono[i] - state);
+        low[i] = state;
+    }
+    lowState = state;
+
+    // square both bands, then sum the energy per hop
+    juce::FloatVectorOperations::multiply(mono, mono, numSamples);
+    juce::FloatVectorOperations::multiply(low, low, numSamples);
+
+    int i = 0;
+    while (i < numSamples) {
+        auto num = juce::jmin(hopSize - hopFill, numSamples - i);
+        hopEnergy += sumOf(mono + i, num);
+        hopLowEnergy += sumOf(low + i, num);
+        hopFill += num;
+        i += num;
+
+        if (hopFill == hopSize)
+            addHop();
+    }
+}
+
+void BeatAnalyser::addHop()
+{
+    // onset strength is the rise of the log energy, half-wave rectified
+    auto logEnergy = (float) std::log1p(1000.0 * hopEnergy / hopSize);
+    auto logLowEnergy = (float) std::log1p(1000.0 * hopLowEnergy / hopSize);
+
+    onsets.push_back(juce::jmax(0.0f, logEnergy - lastLogEnergy));
+    lowOnsets.push_back(juce::jmax(0.0f, logLowEnergy - lastLogLowEnergy));
+
+    lastLogEnergy = logEnergy;
+    lastLogLowEnergy = logLowEnergy;
+    hopEnergy = hopLowEnergy = 0.0;
+    hopFill = 0;
+}
+
+void BeatAnalyser::finish(TrackAnalysis& analysis)
+{
+    analysis.bpm = 0.0;
+    analysis.downbeatOffset = 0.0;
+
+    auto frameRate = sampleRate / hopSize;
+    auto numFrames = (int) onsets.size();
+    auto maxLag = (int) std::ceil(60.0 * frameRate / minBpm);
+    auto minLag = (int) std::floor(60.0 * frameRate / maxBpm);
+
+    // need a few bars at the slowest tempo to say anything
+    if (numFrames < maxLag * 8)
+        return;
+
+    std::vector<float> envelope(onsets);
+    juce::FloatVectorOperations::add(envelope.data(), lowOnsets.data(), numFrames);
+
+    // autocorrelation of the mean-free envelope over the tempo range
+    std::vector<float> centred(envelope);
+    auto mean = sumOf(centred.data(), numFrames) / numFrames;
+    juce::FloatVectorOperations::add(centred.data(), -mean, numFrames);
+
+    std::vector<double> acf((size_t) maxLag + 2, 0.0);
+    for (int lag = minLag - 1; lag <= maxLag + 1; ++lag)
+        acf[(size_t) lag] = dotProduct(centred.data(), centred.data() + lag, numFrames - lag)
+                            / (double) (numFrames - lag);
+
+    // weight towards typical dance tempos so the half/double tempo does not win
+    int bestLag = -1;
+    double bestScore = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        auto octaves = std::log2(60.0 * frameRate / lag / preferredBpm);
+        auto score = acf[(size_t) lag] * std::exp(-0.5 * (octaves / 0.9) * (octaves / 0.9));
+        if (bestLag < 0 || score > bestScore) {
+            bestLag = lag;
+            bestScore = score;
+        }
+    }
+    if (bestScore <= 0.0)
+        return;
+
+    // parabolic interpolation between the neighbouring lags
+    auto period = (double) bestLag;
+    auto y0 = acf[(size_t) bestLag - 1], y1 = acf[(size_t) bestLag], y2 = acf[(size_t) bestLag + 1];
+    auto denominator = y0 - 2.0 * y1 + y2;
+    if (denominator < 0.0)
+        period += juce::jlimit(-0.5, 0.5, 0.5 * (y0 - y2) / denominator);
+
+    // fold into the range DJs work in
+    auto bpm = 60.0 * frameRate / period;
+    while (bpm < 70.0)
+        bpm *= 2.0;
+    while (bpm > 180.0)
+        bpm /= 2.0;
+    period = 60.0 * frameRate / bpm;
+
+    // refine the period and find the beat phase with a comb over the whole track
+    auto bestPeriod = period;
+    double bestPhase = 0.0, bestComb = -1.0;
+    for (auto factor = 0.98; factor <= 1.0201; factor += 0.001) {
+        auto candidate = period * factor;
+        for (int phase = 0; phase < (int) candidate; ++phase) {
+            auto score = getCombScore(envelope, candidate, phase);
+            if (score > bestComb) {
+                bestComb = score;
+                bestPeriod = candidate;
+                bestPhase = phase;
+            }
+        }
+    }
+
+    // then a finer pass around the winner, with sub-hop phases
+    auto coarsePeriod = bestPeriod, coarsePhase = bestPhase;
+    for (auto factor = 0.999; factor <= 1.00101; factor += 0.0001) {
+        auto candidate = coarsePeriod * factor;
+        for (auto phase = coarsePhase - 2.0; phase <= coarsePhase + 2.0; phase += 0.25) {
+            if (phase < 0.0)
+                continue;
+            auto score = getCombScore(envelope, candidate, phase);
+            if (score > bestComb) {
+                bestComb = score;
+                bestPeriod = candidate;
+                bestPhase = phase;
+            }
+        }
+    }
+
+    // the downbeat is the beat of the bar with the strongest low band onsets
+    int bestBeat = 0;
+    double bestBar = -1.0;
+    for (int beat = 0; beat < 4; ++beat) {
+        auto score = getCombScore(lowOnsets, bestPeriod * 4.0, bestPhase + beat * bestPeriod);
+        if (score > bestBar) {
+            bestBar = score;
+            bestBeat = beat;
+        }
+    }
+
+    analysis.bpm = 60.0 * frameRate / bestPeriod;
+    analysis.downbeatOffset = (bestPhase + bestBeat * bestPeriod + 0.5) / frameRate;
+}
+
+double BeatAnalyser::getCombScore(const std::vector<float>& envelope, double period, double phase) const
+{
+    double score = 0.0;
+    int count = 0;
+    for (auto t = phase; t < (double) envelope.size() - 0.5; t += period) {
+        score += envelope[(size_t) juce::roundToInt(t)];
+        ++count;
+    }
+    return count > 0 ? score / count : 0.0;
+}
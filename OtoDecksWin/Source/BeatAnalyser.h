@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    BeatAnalyser.h
+    Created: 18 Oct 2026 1:21:47pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Estimates the tempo and the beatgrid of a track.
+
+    The audio is reduced to an onset strength envelope (the rise of the full
+    band and of the low band energy per hop), the tempo is the autocorrelation
+    peak of that envelope, and the grid phase is the comb alignment which
+    collects the most onset strength.
+*/
+class BeatAnalyser
+{
+public:
+    BeatAnalyser();
+    ~BeatAnalyser();
+
+    /**
+    *   Reset the analyser for a new track.
+    *   @param sampleRate the sample rate of the track
+    *   @param lengthInSamples the expected length, used to reserve memory
+    */
+    void prepare(double sampleRate, juce::int64 lengthInSamples);
+
+    /**
+    *   Feed the next block of the track.
+    *   @param buffer the decoded audio, one or two channels
+    *   @param numSamples the number of samples to use from the buffer
+    */
+    void process(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    /**
+    *   Estimate the tempo and the downbeat from everything fed so far.
+    *   @param analysis the analysis to fill in
+    */
+    void finish(TrackAnalysis& analysis);
+
+private:
+    void addHop();
+    double getCombScore(const std::vector<float>& envelope, double period, double phase) const;
+
+    double sampleRate = 44100.0;
+    int hopSize = 256;
+
+    // per block scratch, grown only when a bigger block arrives
+    juce::HeapBlock<float> mono, low;
+    int scratchSize = 0;
+
+    float lowState = 0.0f;
+    double hopEnergy = 0.0, hopLowEnergy = 0.0;
+    int hopFill = 0;
+    float lastLogEnergy = 0.0f, lastLogLowEnergy = 0.0f;
+
+    std::vector<float> onsets;
+    std::vector<float> lowOnsets;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BeatAnalyser)
+};
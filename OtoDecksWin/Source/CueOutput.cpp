@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    CueOutput.cpp
+    Created: 19 Oct 2026 2:07:44am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "CueOutput.h"
+#include <cmath>
+
+namespace
+{
+    // the largest speed change used to steer the FIFO, 0.2% is far below hearing
+    const double maxCorrection = 0.002;
+
+    // a fill error of the whole target maps onto the largest speed change
+    const double correctionGain = maxCorrection;
+
+    // how fast the correction follows the fill level, per callback
+    const double correctionSmoothing = 0.01;
+
+    // the highest main device rate the read buffer is sized for, so a restart of
+    // the main device never needs a larger buffer on the cue device thread
+    const double maxSourceRate = 192000.0;
+}
+
+CueOutput::CueOutput()
+{
+}
+
+CueOutput::~CueOutput()
+{
+    close();
+}
+
+bool CueOutput::open(const juce::String& typeName, const juce::String& deviceName, double sourceSampleRate)
+{
+    close();
+    setSourceSampleRate(sourceSampleRate);
+
+    // open the requested device straight away, as if it had been saved, instead of the default one first
+    juce::XmlElement state("DEVICESETUP");
+    state.setAttribute("deviceType", typeName);
+    state.setAttribute("audioOutputDeviceName", deviceName);
+    state.setAttribute("audioInputDeviceName", juce::String());
+
+    auto error = deviceManager.initialise(0, 2, &state, false);
+    if (error.isNotEmpty() || deviceManager.getCurrentAudioDevice() == nullptr) {
+        std::cout << "CueOutput::open can't open " << deviceName << " " << error << std::endl;
+        deviceManager.closeAudioDevice();
+        return false;
+    }
+
+    deviceManager.addAudioCallback(this);
+    deviceOpen = true;
+    return true;
+}
+
+void CueOutput::close()
+{
+    if (!deviceOpen)
+        return;
+
+    deviceManager.removeAudioCallback(this);
+    deviceManager.closeAudioDevice();
+    deviceOpen = false;
+}
+
+bool CueOutput::isOpen() const
+{
+    return deviceOpen;
+}
+
+void CueOutput::setSourceSampleRate(double sampleRate)
+{
+    if (sampleRate > 0)
+        sourceRate = sampleRate;
+}
+
+void CueOutput::push(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    auto lastChannel = buffer.getNumChannels() - 1;
+    for (int channel = 0; channel < 2 && lastChannel >= 0; ++channel) {
+        auto sourceChannel = juce::jmin(channel, lastChannel);
+        if (size1 > 0)
+            ring.copyFrom(channel, start1, buffer, sourceChannel, startSample, size1);
+        if (size2 > 0)
+            ring.copyFrom(channel, start2, buffer, sourceChannel, startSample + size1, size2);
+    }
+    fifo.finishedWrite(size1 + size2);
+}
+
+double CueOutput::getDriftPpm() const
+{
+    return drift * 1.0e6;
+}
+
+int CueOutput::getNumGlitches() const
+{
+    return glitches;
+}
+
+void CueOutput::audioDeviceIOCallback(const float** /*inputChannelData*/, int /*numInputChannels*/,
+                                      float** outputChannelData, int numOutputChannels, int numSamples)
+{
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+        if (outputChannelData[channel] != nullptr)
+            juce::FloatVectorOperations::clear(outputChannelData[channel], numSamples);
+
+    auto ready = fifo.getNumReady();
+
+    // wait for a cushion to build up, and throw away a backlog from before the start
+    if (!primed) {
+        if (ready < targetFill)
+            return;
+        fifo.finishedRead(ready - targetFill);
+        ready = targetFill;
+        correction = 0.0;
+        for (auto& interpolator : interpolators)
+            interpolator.reset();
+        primed = true;
+    }
+
+    // the main device restarted at another rate, so the cushion is worked out again
+    if (sourceRate != preparedSourceRate) {
+        preparedSourceRate = sourceRate;
+        updateTargetFill();
+        primed = false;
+        return;
+    }
+
+    // play a little faster while the FIFO is fuller than the target and slower while
+    // it is emptier, so the fill level settles where the two clocks are in balance
+    auto error = (double) (ready - targetFill) / targetFill;
+    auto wanted = juce::jlimit(-maxCorrection, maxCorrection, error * correctionGain);
+    correction += correctionSmoothing * (wanted - correction);
+    drift = correction;
+
+    auto speed = sourceRate / deviceRate * (1.0 + correction);
+    auto needed = (int) std::ceil(numSamples * speed) + 1;
+
+    if (needed > ready || needed > readBuffer.getNumSamples()) {
+        ++glitches;
+        primed = false;
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(needed, start1, size1, start2, size2);
+
+    int used = 0;
+    for (int channel = 0; channel < 2; ++channel) {
+        readBuffer.copyFrom(channel, 0, ring, channel, start1, size1);
+        if (size2 > 0)
+            readBuffer.copyFrom(channel, size1, ring, channel, start2, size2);
+
+        // mono devices get the left channel
+        if (channel < numOutputChannels && outputChannelData[channel] != nullptr)
+            used = interpolators[channel].process(speed, readBuffer.getReadPointer(channel),
+                                                  outputChannelData[channel], numSamples);
+    }
+    fifo.finishedRead(used);
+}
+
+void CueOutput::audioDeviceAboutToStart(juce::AudioIODevice* device)
+{
+    deviceRate = device->getCurrentSampleRate();
+    deviceBlockSize = device->getCurrentBufferSizeSamples();
+
+    // room for a block at the fastest speed, in source samples, for any rate the main device may switch to
+    auto maxSpeed = juce::jmax(1.0, juce::jmax(sourceRate.load(), maxSourceRate) / deviceRate) * (1.0 + maxCorrection);
+    readBuffer.setSize(2, (int) std::ceil(deviceBlockSize * maxSpeed) + 16);
+
+    preparedSourceRate = sourceRate;
+    updateTargetFill();
+    primed = false;
+}
+
+void CueOutput::updateTargetFill()
+{
+    // three device blocks of cushion at the current speed, at least 1024 samples
+    auto speed = juce::jmax(1.0, preparedSourceRate / deviceRate) * (1.0 + maxCorrection);
+    targetFill = juce::jlimit(1024, fifoSize / 2, (int) std::ceil(3 * deviceBlockSize * speed));
+}
+
+void CueOutput::audioDeviceStopped()
+{
+    primed = false;
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    CueOutput.h
+    Created: 19 Oct 2026 2:07:44am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Plays the cue bus on a second audio device, e.g. a USB headphone interface
+    next to the main output.
+
+    The two devices run on their own clocks, so the cue bus is handed over
+    through a lock-free FIFO and resampled on the way out. The resampling
+    ratio follows the FIFO fill level, which absorbs both a different nominal
+    sample rate and the slow drift between the two clocks without the FIFO
+    ever running dry or full.
+*/
+class CueOutput  : public juce::AudioIODeviceCallback
+{
+public:
+    CueOutput();
+    ~CueOutput() override;
+
+    /**
+    *   Open an output device and start playing the cue bus on it.
+    *   @param typeName the device type, e.g. "Windows Audio"
+    *   @param deviceName the output device
+    *   @param sourceSampleRate the sample rate of the main device
+    *   @return true if the device could be opened
+    */
+    bool open(const juce::String& typeName, const juce::String& deviceName, double sourceSampleRate);
+
+    /** stop and close the device */
+    void close();
+
+    /** true while a device is open */
+    bool isOpen() const;
+
+    /** call when the main device changes its sample rate */
+    void setSourceSampleRate(double sampleRate);
+
+    /**
+    *   Main audio thread: hand over a block of the cue bus.
+    *   @param buffer the block, one or two channels
+    *   @param startSample the first sample of the block
+    *   @param numSamples the number of samples in the block
+    */
+    void push(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** get how far the clocks are apart, in parts per million */
+    double getDriftPpm() const;
+
+    /** get the number of times the FIFO ran dry or over */
+    int getNumGlitches() const;
+
+    /** implement AudioIODeviceCallback */
+    void audioDeviceIOCallback(const float** inputChannelData, int numInputChannels,
+                               float** outputChannelData, int numOutputChannels, int numSamples) override;
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+private:
+    static constexpr int fifoSize = 1 << 15;
+
+    /** cue device thread: size the cushion for the current source and device rates */
+    void updateTargetFill();
+
+    juce::AudioDeviceManager deviceManager;
+    bool deviceOpen = false;
+
+    // main audio thread to cue device thread
+    juce::AbstractFifo fifo{ fifoSize };
+    juce::AudioBuffer<float> ring{ 2, fifoSize };
+
+    // cue device thread only
+    juce::LagrangeInterpolator interpolators[2];
+    juce::AudioBuffer<float> readBuffer;
+    int targetFill = 2048;
+    int deviceBlockSize = 512;
+    double preparedSourceRate = 44100.0;
+    bool primed = false;
+    double correction = 0.0;
+
+    std::atomic<double> sourceRate{ 44100.0 };
+    std::atomic<double> deviceRate{ 44100.0 };
+    std::atomic<double> drift{ 0.0 };
+    std::atomic<int> glitches{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CueOutput)
+};
@@ -1,93 +1,753 @@
-/*
-  ==============================================================================
-
-    DJAudioPlayer.cpp
-    Created: 28 Jul 2020 4:49:31pm
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#include "DJAudioPlayer.h"
-
-DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager)
-    : formatManager(_formatManager)
-{
-
-}
-DJAudioPlayer::~DJAudioPlayer()
-{
-
-}
-
-void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
-{
-    //formatManager.registerBasicFormats();
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-}
-void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
-{
-    resampleSource.getNextAudioBlock(bufferToFill);
-}
-void DJAudioPlayer::releaseResources() 
-{
-    transportSource.releaseResources();
-    resampleSource.releaseResources();
-}
-
-void DJAudioPlayer::loadURL(juce::URL audioURL)
-{
-    // Make onion layers
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-
-    if (reader != nullptr) { // good file!
-        std::unique_ptr<juce::AudioFormatReaderSource> newSource(new juce::AudioFormatReaderSource(reader, true));
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
-    }
-}
-void DJAudioPlayer::setGain(double gain) 
-{
-    if (gain < 0 || gain > 1.0) 
-        std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1" << std::endl;
-    else 
-        transportSource.setGain(gain);  
-}
-void DJAudioPlayer::setSpeed(double ratio)
-{
-    if (ratio < 0 || ratio > 100.0) 
-        std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and 100" << std::endl;
-    else 
-        resampleSource.setResamplingRatio(ratio);
-}
-
-void DJAudioPlayer::setPosition(double posInSecs)
-{
-    transportSource.setPosition(posInSecs);
-}
-
-void DJAudioPlayer::setPositionRelative(double pos)
-{
-    if (pos < 0 || pos > 1.0)
-        std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
-    else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
-        setPosition(posInSecs);
-    }       
-}
-
-void DJAudioPlayer::start()
-{
-    transportSource.start();
-}
-void DJAudioPlayer::stop()
-{
-    transportSource.stop();
-}
-
-double DJAudioPlayer::getPositionRelative()
-{
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
-    
+/*
+  ==============================================================================
+
+    DJAudioPlayer.cpp
+    Created: 28 Jul 2020 4:49:31pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "DJAudioPlayer.h"
+
+namespace
+{
+    // seconds over which a beat phase error is pulled in
+    const double phaseCorrectionTime = 0.5;
+
+    // the most the phase correction may bend the speed, so it stays inaudible
+    const double maxPhaseCorrection = 0.03;
+
+    // auto gain brings tracks to this loudness, without boosting the true peak past the ceiling
+    const double targetLoudness = -14.0;
+    const double truePeakCeiling = -1.0;
+    const double maxAutoGainDb = 12.0;
+
+    /** 4-point cubic Hermite interpolation between x[1] and x[2] */
+    inline float hermite(const float* x, float t)
+    {
+        auto c1 = 0.5f * (x[2] - x[0]);
+        auto c2 = x[0] - 2.5f * x[1] + 2.0f * x[2] - 0.5f * x[3];
+        auto c3 = 0.5f * (x[3] - x[0]) + 1.5f * (x[1] - x[2]);
+        return ((c3 * t + c2) * t + c1) * t + x[1];
+    }
+}
+
+DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager)
+    : formatManager(_formatManager)
+{
+    for (int i = 0; i < numHotCues; ++i)
+        hotCues.add(-1.0);
+
+    // the widest span of source samples one chunk of scratching can touch, plus the interpolator taps
+    scratchBuffer.setSize(2, (int) (2.0 * maxScratchRate * scratchChunkSize) + 8);
+
+    prefetchThread.startThread(3);
+}
+DJAudioPlayer::~DJAudioPlayer()
+{
+    transportSource.setSource(nullptr);
+    readerSource.reset();
+    prefetchThread.stopThread(1000);
+}
+
+void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    //formatManager.registerBasicFormats();
+    deviceSampleRate = sampleRate;
+    blockSize = samplesPerBlockExpected;
+    autoGain.reset(sampleRate, 0.05);
+    autoGain.setCurrentAndTargetValue(autoGainEnabled ? autoGainTarget.load() : 1.0f);
+    playGain.reset(sampleRate, 0.005);
+    playGain.setCurrentAndTargetValue(playing ? 1.0f : 0.0f);
+    equaliser.prepare(sampleRate);
+    effects.prepare(sampleRate, samplesPerBlockExpected);
+    transportSource.prepareToPlay(samplesPerBlockExpected, sourceSampleRate > 0 ? sourceSampleRate.load() : sampleRate);
+    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // the message thread may be swapping the track, then the queued commands wait
+    const juce::SpinLock::ScopedTryLockType sl(sourceLock);
+    bool sourceReady = sl.isLocked() && readerSource != nullptr;
+
+    // cue and loop requests land exactly on the block boundary
+    if (sl.isLocked())
+        processCommands();
+
+    // publish where this block starts, then pick the speed for it; the transport
+    // is ahead of what is heard by the input the resampler holds
+    auto rate = sourceSampleRate > 0 ? sourceSampleRate.load() : deviceSampleRate;
+    auto position = transportSource.getCurrentPosition();
+    if (!scratchActive)
+        position -= resampleSource.getLatencyInInputSamples() / rate;
+    ++blockSequence;
+    blockClock = samplesRendered;
+    blockStartPosition = position;
+    ++blockSequence;
+
+    auto ratio = syncEnabled ? getSyncRatio(position) : userRatio.load();
+    effectiveRatio = ratio;
+
+    playGain.setTargetValue(playing ? 1.0f : 0.0f);
+
+    bool silent = false;
+    if (sourceReady && (scratching || ratio < 0.0)) {
+        renderScratch(bufferToFill, ratio);
+        playGain.setCurrentAndTargetValue(playing ? 1.0f : 0.0f);
+    }
+    else if ((sl.isLocked() && readerSource == nullptr)
+             || (!playGain.isSmoothing() && playGain.getCurrentValue() == 0.0f)) {
+        // stopped or empty: the transport is not pulled, so it stays where it stopped
+        bufferToFill.clearActiveBufferRegion();
+        silent = true;
+    }
+    else {
+        // back to the transport from where the scratch left the read position
+        if (scratchActive) {
+            resampleSource.flushBuffers();
+            scratchActive = false;
+        }
+        resampleSource.setResamplingRatio(juce::jmax(0.0, ratio) * rate / deviceSampleRate);
+        resampleSource.getNextAudioBlock(bufferToFill);
+
+        // a short fade from the exact sample the deck starts or stops at
+        if (playGain.isSmoothing()) {
+            auto startGain = playGain.getCurrentValue();
+            auto endGain = playGain.skip(bufferToFill.numSamples);
+            bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, startGain, endGain);
+        }
+    }
+    samplesRendered += bufferToFill.numSamples;
+
+    // idle once a silent block has flushed the EQ and no effect is ringing: the gain
+    // stages, EQ and effects are skipped, and the prefetcher can sleep
+    silentBlocks = silent ? juce::jmin(silentBlocks + 1, 2) : 0;
+    auto nowIdle = silentBlocks > 1 && !effects.isRunning();
+    if (nowIdle && !idle)
+        equaliser.reset();
+    idle = nowIdle;
+    if (sourceReady)
+        readerSource->setIdle(nowIdle);
+
+    autoGain.setTargetValue(autoGainEnabled ? autoGainTarget.load() : 1.0f);
+    if (nowIdle) {
+        autoGain.skip(bufferToFill.numSamples);
+        return;
+    }
+
+    // loudness normalisation, ramped so a new track or a toggle does not click
+    if (autoGain.isSmoothing()) {
+        auto startGain = autoGain.getCurrentValue();
+        auto endGain = autoGain.skip(bufferToFill.numSamples);
+        bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, startGain, endGain);
+    }
+    else if (autoGain.getCurrentValue() != 1.0f) {
+        bufferToFill.buffer->applyGain(bufferToFill.startSample, bufferToFill.numSamples, autoGain.getCurrentValue());
+    }
+
+    equaliser.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    // after the EQ, so the tails are not cut by it; a stopped deck still rings out
+    effects.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples,
+                    bpm * std::abs(ratio));
+}
+void DJAudioPlayer::releaseResources() 
+{
+    transportSource.releaseResources();
+    resampleSource.releaseResources();
+}
+
+void DJAudioPlayer::loadURL(juce::URL audioURL)
+{
+    // Make onion layers
+    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+
+    if (reader != nullptr) { // good file!
+        // a second decoder for the prefetch thread, so it never touches the playback one
+        auto* prefetchReader = formatManager.createReaderFor(audioURL.createInputStream(false));
+        std::unique_ptr<PrefetchingReaderSource> newSource(new PrefetchingReaderSource(reader, prefetchReader, prefetchThread));
+
+        // no rate correction in the transport, the resampler does it; the transport
+        // is told the device runs at the track's rate, so its positions are right
+        sourceSampleRate = reader->sampleRate;
+        transportSource.setSource(newSource.get(), 0, nullptr, 0.0);
+        transportSource.prepareToPlay(blockSize, reader->sampleRate);
+        resampleSource.flushBuffers();
+        {
+            const juce::SpinLock::ScopedLockType sl(sourceLock);
+            std::swap(readerSource, newSource);
+        }
+        // the old source is deleted here, now that the audio thread can't reach it
+        newSource.reset();
+
+        loadedURL = audioURL;
+        playing = false;
+        setBeatgrid(0.0, 0.0);
+        setLoudness(0.0, 0.0);
+        setAutoCuePoints(0.0, 0.0);
+        hotCues.fill(-1.0);
+    }
+}
+void DJAudioPlayer::setGain(double gain) 
+{
+    if (gain < 0 || gain > 1.0) 
+        std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1" << std::endl;
+    else 
+        transportSource.setGain(gain);  
+}
+void DJAudioPlayer::setSpeed(double ratio)
+{
+    if (ratio < -100.0 || ratio > 100.0) 
+        std::cout << "DJAudioPlayer::setSpeed ratio should be between -100 and 100" << std::endl;
+    else 
+        userRatio = ratio;
+}
+
+void DJAudioPlayer::setPosition(double posInSecs)
+{
+    transportSource.setPosition(posInSecs);
+    resampleSource.flushBuffers();
+
+    // a stopped deck's prefetcher may be asleep
+    if (readerSource != nullptr)
+        readerSource->wake();
+}
+
+void DJAudioPlayer::setPositionRelative(double pos)
+{
+    if (pos < 0 || pos > 1.0)
+        std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
+    else {
+        double posInSecs = transportSource.getLengthInSeconds() * pos;
+        setPosition(posInSecs);
+    }       
+}
+
+void DJAudioPlayer::jumpTo(double posInSecs)
+{
+    const juce::SpinLock::ScopedTryLockType sl(sourceLock);
+    if (!sl.isLocked() || readerSource == nullptr)
+        return;
+
+    transportSource.setPosition(posInSecs);
+    resampleSource.flushBuffers();
+    scratchActive = false;
+
+    // a stopped deck's prefetcher may be asleep, wake() would take a lock here
+    readerSource->requestWake();
+}
+
+void DJAudioPlayer::start()
+{
+    // the transport is never stopped, which would block until the next block,
+    // so start() and stop() are safe on the audio thread too
+    transportSource.start();
+    playing = true;
+}
+void DJAudioPlayer::stop()
+{
+    playing = false;
+}
+
+double DJAudioPlayer::getPositionRelative()
+{
+    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+    
+}
+
+bool DJAudioPlayer::isIdle() const
+{
+    return idle;
+}
+
+bool DJAudioPlayer::isPlaying() const
+{
+    // the transport stops by itself at the end of the track
+    return playing && transportSource.isPlaying();
+}
+
+juce::URL DJAudioPlayer::getLoadedURL() const
+{
+    return loadedURL;
+}
+
+void DJAudioPlayer::setBeatgrid(double newBpm, double newDownbeatOffset)
+{
+    bpm = newBpm;
+    downbeatOffset = newDownbeatOffset;
+}
+
+void DJAudioPlayer::setLoudness(double loudness, double truePeak)
+{
+    // unknown loudness leaves the track as it is
+    if (loudness >= 0.0) {
+        autoGainTarget = 1.0f;
+        return;
+    }
+
+    auto gainDb = juce::jmin(targetLoudness - loudness, truePeakCeiling - truePeak);
+    gainDb = juce::jlimit(-maxAutoGainDb, maxAutoGainDb, gainDb);
+    autoGainTarget = juce::Decibels::decibelsToGain((float) gainDb);
+}
+
+void DJAudioPlayer::setHotCue(int index)
+{
+    if (index < 0 || index >= numHotCues)
+        std::cout << "DJAudioPlayer::setHotCue index should be between 0 and " << numHotCues - 1 << std::endl;
+    else if (readerSource == nullptr)
+        std::cout << "DJAudioPlayer::setHotCue no track is loaded" << std::endl;
+    else {
+        hotCues.set(index, transportSource.getCurrentPosition());
+        updatePrefetchHints();
+        sendChangeMessage();
+    }
+}
+
+void DJAudioPlayer::clearHotCue(int index)
+{
+    if (index < 0 || index >= numHotCues)
+        std::cout << "DJAudioPlayer::clearHotCue index should be between 0 and " << numHotCues - 1 << std::endl;
+    else {
+        hotCues.set(index, -1.0);
+        updatePrefetchHints();
+        sendChangeMessage();
+    }
+}
+
+bool DJAudioPlayer::hasHotCue(int index) const
+{
+    return index >= 0 && index < numHotCues && hotCues[index] >= 0.0;
+}
+
+void DJAudioPlayer::triggerHotCue(int index)
+{
+    if (!hasHotCue(index))
+        return;
+
+    // the jump is queued first, so the first block that plays starts at the cue
+    postCommand(DeckCommand::jump, hotCues[index]);
+    if (!isPlaying())
+        start();
+}
+
+juce::Array<double> DJAudioPlayer::getHotCues() const
+{
+    return hotCues;
+}
+
+void DJAudioPlayer::setHotCues(const juce::Array<double>& cues)
+{
+    for (int i = 0; i < numHotCues; ++i)
+        hotCues.set(i, i < cues.size() ? cues[i] : -1.0);
+    updatePrefetchHints();
+}
+
+void DJAudioPlayer::setLoopIn()
+{
+    postCommand(DeckCommand::loopIn);
+}
+
+void DJAudioPlayer::setLoopOut()
+{
+    postCommand(DeckCommand::loopOut);
+}
+
+void DJAudioPlayer::setBeatLoop(double beats)
+{
+    if (beats <= 0)
+        std::cout << "DJAudioPlayer::setBeatLoop beats should be more than 0" << std::endl;
+    else
+        postCommand(DeckCommand::beatLoop, beats);
+}
+
+void DJAudioPlayer::exitLoop()
+{
+    postCommand(DeckCommand::exitLoop);
+}
+
+bool DJAudioPlayer::isLoopActive() const
+{
+    return readerSource != nullptr && readerSource->isLoopRegionActive();
+}
+
+void DJAudioPlayer::setScratching(bool shouldScratch)
+{
+    jogDistance = 0.0;
+    scratching = shouldScratch;
+}
+
+void DJAudioPlayer::jog(double seconds)
+{
+    if (!scratching)
+        return;
+
+    // the audio thread takes the whole distance at the start of each block
+    auto distance = jogDistance.load();
+    while (!jogDistance.compare_exchange_weak(distance, distance + seconds)) {}
+}
+
+void DJAudioPlayer::setAutoGainEnabled(bool shouldNormalise)
+{
+    autoGainEnabled = shouldNormalise;
+}
+
+void DJAudioPlayer::setEqualiserGain(int band, double gain)
+{
+    if (band < 0 || band >= DeckEqualiser::numBands)
+        std::cout << "DJAudioPlayer::setEqualiserGain band should be between 0 and 2" << std::endl;
+    else if (gain < 0 || gain > 2.0)
+        std::cout << "DJAudioPlayer::setEqualiserGain gain should be between 0 and 2" << std::endl;
+    else
+        equaliser.setBandGain((DeckEqualiser::Band) band, (float) gain);
+}
+
+void DJAudioPlayer::setFilterPosition(double position)
+{
+    if (position < -1.0 || position > 1.0)
+        std::cout << "DJAudioPlayer::setFilterPosition position should be between -1 and 1" << std::endl;
+    else
+        equaliser.setFilterPosition((float) position);
+}
+
+void DJAudioPlayer::setEffectEnabled(int effect, bool enabled)
+{
+    if (effect < 0 || effect >= DeckEffects::numEffects)
+        std::cout << "DJAudioPlayer::setEffectEnabled effect should be between 0 and 2" << std::endl;
+    else
+        effects.setEnabled((DeckEffects::Effect) effect, enabled);
+}
+
+void DJAudioPlayer::setEffectAmount(int effect, double amount)
+{
+    if (effect < 0 || effect >= DeckEffects::numEffects)
+        std::cout << "DJAudioPlayer::setEffectAmount effect should be between 0 and 2" << std::endl;
+    else if (amount < 0 || amount > 1.0)
+        std::cout << "DJAudioPlayer::setEffectAmount amount should be between 0 and 1" << std::endl;
+    else
+        effects.setAmount((DeckEffects::Effect) effect, (float) amount);
+}
+
+void DJAudioPlayer::setEchoBeats(double beats)
+{
+    if (beats < 0.25 || beats > 4.0)
+        std::cout << "DJAudioPlayer::setEchoBeats beats should be between 0.25 and 4" << std::endl;
+    else
+        effects.setEchoBeats((float) beats);
+}
+
+void DJAudioPlayer::setResamplingQuality(int quality)
+{
+    if (quality < PolyphaseResampler::lowQuality || quality > PolyphaseResampler::highQuality)
+        std::cout << "DJAudioPlayer::setResamplingQuality quality should be between 0 and 2" << std::endl;
+    else
+        resampleSource.setQuality((PolyphaseResampler::Quality) quality);
+}
+
+void DJAudioPlayer::setAutoCuePoints(double newAutoCue, double newAutoEnd)
+{
+    if (newAutoCue < 0 || (newAutoEnd > 0 && newAutoEnd < newAutoCue)) {
+        std::cout << "DJAudioPlayer::setAutoCuePoints autoCue should be between 0 and autoEnd" << std::endl;
+        return;
+    }
+    autoCue = newAutoCue;
+    autoEnd = newAutoEnd;
+}
+
+double DJAudioPlayer::getBpm() const
+{
+    return bpm;
+}
+
+double DJAudioPlayer::getDownbeatOffset() const
+{
+    return downbeatOffset;
+}
+
+juce::int64 DJAudioPlayer::getNextBarTime(juce::int64 notBefore, int beatsPerBar) const
+{
+    auto currentBpm = bpm.load();
+    auto ratio = effectiveRatio.load();
+    if (!isPlaying() || currentBpm <= 0 || ratio <= 0)
+        return -1;
+
+    juce::int64 clock;
+    double position;
+    readBlockStart(clock, position);
+
+    auto barLength = beatsPerBar * 60.0 / currentBpm;
+    auto samplesPerBar = barLength / ratio * deviceSampleRate;
+    auto nextBar = downbeatOffset + std::ceil((position - downbeatOffset) / barLength) * barLength;
+    auto time = clock + (nextBar - position) / ratio * deviceSampleRate;
+
+    if (time < notBefore)
+        time += std::ceil((notBefore - time) / samplesPerBar) * samplesPerBar;
+    return (juce::int64) std::round(time);
+}
+
+juce::int64 DJAudioPlayer::getClockTimeOfPosition(double seconds) const
+{
+    auto ratio = effectiveRatio.load();
+    if (!isPlaying() || ratio <= 0)
+        return -1;
+
+    juce::int64 clock;
+    double position;
+    readBlockStart(clock, position);
+    return clock + (juce::int64) std::round((seconds - position) / ratio * deviceSampleRate);
+}
+
+double DJAudioPlayer::getLengthInSeconds() const
+{
+    return transportSource.getLengthInSeconds();
+}
+
+double DJAudioPlayer::getAutoCue() const
+{
+    return autoCue;
+}
+
+double DJAudioPlayer::getAutoEnd() const
+{
+    auto end = autoEnd.load();
+    return end > 0 ? end : getLengthInSeconds();
+}
+
+double DJAudioPlayer::getSpeed() const
+{
+    return effectiveRatio;
+}
+
+double DJAudioPlayer::getSpeedSetting() const
+{
+    return userRatio;
+}
+
+double DJAudioPlayer::getGain() const
+{
+    return transportSource.getGain();
+}
+
+double DJAudioPlayer::getPosition() const
+{
+    return transportSource.getCurrentPosition();
+}
+
+void DJAudioPlayer::setSyncTarget(DJAudioPlayer* target)
+{
+    syncTarget = target;
+}
+
+DJAudioPlayer* DJAudioPlayer::getSyncTarget() const
+{
+    return syncTarget;
+}
+
+void DJAudioPlayer::setSyncEnabled(bool shouldSync)
+{
+    if (shouldSync) {
+        // two decks following each other would chase forever
+        if (syncTarget != nullptr && syncTarget->isSyncEnabled())
+            syncTarget->setSyncEnabled(false);
+    }
+    else if (syncEnabled) {
+        userRatio = effectiveRatio.load();
+    }
+    syncEnabled = shouldSync;
+}
+
+bool DJAudioPlayer::isSyncEnabled() const
+{
+    return syncEnabled;
+}
+
+double DJAudioPlayer::getSyncRatio(double position) const
+{
+    auto ownBpm = bpm.load();
+    if (syncTarget == nullptr || ownBpm <= 0 || !syncTarget->isPlaying())
+        return userRatio;
+
+    auto targetBpm = syncTarget->bpm.load();
+    if (targetBpm <= 0)
+        return userRatio;
+
+    // match the tempo the target is actually playing at
+    auto targetRatio = syncTarget->effectiveRatio.load();
+    auto ratio = targetBpm * targetRatio / ownBpm;
+
+    // the target may already have rendered this block, so bring its playhead to our block start
+    auto targetPosition = syncTarget->blockStartPosition.load()
+                        + (samplesRendered - syncTarget->blockClock.load()) * targetRatio / deviceSampleRate;
+
+    // beat phase error in beats, wrapped to -0.5..0.5
+    auto targetBeats = (targetPosition - syncTarget->downbeatOffset.load()) * targetBpm / 60.0;
+    auto ownBeats = (position - downbeatOffset.load()) * ownBpm / 60.0;
+    auto error = targetBeats - ownBeats;
+    error -= std::round(error);
+
+    // speed up or slow down just enough to close the gap within phaseCorrectionTime
+    auto correction = error * 60.0 / ownBpm / phaseCorrectionTime;
+    auto limit = maxPhaseCorrection * ratio;
+    return ratio + juce::jlimit(-limit, limit, correction);
+}
+
+void DJAudioPlayer::postCommand(DeckCommand::Type type, double value)
+{
+    int start1, size1, start2, size2;
+    commandFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1) {
+        std::cout << "DJAudioPlayer::postCommand the command queue is full" << std::endl;
+        return;
+    }
+    commandQueue[size1 > 0 ? start1 : start2] = { type, value };
+    commandFifo.finishedWrite(1);
+}
+
+void DJAudioPlayer::processCommands()
+{
+    int start1, size1, start2, size2;
+    commandFifo.prepareToRead(commandFifo.getNumReady(), start1, size1, start2, size2);
+
+    // without a track there is nothing to apply them to
+    if (readerSource != nullptr) {
+        auto sourceRate = readerSource->getAudioFormatReader()->sampleRate;
+
+        for (int i = 0; i < size1 + size2; ++i) {
+            auto& command = commandQueue[i < size1 ? start1 + i : start2 + i - size1];
+            auto position = readerSource->getNextReadPosition();
+
+            switch (command.type) {
+            case DeckCommand::jump:
+                readerSource->clearLoopRegion();
+                transportSource.setPosition(command.value);
+                resampleSource.flushBuffers();
+                scratchActive = false;
+                break;
+
+            case DeckCommand::loopIn:
+                loopInPosition = position;
+                break;
+
+            case DeckCommand::loopOut:
+                if (loopInPosition >= 0 && position > loopInPosition)
+                    readerSource->setLoopRegion(loopInPosition, position);
+                break;
+
+            case DeckCommand::beatLoop: {
+                // without a beatgrid the beats are half a second long, from the playhead
+                auto beatLength = 0.5 * sourceRate;
+                auto loopStart = position;
+                if (bpm > 0) {
+                    beatLength = 60.0 / bpm * sourceRate;
+                    auto grid = downbeatOffset * sourceRate;
+                    loopStart = (juce::int64) (grid + std::floor((position - grid) / beatLength) * beatLength);
+                }
+                loopStart = juce::jmax<juce::int64>(0, loopStart);
+                readerSource->setLoopRegion(loopStart, loopStart + (juce::int64) std::round(command.value * beatLength));
+                break;
+            }
+
+            case DeckCommand::exitLoop:
+                readerSource->clearLoopRegion();
+                break;
+            }
+        }
+    }
+    commandFifo.finishedRead(size1 + size2);
+}
+
+void DJAudioPlayer::renderScratch(const juce::AudioSourceChannelInfo& bufferToFill, double ratio)
+{
+    auto& buffer = *bufferToFill.buffer;
+    auto numSamples = bufferToFill.numSamples;
+    auto sourceRate = readerSource->getAudioFormatReader()->sampleRate;
+    auto sourcePerOutput = sourceRate / deviceSampleRate;
+    auto total = (double) readerSource->getTotalLength();
+
+    // pick up the playhead when the scratch starts, or when something else moved it
+    if (!scratchActive || readerSource->getNextReadPosition() != scratchReadPosition) {
+        // coming from the transport, start where the resampler had got to
+        scratchPosition = (double) readerSource->getNextReadPosition();
+        if (!scratchActive)
+            scratchPosition = juce::jmax(0.0, scratchPosition - resampleSource.getLatencyInInputSamples());
+        scratchTarget = scratchPosition;
+        scratchRate = juce::jlimit(-maxScratchRate, maxScratchRate, (playing ? ratio : 0.0) * sourcePerOutput);
+        scratchActive = true;
+    }
+
+    // held: follow the jog wheel, catching up within this block
+    // reversed: play backwards at the deck's speed
+    double targetRate = 0.0;
+    if (scratching) {
+        scratchTarget = juce::jlimit(0.0, total, scratchTarget + jogDistance.exchange(0.0) * sourceRate);
+        targetRate = (scratchTarget - scratchPosition) / numSamples;
+    }
+    else if (playing) {
+        targetRate = ratio * sourcePerOutput;
+    }
+    targetRate = juce::jlimit(-maxScratchRate, maxScratchRate, targetRate);
+
+    // the rate moves linearly over the block, so a flick of the wheel does not click
+    auto rateStep = (targetRate - scratchRate) / numSamples;
+    auto gain = transportSource.getGain();
+
+    for (int done = 0; done < numSamples; ) {
+        auto num = juce::jmin(scratchChunkSize, numSamples - done);
+
+        // the rate stays between its values at both ends of the chunk, which bounds the span read
+        auto maxRate = juce::jmax(std::abs(scratchRate), std::abs(scratchRate + rateStep * num));
+        auto first = (juce::int64) std::floor(scratchPosition - maxRate * num) - 2;
+        auto span = (int) ((juce::int64) std::floor(scratchPosition + maxRate * num) + 4 - first);
+        span = juce::jmin(span, scratchBuffer.getNumSamples());
+        readerSource->readSamples(scratchBuffer, 0, first, span);
+
+        for (int i = 0; i < num; ++i) {
+            auto index = scratchPosition - (double) first;
+            auto whole = juce::jlimit(1, span - 3, (int) index);
+            auto fraction = (float) (index - whole);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+                auto* source = scratchBuffer.getReadPointer(juce::jmin(channel, 1)) + whole - 1;
+                buffer.setSample(channel, bufferToFill.startSample + done + i, gain * hermite(source, fraction));
+            }
+            scratchPosition += scratchRate;
+            scratchRate += rateStep;
+        }
+        done += num;
+    }
+    scratchRate = targetRate;
+
+    // the prefetcher keeps the windows around the scratch position
+    scratchPosition = juce::jlimit(0.0, total, scratchPosition);
+    scratchReadPosition = (juce::int64) scratchPosition;
+    readerSource->setNextReadPosition(scratchReadPosition);
+    effectiveRatio = scratchRate / sourcePerOutput;
+}
+
+void DJAudioPlayer::readBlockStart(juce::int64& clock, double& position) const
+{
+    // retry while the audio thread is in the middle of publishing
+    for (;;) {
+        auto sequence = blockSequence.load();
+        clock = blockClock;
+        position = blockStartPosition;
+        if ((sequence & 1) == 0 && sequence == blockSequence.load())
+            break;
+    }
+}
+
+void DJAudioPlayer::updatePrefetchHints()
+{
+    if (readerSource == nullptr)
+        return;
+
+    auto sourceRate = readerSource->getAudioFormatReader()->sampleRate;
+    juce::Array<juce::int64> positions;
+    for (auto cue : hotCues)
+        if (cue >= 0.0)
+            positions.add((juce::int64) (cue * sourceRate));
+
+    readerSource->setPrefetchHints(positions);
+    readerSource->wake();
 }
\ No newline at end of file
@@ -1,41 +1,344 @@
-/*
-  ==============================================================================
-
-    DJAudioPlayer.h
-    Created: 28 Jul 2020 4:49:31pm
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#pragma once
-#include <JuceHeader.h>
-
-class DJAudioPlayer : public juce::AudioSource {
-    public:
-
-        DJAudioPlayer(juce::AudioFormatManager& _formatManager);
-        ~DJAudioPlayer();
-
-        void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-        void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
-        void releaseResources() override;
-
-        void loadURL(juce::URL audioURL);
-        void setGain(double gain);
-        void setSpeed(double ratio);
-        void setPosition(double posInSecs);
-        void setPositionRelative(double pos);
-
-        void start();
-        void stop();
-
-        /** get the relative position of the playhead */
-        double getPositionRelative();
-
-    private:
-        juce::AudioFormatManager& formatManager;
-        std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
-        juce::AudioTransportSource transportSource;
-        juce::ResamplingAudioSource resampleSource{&transportSource, false, 2};
+/*
+  ==============================================================================
+
+    DJAudioPlayer.h
+    Created: 28 Jul 2020 4:49:31pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "PrefetchingReaderSource.h"
+#include "DeckEqualiser.h"
+#include "DeckEffects.h"
+#include "PolyphaseResampler.h"
+
+class DJAudioPlayer : public juce::AudioSource,
+                      public juce::ChangeBroadcaster {
+    public:
+
+        static constexpr int numHotCues = 4;
+
+        DJAudioPlayer(juce::AudioFormatManager& _formatManager);
+        ~DJAudioPlayer();
+
+        void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+        void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+        void releaseResources() override;
+
+        void loadURL(juce::URL audioURL);
+        void setGain(double gain);
+        /**
+        *   Set the playback speed.
+        *   @param ratio 1 for normal speed, negative to play in reverse
+        */
+        void setSpeed(double ratio);
+        void setPosition(double posInSecs);
+        void setPositionRelative(double pos);
+
+        /**
+        *   Move the playhead from the audio thread, between the deck's blocks.
+        *   Does nothing while a track is being loaded.
+        *   @param posInSecs the new position in seconds
+        */
+        void jumpTo(double posInSecs);
+
+        /** start or stop playing, also safe to call from the audio thread */
+        void start();
+        void stop();
+
+        /** get the relative position of the playhead */
+        double getPositionRelative();
+
+        /** true if the transport is running */
+        bool isPlaying() const;
+
+        /**
+        *   True if the last block was silence from a stopped or empty deck with no
+        *   effect ringing. The mixer skips an idle deck; audio thread only.
+        */
+        bool isIdle() const;
+
+        /** get the URL of the loaded track */
+        juce::URL getLoadedURL() const;
+
+        /**
+        *   Set the beatgrid of the loaded track, from the library analysis.
+        *   @param bpm the tempo, 0 if unknown
+        *   @param downbeatOffset the position of the first downbeat in seconds
+        */
+        void setBeatgrid(double bpm, double downbeatOffset);
+
+        /**
+        *   Set the measured loudness of the loaded track. The auto gain stage uses it
+        *   to bring every track to the same loudness before the volume slider.
+        *   @param loudness the integrated loudness in LUFS, 0 if unknown
+        *   @param truePeak the true peak in dBTP
+        */
+        void setLoudness(double loudness, double truePeak);
+
+        /**
+        *   Set where the audio of the loaded track starts and ends, from the library analysis.
+        *   @param autoCue the first audible position in seconds
+        *   @param autoEnd the position after the last audible sample in seconds, 0 if unknown
+        */
+        void setAutoCuePoints(double autoCue, double autoEnd);
+
+        /**
+        *   Set a hot cue at the current position. Sends a change message, so the
+        *   cues can be stored with the track.
+        *   @param index the cue slot, 0 to numHotCues - 1
+        */
+        void setHotCue(int index);
+
+        /** clear a hot cue slot, also sends a change message */
+        void clearHotCue(int index);
+
+        /** true if the hot cue slot is set */
+        bool hasHotCue(int index) const;
+
+        /** jump to a hot cue at the start of the next block and play from there */
+        void triggerHotCue(int index);
+
+        /** get the hot cues in seconds, negative for an empty slot */
+        juce::Array<double> getHotCues() const;
+
+        /** restore the hot cues of the loaded track, without sending a change message */
+        void setHotCues(const juce::Array<double>& cues);
+
+        /** mark the current position as the start of a loop */
+        void setLoopIn();
+
+        /** loop from the loop in point to the current position */
+        void setLoopOut();
+
+        /**
+        *   Loop a number of beats from the beat at or before the current position.
+        *   @param beats the length of the loop in beats
+        */
+        void setBeatLoop(double beats);
+
+        /** carry on playing past the end of the loop */
+        void exitLoop();
+
+        /** true if a loop is playing */
+        bool isLoopActive() const;
+
+        /**
+        *   Hold the platter: while scratching, the playhead only moves with jog().
+        *   Letting go carries on from where the scratch left the playhead.
+        *   @param shouldScratch true while the jog wheel is held
+        */
+        void setScratching(bool shouldScratch);
+
+        /**
+        *   Move the playhead while scratching, ignored otherwise. The movement is
+        *   heard within the next block.
+        *   @param seconds how far to move, negative to go backwards
+        */
+        void jog(double seconds);
+
+        /** turn the loudness normalisation on or off, it is on by default */
+        void setAutoGainEnabled(bool shouldNormalise);
+
+        /**
+        *   Set the gain of one EQ band.
+        *   @param band 0 for low, 1 for mid, 2 for high
+        *   @param gain 0 kills the band, 1 is flat, 2 is +6 dB
+        */
+        void setEqualiserGain(int band, double gain);
+
+        /**
+        *   Set the sweep filter.
+        *   @param position -1 to 0 for a low-pass, 0 for off, 0 to 1 for a high-pass
+        */
+        void setFilterPosition(double position);
+
+        /**
+        *   Switch an effect on, or off to let its tail ring out.
+        *   @param effect 0 for echo, 1 for reverb, 2 for flanger
+        *   @param enabled true to send the deck into the effect
+        */
+        void setEffectEnabled(int effect, bool enabled);
+
+        /**
+        *   Set the wet/dry amount of an effect.
+        *   @param effect 0 for echo, 1 for reverb, 2 for flanger
+        *   @param amount 0 for dry, 0.5 for both at full level, 1 for wet only
+        */
+        void setEffectAmount(int effect, double amount);
+
+        /**
+        *   Set the echo time, which follows the tempo of the deck.
+        *   @param beats the time between repeats, from 0.25 to 4 beats
+        */
+        void setEchoBeats(double beats);
+
+        /**
+        *   Choose the resampler's filter length, for speed changes and sample-rate conversion.
+        *   @param quality 0 for low, 1 for medium (the default), 2 for high
+        */
+        void setResamplingQuality(int quality);
+
+        /** get the tempo of the loaded track at normal speed, 0 if unknown */
+        double getBpm() const;
+
+        /** get the position of the first downbeat in seconds */
+        double getDownbeatOffset() const;
+
+        /**
+        *   Find when the next bar starts on the sample clock, which DeckMixer keeps
+        *   equal to the master clock.
+        *   @param notBefore the earliest clock time to return
+        *   @param beatsPerBar the length of a bar
+        *   @return the clock time of the next bar, -1 if the deck is stopped or has no beatgrid
+        */
+        juce::int64 getNextBarTime(juce::int64 notBefore, int beatsPerBar = 4) const;
+
+        /**
+        *   Find when the playhead reaches a position on the sample clock, at the current speed.
+        *   @param seconds the position in the track
+        *   @return the clock time, -1 if the deck is stopped or not playing forwards
+        */
+        juce::int64 getClockTimeOfPosition(double seconds) const;
+
+        /** get the length of the loaded track in seconds, 0 if none */
+        double getLengthInSeconds() const;
+
+        /** get where the audio of the loaded track starts, in seconds */
+        double getAutoCue() const;
+
+        /** get where the audio of the loaded track ends, in seconds; the length if unknown */
+        double getAutoEnd() const;
+
+        /** get the speed ratio the deck is actually playing at, including sync */
+        double getSpeed() const;
+
+        /** get the ratio set with setSpeed(), negative in reverse; sync does not change it */
+        double getSpeedSetting() const;
+
+        /** get the gain set with setGain() */
+        double getGain() const;
+
+        /** get the position of the playhead in seconds */
+        double getPosition() const;
+
+        /** set the deck this one follows when sync is enabled */
+        void setSyncTarget(DJAudioPlayer* target);
+
+        /** get the deck this one follows when sync is enabled */
+        DJAudioPlayer* getSyncTarget() const;
+
+        /**
+        *   Match the tempo of the sync target and keep the beats phase-locked to it.
+        *   Turning sync off keeps the current tempo.
+        *   @param shouldSync true to follow the sync target
+        */
+        void setSyncEnabled(bool shouldSync);
+
+        /** true if the deck follows its sync target */
+        bool isSyncEnabled() const;
+
+    private:
+        // a request from the GUI, applied by the audio thread at the start of the next block
+        struct DeckCommand
+        {
+            enum Type { jump, loopIn, loopOut, beatLoop, exitLoop };
+
+            Type type = jump;
+            double value = 0.0;
+        };
+
+        /** queue a command for the audio thread */
+        void postCommand(DeckCommand::Type type, double value = 0.0);
+
+        /** apply the queued commands, on the audio thread with sourceLock held */
+        void processCommands();
+
+        /**
+        *   Render straight from the prefetched windows, at any signed rate, for
+        *   scratching and reverse play. Called with sourceLock held.
+        *   @param bufferToFill the block to render
+        *   @param ratio the speed ratio set for the deck
+        */
+        void renderScratch(const juce::AudioSourceChannelInfo& bufferToFill, double ratio);
+
+        /** read the clock and the position published for the same block */
+        void readBlockStart(juce::int64& clock, double& position) const;
+
+        /** give the hot cues to the prefetcher so jumping to them never waits on the decoder */
+        void updatePrefetchHints();
+
+        juce::AudioFormatManager& formatManager;
+
+        // decodes the windows around likely seek targets in the background
+        juce::TimeSliceThread prefetchThread{ "Deck prefetch" };
+        std::unique_ptr<PrefetchingReaderSource> readerSource;
+        juce::SpinLock sourceLock;  // held while readerSource is replaced
+        // the transport runs at the track's own rate, the resampler converts
+        // speed and sample rate together in one pass
+        juce::AudioTransportSource transportSource;
+        PolyphaseResampler resampleSource{&transportSource, 2};
+        std::atomic<double> sourceSampleRate{ 0.0 };
+        int blockSize = 512;
+
+        /** the ratio matching the sync target's tempo, plus the phase correction */
+        double getSyncRatio(double position) const;
+
+        juce::URL loadedURL;
+
+        // single producer (message thread), single consumer (audio thread)
+        static constexpr int commandQueueSize = 64;
+        juce::AbstractFifo commandFifo{ commandQueueSize };
+        DeckCommand commandQueue[commandQueueSize];
+
+        juce::Array<double> hotCues;
+        juce::int64 loopInPosition = -1;  // audio thread only
+
+        // scratching and reverse play, the scratch state is only used by the audio thread
+        static constexpr int scratchChunkSize = 512;
+        static constexpr double maxScratchRate = 8.0;
+        std::atomic<bool> scratching{ false };
+        std::atomic<double> jogDistance{ 0.0 };
+        juce::AudioBuffer<float> scratchBuffer;
+        bool scratchActive = false;
+        double scratchPosition = 0.0;  // in source samples
+        double scratchTarget = 0.0;
+        double scratchRate = 0.0;  // source samples per output sample
+        juce::int64 scratchReadPosition = 0;
+
+        // loudness normalisation, the target is set from the message thread
+        std::atomic<float> autoGainTarget{ 1.0f };
+        std::atomic<bool> autoGainEnabled{ true };
+        juce::SmoothedValue<float> autoGain{ 1.0f };
+
+        // the deck's own play state, the transport keeps running underneath
+        std::atomic<bool> playing{ false };
+        juce::SmoothedValue<float> playGain{ 0.0f };
+
+        // silent blocks in a row, up to 2, and whether the deck is skipped; audio thread only
+        int silentBlocks = 0;
+        bool idle = false;
+
+        DeckEqualiser equaliser;
+        DeckEffects effects;
+
+        std::atomic<double> userRatio{ 1.0 };
+        std::atomic<double> effectiveRatio{ 1.0 };
+        std::atomic<double> bpm{ 0.0 };
+        std::atomic<double> downbeatOffset{ 0.0 };
+        std::atomic<double> autoCue{ 0.0 };
+        std::atomic<double> autoEnd{ 0.0 };
+        std::atomic<bool> syncEnabled{ false };
+        DJAudioPlayer* syncTarget = nullptr;
+
+        // published at the start of every block for the deck synced to this one,
+        // the sequence is odd while they are being written
+        std::atomic<juce::uint32> blockSequence{ 0 };
+        std::atomic<juce::int64> blockClock{ 0 };
+        std::atomic<double> blockStartPosition{ 0.0 };
+        juce::int64 samplesRendered = 0;
+        double deviceSampleRate = 44100.0;
 };
\ No newline at end of file
@@ -0,0 +1,372 @@
+/*
+  ==============================================================================
+
+    DeckEffects.cpp
+    Created: 19 Oct 2026 6:25:09pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "DeckEffects.h"
+#include <cmath>
+
+namespace
+{
+    // the ramp of sends and wet/dry changes
+    const double smoothingSeconds = 0.02;
+
+    // the lines count as empty below this, -100 dBFS
+    const float silenceThreshold = 1.0e-5f;
+
+    // the tempo effects are synced to when the track has no beatgrid
+    const double defaultTempo = 120.0;
+
+    // echo: the longest time between repeats, and how much of each repeat comes back
+    const double maxEchoSeconds = 4.0;
+    const float echoFeedback = 0.55f;
+
+    // reverb: line lengths at 44.1 kHz, mutually prime; decay time and damping
+    const int reverbLengths[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+    const double reverbDecaySeconds = 2.4;
+    const float reverbDampingAmount = 0.35f;
+
+    // flanger: the sweep of the delay, its period and feedback
+    const double flangerMinSeconds = 0.0005, flangerMaxSeconds = 0.005;
+    const double flangerBeats = 8.0;
+    const float flangerFeedback = 0.6f;
+}
+
+DeckEffects::DeckEffects()
+{
+    for (int effect = 0; effect < numEffects; ++effect) {
+        enabled[effect] = false;
+        amounts[effect] = 0.5f;
+    }
+}
+
+DeckEffects::~DeckEffects()
+{
+}
+
+void DeckEffects::prepare(double _sampleRate, int maximumBlockSize)
+{
+    sampleRate = _sampleRate;
+    blockSize = juce::jmax(1, maximumBlockSize);
+
+    for (auto& unit : units) {
+        unit.send.reset(sampleRate, smoothingSeconds);
+        unit.dry.reset(sampleRate, smoothingSeconds);
+        unit.wet.reset(sampleRate, smoothingSeconds);
+        unit.send.setCurrentAndTargetValue(0.0f);
+        unit.dry.setCurrentAndTargetValue(1.0f);
+        unit.wet.setCurrentAndTargetValue(0.0f);
+        unit.running = false;
+        unit.quietSamples = 0;
+    }
+
+    wetBuffer.setSize(2, blockSize);
+    sendRamp.allocate((size_t) blockSize, true);
+
+    // power-of-two lines, so positions wrap with a mask
+    echoLines.setSize(2, juce::nextPowerOfTwo((int) (maxEchoSeconds * sampleRate) + 1));
+    echoLines.clear();
+    echoPosition = 0;
+
+    auto scale = sampleRate / 44100.0;
+    int longest = 0;
+    for (int line = 0; line < numReverbLines; ++line) {
+        reverbDelays[line] = juce::jmax(1, (int) std::round(reverbLengths[line] * scale));
+        reverbGains[line] = (float) std::pow(10.0, -3.0 * reverbDelays[line] / (reverbDecaySeconds * sampleRate));
+        reverbDamping[line] = 0.0f;
+        longest = juce::jmax(longest, reverbDelays[line]);
+    }
+    reverbLines.setSize(numReverbLines, juce::nextPowerOfTwo(longest + 1));
+    reverbLines.clear();
+    reverbPosition = 0;
+    units[reverb].tailLength = longest;
+
+    // one register per frame, aligned for fromRawArray()
+    flangerFrames = juce::nextPowerOfTwo((int) (flangerMaxSeconds * sampleRate) + 2);
+    flangerMemory.allocate((size_t) (flangerFrames + 1) * Vec::SIMDNumElements, true);
+    flangerLine = Vec::getNextSIMDAlignedPtr(flangerMemory.get());
+    flangerPosition = 0;
+    flangerPhase = 0.0;
+    units[flanger].tailLength = (int) (flangerMaxSeconds * sampleRate) + 2;
+}
+
+void DeckEffects::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, double beatsPerMinute)
+{
+    auto numChannels = juce::jmin(2, buffer.getNumChannels());
+    if (numChannels == 0 || numSamples <= 0 || blockSize == 0)
+        return;
+
+    // the bypass: nothing runs until an effect is switched on, or while its tail rings
+    bool anyRunning = false;
+    for (int effect = 0; effect < numEffects; ++effect) {
+        if (enabled[effect])
+            units[effect].running = true;
+        anyRunning = anyRunning || units[effect].running;
+    }
+    if (!anyRunning)
+        return;
+
+    juce::ScopedNoDenormals noDenormals;
+    tempo = beatsPerMinute > 0.0 ? beatsPerMinute : defaultTempo;
+
+    for (int offset = 0; offset < numSamples; offset += blockSize) {
+        auto num = juce::jmin(blockSize, numSamples - offset);
+        for (int effect = 0; effect < numEffects; ++effect) {
+            if (units[effect].running)
+                processUnit((Effect) effect, buffer, startSample + offset, num, numChannels);
+        }
+    }
+}
+
+bool DeckEffects::isRunning() const
+{
+    for (int effect = 0; effect < numEffects; ++effect)
+        if (enabled[effect] || units[effect].running)
+            return true;
+    return false;
+}
+
+void DeckEffects::setEnabled(Effect effect, bool shouldBeEnabled)
+{
+    enabled[effect] = shouldBeEnabled;
+}
+
+bool DeckEffects::isEnabled(Effect effect) const
+{
+    return enabled[effect];
+}
+
+void DeckEffects::setAmount(Effect effect, float amount)
+{
+    amounts[effect] = juce::jlimit(0.0f, 1.0f, amount);
+}
+
+void DeckEffects::setEchoBeats(float beats)
+{
+    echoBeats = juce::jlimit(0.25f, 4.0f, beats);
+}
+
+void DeckEffects::processUnit(Effect effect, juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels)
+{
+    auto& unit = units[effect];
+    auto on = enabled[effect].load();
+    auto amount = amounts[effect].load();
+
+    // both at full level in the middle of the knob; off is dry, with the tail on top
+    unit.send.setTargetValue(on ? 1.0f : 0.0f);
+    unit.dry.setTargetValue(on ? juce::jmin(1.0f, 2.0f * (1.0f - amount)) : 1.0f);
+    unit.wet.setTargetValue(juce::jmin(1.0f, 2.0f * amount));
+
+    auto sendStart = unit.send.getCurrentValue();
+    auto sendEnd = unit.send.skip(numSamples);
+    auto sendStep = (sendEnd - sendStart) / (float) numSamples;
+    for (int i = 0; i < numSamples; ++i)
+        sendRamp[i] = sendStart + sendStep * (float) (i + 1);
+
+    const float* input[2];
+    for (int channel = 0; channel < numChannels; ++channel)
+        input[channel] = buffer.getReadPointer(channel, startSample);
+
+    float peak = 0.0f;
+    switch (effect) {
+    case echo:
+        peak = renderEcho(input, numChannels, numSamples);
+        break;
+
+    case reverb:
+        peak = renderReverb(input, numChannels, numSamples);
+        break;
+
+    case flanger:
+        peak = renderFlanger(input, numChannels, numSamples);
+        break;
+
+    default:
+        return;
+    }
+
+    auto dryStart = unit.dry.getCurrentValue();
+    auto dryEnd = unit.dry.skip(numSamples);
+    auto wetStart = unit.wet.getCurrentValue();
+    auto wetEnd = unit.wet.skip(numSamples);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        if (dryStart != 1.0f || dryEnd != 1.0f)
+            buffer.applyGainRamp(channel, startSample, numSamples, dryStart, dryEnd);
+        buffer.addFromWithRamp(channel, startSample, wetBuffer.getReadPointer(channel), numSamples, wetStart, wetEnd);
+    }
+
+    // switched off: stop once every sample in the lines has been read back inaudible
+    if (!on && sendEnd == 0.0f && peak < silenceThreshold) {
+        unit.quietSamples += numSamples;
+        if (unit.quietSamples >= unit.tailLength && !unit.dry.isSmoothing()) {
+            unit.running = false;
+            unit.quietSamples = 0;
+        }
+    }
+    else {
+        unit.quietSamples = 0;
+    }
+}
+
+float DeckEffects::renderEcho(const float* const* input, int numChannels, int numSamples)
+{
+    const int mask = echoLines.getNumSamples() - 1;
+
+    // the time between repeats follows the tempo
+    auto delay = (int) std::round(echoBeats.load() * 60.0 / tempo * sampleRate);
+    delay = juce::jlimit(1, mask, delay);
+    units[echo].tailLength = delay;
+
+    float peak = 0.0f;
+    int done = 0;
+    while (done < numSamples) {
+        // a run that neither wraps nor reads what it writes
+        auto write = echoPosition & mask;
+        auto read = (echoPosition - delay) & mask;
+        auto num = juce::jmin(numSamples - done, delay, mask + 1 - write, mask + 1 - read);
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto* line = echoLines.getWritePointer(channel);
+            auto* wet = wetBuffer.getWritePointer(channel, done);
+
+            // the repeat, then what goes back into the line: the repeat fed back plus the send
+            juce::FloatVectorOperations::copy(wet, line + read, num);
+            juce::FloatVectorOperations::copyWithMultiply(line + write, wet, echoFeedback, num);
+            juce::FloatVectorOperations::addWithMultiply(line + write, input[channel] + done, sendRamp + done, num);
+
+            auto range = juce::FloatVectorOperations::findMinAndMax(wet, num);
+            peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+        }
+        echoPosition = (echoPosition + num) & mask;
+        done += num;
+    }
+    return peak;
+}
+
+float DeckEffects::renderReverb(const float* const* input, int numChannels, int numSamples)
+{
+    const int lanes = (int) Vec::SIMDNumElements;
+    const int mask = reverbLines.getNumSamples() - 1;
+
+    float* lines[numReverbLines];
+    for (int line = 0; line < numReverbLines; ++line)
+        lines[line] = reverbLines.getWritePointer(line);
+
+    // one line per lane; the input goes in and the output comes out with alternating signs
+    Vec gains[numReverbVecs], damping[numReverbVecs], inSigns[numReverbVecs], leftOut[numReverbVecs], rightOut[numReverbVecs];
+    for (int v = 0; v < numReverbVecs; ++v) {
+        for (int lane = 0; lane < lanes; ++lane) {
+            auto line = v * lanes + lane;
+            gains[v].set((size_t) lane, reverbGains[line]);
+            damping[v].set((size_t) lane, reverbDamping[line]);
+            inSigns[v].set((size_t) lane, line % 2 == 0 ? 1.0f : -1.0f);
+            leftOut[v].set((size_t) lane, line % 2 == 0 ? (line % 4 == 0 ? 0.5f : -0.5f) : 0.0f);
+            rightOut[v].set((size_t) lane, line % 2 == 1 ? (line % 4 == 1 ? 0.5f : -0.5f) : 0.0f);
+        }
+    }
+    auto dampingAmount = Vec::expand(reverbDampingAmount);
+    auto householder = 2.0f / (float) numReverbLines;
+    auto peak = Vec::expand(0.0f);
+
+    auto* wetLeft = wetBuffer.getWritePointer(0);
+    auto* wetRight = wetBuffer.getWritePointer(1);
+    auto position = reverbPosition;
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto x = 0.5f * (input[0][i] + input[numChannels - 1][i]) * sendRamp[i];
+
+        // read and damp every line
+        Vec delayed[numReverbVecs];
+        float total = 0.0f;
+        for (int v = 0; v < numReverbVecs; ++v) {
+            for (int lane = 0; lane < lanes; ++lane) {
+                auto line = v * lanes + lane;
+                delayed[v].set((size_t) lane, lines[line][(position - reverbDelays[line]) & mask]);
+            }
+            damping[v] += dampingAmount * (delayed[v] - damping[v]);
+            total += damping[v].sum();
+            peak = Vec::max(peak, Vec::abs(delayed[v]));
+        }
+
+        // a Householder reflection mixes every line into every other in O(n)
+        auto reflection = Vec::expand(total * householder);
+        auto in = Vec::expand(x);
+        float left = 0.0f, right = 0.0f;
+        for (int v = 0; v < numReverbVecs; ++v) {
+            auto back = gains[v] * (damping[v] - reflection) + inSigns[v] * in;
+            for (int lane = 0; lane < lanes; ++lane)
+                lines[v * lanes + lane][position & mask] = back.get((size_t) lane);
+
+            left += (damping[v] * leftOut[v]).sum();
+            right += (damping[v] * rightOut[v]).sum();
+        }
+        wetLeft[i] = numChannels > 1 ? left : 0.5f * (left + right);
+        wetRight[i] = right;
+        position = (position + 1) & mask;
+    }
+    reverbPosition = position;
+
+    for (int v = 0; v < numReverbVecs; ++v) {
+        for (int lane = 0; lane < lanes; ++lane)
+            reverbDamping[v * lanes + lane] = damping[v].get((size_t) lane);
+    }
+
+    float result = 0.0f;
+    for (int lane = 0; lane < lanes; ++lane)
+        result = juce::jmax(result, peak.get((size_t) lane));
+    return result;
+}
+
+float DeckEffects::renderFlanger(const float* const* input, int numChannels, int numSamples)
+{
+    const int lanes = (int) Vec::SIMDNumElements;
+    const int mask = flangerFrames - 1;
+
+    // a triangle sweep over a number of beats, the same for every channel
+    auto phaseStep = tempo / (60.0 * flangerBeats * sampleRate);
+    auto minDelay = flangerMinSeconds * sampleRate;
+    auto sweep = (flangerMaxSeconds - flangerMinSeconds) * sampleRate;
+
+    auto feedback = Vec::expand(flangerFeedback);
+    auto x = Vec::expand(0.0f);
+    auto peak = Vec::expand(0.0f);
+    auto position = flangerPosition;
+
+    float* wet[2] = { wetBuffer.getWritePointer(0), wetBuffer.getWritePointer(1) };
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto triangle = 1.0 - std::abs(2.0 * flangerPhase - 1.0);
+        flangerPhase += phaseStep;
+        if (flangerPhase >= 1.0)
+            flangerPhase -= 1.0;
+
+        auto delay = minDelay + sweep * triangle;
+        auto whole = (int) delay;
+        auto fraction = Vec::expand((float) (delay - whole));
+
+        // linear interpolation between the two frames either side of the delay
+        auto newer = Vec::fromRawArray(flangerLine + ((position - whole) & mask) * lanes);
+        auto older = Vec::fromRawArray(flangerLine + ((position - whole - 1) & mask) * lanes);
+        auto y = newer + fraction * (older - newer);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            x.set((size_t) channel, input[channel][i] * sendRamp[i]);
+        (x + feedback * y).copyToRawArray(flangerLine + (position & mask) * lanes);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            wet[channel][i] = y.get((size_t) channel);
+        peak = Vec::max(peak, Vec::abs(y));
+        position = (position + 1) & mask;
+    }
+    flangerPosition = position;
+
+    float result = 0.0f;
+    for (int channel = 0; channel < numChannels; ++channel)
+        result = juce::jmax(result, peak.get((size_t) channel));
+    return result;
+}
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    DeckEffects.h
+    Created: 19 Oct 2026 6:25:09pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    The effects unit of one deck: a tempo-synced echo, a reverb and a
+    tempo-synced flanger, in that order, each with its own wet/dry amount.
+
+    Switching an effect on opens its send; switching it off closes the send
+    and lets the tail ring out. Once everything in its delay lines has died
+    away the effect is skipped, so a deck with no effect ringing costs
+    nothing. Sends and wet/dry gains are ramped across each block.
+
+    The echo runs on FloatVectorOperations over whole runs of the block, the
+    reverb is a feedback delay network with one line per SIMD lane, and the
+    flanger keeps one channel per lane like DeckEqualiser. All delay lines
+    are allocated in prepare().
+*/
+class DeckEffects
+{
+public:
+    enum Effect
+    {
+        echo = 0,
+        reverb,
+        flanger,
+        numEffects
+    };
+
+    DeckEffects();
+    ~DeckEffects();
+
+    /**
+    *   Allocate the delay lines for the sample rate and clear them.
+    *   @param sampleRate the sample rate of the device
+    *   @param maximumBlockSize the largest block process() is given in one go
+    */
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    /**
+    *   Run the effects over a block in place. Only the first two channels are processed.
+    *   @param buffer the buffer to be processed
+    *   @param startSample the first sample of the block
+    *   @param numSamples the number of samples in the block
+    *   @param beatsPerMinute the tempo the deck is playing at, 0 if unknown
+    */
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, double beatsPerMinute);
+
+    /** true if an effect is on or its tail is still ringing; audio thread only */
+    bool isRunning() const;
+
+    /**
+    *   Switch an effect on or off, may be called from any thread.
+    *   @param effect the effect
+    *   @param enabled false closes the send and lets the tail ring out
+    */
+    void setEnabled(Effect effect, bool enabled);
+
+    /** true if the effect is switched on */
+    bool isEnabled(Effect effect) const;
+
+    /**
+    *   Set the wet/dry amount of an effect, may be called from any thread.
+    *   @param effect the effect
+    *   @param amount 0 for dry, 0.5 for both at full level, 1 for wet only
+    */
+    void setAmount(Effect effect, float amount);
+
+    /**
+    *   Set the echo time.
+    *   @param beats the time between repeats in beats, from 0.25 to 4
+    */
+    void setEchoBeats(float beats);
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    // the sends and gains every effect has, audio thread only
+    struct Unit
+    {
+        juce::SmoothedValue<float> send{ 0.0f };
+        juce::SmoothedValue<float> dry{ 1.0f };
+        juce::SmoothedValue<float> wet{ 0.0f };
+
+        bool running = false;   // false once the tail has died away
+        int quietSamples = 0;   // since the lines were last audible
+        int tailLength = 1;     // how long the lines must stay quiet to be empty
+    };
+
+    /** run one effect over part of a block, at most the prepared block size */
+    void processUnit(Effect effect, juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels);
+
+    /**
+    *   Render an effect's wet signal into wetBuffer, from the input times the send ramp.
+    *   @return the peak of what was read from the delay lines
+    */
+    float renderEcho(const float* const* input, int numChannels, int numSamples);
+    float renderReverb(const float* const* input, int numChannels, int numSamples);
+    float renderFlanger(const float* const* input, int numChannels, int numSamples);
+
+    static constexpr int numReverbLines = 8;
+    static constexpr int numReverbVecs = numReverbLines / (int) Vec::SIMDNumElements;
+    static_assert(numReverbVecs * (int) Vec::SIMDNumElements == numReverbLines, "reverb lines must fill the SIMD registers");
+
+    double sampleRate = 44100.0;
+    int blockSize = 0;
+    double tempo = 120.0;
+
+    Unit units[numEffects];
+    std::atomic<bool> enabled[numEffects];
+    std::atomic<float> amounts[numEffects];
+    std::atomic<float> echoBeats{ 0.75f };
+
+    juce::AudioBuffer<float> wetBuffer;
+    juce::HeapBlock<float> sendRamp;
+
+    // echo: one line per channel, written and read in runs
+    juce::AudioBuffer<float> echoLines;
+    int echoPosition = 0;
+
+    // reverb: the lines of the network, their lengths and feedback gains
+    juce::AudioBuffer<float> reverbLines;
+    int reverbPosition = 0;
+    int reverbDelays[numReverbLines] = {};
+    float reverbGains[numReverbLines] = {};
+    float reverbDamping[numReverbLines] = {};
+
+    // flanger: interleaved frames of one SIMD register each
+    juce::HeapBlock<float> flangerMemory;
+    float* flangerLine = nullptr;
+    int flangerFrames = 0;
+    int flangerPosition = 0;
+    double flangerPhase = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckEffects)
+};
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    DeckEqualiser.cpp
+    Created: 18 Oct 2026 8:03:26pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "DeckEqualiser.h"
+#include <cmath>
+
+namespace
+{
+    // crossover frequencies between the low/mid and the mid/high bands
+    const double lowCrossover = 250.0;
+    const double highCrossover = 2500.0;
+
+    // the Butterworth Q, two in a row make a Linkwitz-Riley crossover
+    const double butterworthQ = 0.7071067811865476;
+
+    // sweep ranges of the filter knob
+    const double lowPassTop = 20000.0, lowPassBottom = 60.0;
+    const double highPassBottom = 20.0, highPassTop = 8000.0;
+    const float filterDeadZone = 0.02f;
+}
+
+DeckEqualiser::DeckEqualiser()
+{
+    for (auto& gain : targetGains)
+        gain = 1.0f;
+}
+
+DeckEqualiser::~DeckEqualiser()
+{
+}
+
+void DeckEqualiser::prepare(double _sampleRate)
+{
+    sampleRate = _sampleRate;
+
+    coefficients[lowPassA] = coefficients[lowPassB] = makeLowPass(sampleRate, lowCrossover, butterworthQ);
+    coefficients[highPassA] = coefficients[highPassB] = makeHighPass(sampleRate, lowCrossover, butterworthQ);
+    coefficients[midPassA] = coefficients[midPassB] = makeLowPass(sampleRate, highCrossover, butterworthQ);
+    coefficients[topPassA] = coefficients[topPassB] = makeHighPass(sampleRate, highCrossover, butterworthQ);
+    coefficients[lowAllPass] = makeAllPass(sampleRate, highCrossover, butterworthQ);
+    reset();
+}
+
+void DeckEqualiser::reset()
+{
+    coefficients[sweep] = makeSweepCoefficients(filterPosition, filterResonance);
+
+    for (int stage = 0; stage < numStages; ++stage) {
+        for (int lane = 0; lane < maxLanes; ++lane)
+            state1[stage][lane] = state2[stage][lane] = 0.0f;
+    }
+    for (int band = 0; band < numBands; ++band)
+        gains[band] = targetGains[band];
+}
+
+void DeckEqualiser::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    auto numLanes = (int) juce::jmin((size_t) buffer.getNumChannels(), Vec::size(), (size_t) maxLanes);
+    if (numLanes == 0 || numSamples <= 0)
+        return;
+
+    // fixed stages
+    Vec b0[numStages], b1[numStages], b2[numStages], a1[numStages], a2[numStages];
+    Vec z1[numStages], z2[numStages];
+    for (int stage = 0; stage < numStages; ++stage) {
+        b0[stage] = Vec::expand(coefficients[stage].b0);
+        b1[stage] = Vec::expand(coefficients[stage].b1);
+        b2[stage] = Vec::expand(coefficients[stage].b2);
+        a1[stage] = Vec::expand(coefficients[stage].a1);
+        a2[stage] = Vec::expand(coefficients[stage].a2);
+
+        z1[stage] = Vec::expand(0.0f);
+        z2[stage] = Vec::expand(0.0f);
+        for (int lane = 0; lane < numLanes; ++lane) {
+            z1[stage].set((size_t) lane, state1[stage][lane]);
+            z2[stage].set((size_t) lane, state2[stage][lane]);
+        }
+    }
+
+    // the sweep filter and the band gains move linearly to their targets over the block
+    auto step = 1.0f / (float) numSamples;
+    auto target = makeSweepCoefficients(filterPosition, filterResonance);
+    auto& current = coefficients[sweep];
+    Vec db0 = Vec::expand((target.b0 - current.b0) * step), db1 = Vec::expand((target.b1 - current.b1) * step),
+        db2 = Vec::expand((target.b2 - current.b2) * step), da1 = Vec::expand((target.a1 - current.a1) * step),
+        da2 = Vec::expand((target.a2 - current.a2) * step);
+
+    Vec gain[numBands], gainStep[numBands];
+    float newGains[numBands];
+    for (int band = 0; band < numBands; ++band) {
+        newGains[band] = targetGains[band];
+        gain[band] = Vec::expand(gains[band]);
+        gainStep[band] = Vec::expand((newGains[band] - gains[band]) * step);
+    }
+
+    auto biquad = [&](int stage, Vec input) {
+        auto output = b0[stage] * input + z1[stage];
+        z1[stage] = b1[stage] * input - a1[stage] * output + z2[stage];
+        z2[stage] = b2[stage] * input - a2[stage] * output;
+        return output;
+    };
+
+    float* channels[maxLanes];
+    for (int lane = 0; lane < numLanes; ++lane)
+        channels[lane] = buffer.getWritePointer(lane, startSample);
+
+    auto x = Vec::expand(0.0f);
+    for (int i = 0; i < numSamples; ++i) {
+        for (int lane = 0; lane < numLanes; ++lane)
+            x.set((size_t) lane, channels[lane][i]);
+
+        auto low = biquad(lowAllPass, biquad(lowPassB, biquad(lowPassA, x)));
+        auto rest = biquad(highPassB, biquad(highPassA, x));
+        auto mid = biquad(midPassB, biquad(midPassA, rest));
+        auto high = biquad(topPassB, biquad(topPassA, rest));
+
+        auto y = gain[lowBand] * low + gain[midBand] * mid + gain[highBand] * high;
+        y = biquad(sweep, y);
+
+        for (int band = 0; band < numBands; ++band)
+            gain[band] += gainStep[band];
+        b0[sweep] += db0;
+        b1[sweep] += db1;
+        b2[sweep] += db2;
+        a1[sweep] += da1;
+        a2[sweep] += da2;
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            channels[lane][i] = y.get((size_t) lane);
+    }
+
+    for (int stage = 0; stage < numStages; ++stage) {
+        for (int lane = 0; lane < numLanes; ++lane) {
+            state1[stage][lane] = z1[stage].get((size_t) lane);
+            state2[stage][lane] = z2[stage].get((size_t) lane);
+        }
+    }
+    current = target;
+    for (int band = 0; band < numBands; ++band)
+        gains[band] = newGains[band];
+}
+
+void DeckEqualiser::setBandGain(Band band, float gain)
+{
+    targetGains[band] = juce::jlimit(0.0f, 2.0f, gain);
+}
+
+void DeckEqualiser::setFilterPosition(float position)
+{
+    filterPosition = juce::jlimit(-1.0f, 1.0f, position);
+}
+
+void DeckEqualiser::setFilterResonance(float q)
+{
+    filterResonance = juce::jlimit(0.5f, 8.0f, q);
+}
+
+DeckEqualiser::Coefficients DeckEqualiser::makeLowPass(double rate, double frequency, double q)
+{
+    auto w0 = juce::MathConstants<double>::twoPi * frequency / rate;
+    auto cosW0 = std::cos(w0), alpha = std::sin(w0) / (2.0 * q), a0 = 1.0 + alpha;
+
+    Coefficients c;
+    c.b0 = (float) ((1.0 - cosW0) / 2.0 / a0);
+    c.b1 = (float) ((1.0 - cosW0) / a0);
+    c.b2 = c.b0;
+    c.a1 = (float) (-2.0 * cosW0 / a0);
+    c.a2 = (float) ((1.0 - alpha) / a0);
+    return c;
+}
+
+DeckEqualiser::Coefficients DeckEqualiser::makeHighPass(double rate, double frequency, double q)
+{
+    auto w0 = juce::MathConstants<double>::twoPi * frequency / rate;
+    auto cosW0 = std::cos(w0), alpha = std::sin(w0) / (2.0 * q), a0 = 1.0 + alpha;
+
+    Coefficients c;
+    c.b0 = (float) ((1.0 + cosW0) / 2.0 / a0);
+    c.b1 = (float) (-(1.0 + cosW0) / a0);
+    c.b2 = c.b0;
+    c.a1 = (float) (-2.0 * cosW0 / a0);
+    c.a2 = (float) ((1.0 - alpha) / a0);
+    return c;
+}
+
+DeckEqualiser::Coefficients DeckEqualiser::makeAllPass(double rate, double frequency, double q)
+{
+    auto w0 = juce::MathConstants<double>::twoPi * frequency / rate;
+    auto cosW0 = std::cos(w0), alpha = std::sin(w0) / (2.0 * q), a0 = 1.0 + alpha;
+
+    Coefficients c;
+    c.b0 = (float) ((1.0 - alpha) / a0);
+    c.b1 = (float) (-2.0 * cosW0 / a0);
+    c.b2 = 1.0f;
+    c.a1 = c.b1;
+    c.a2 = c.b0;
+    return c;
+}
+
+DeckEqualiser::Coefficients DeckEqualiser::makeSweepCoefficients(float position, float q) const
+{
+    // off: a plain wire
+    if (std::abs(position) < filterDeadZone)
+        return {};
+
+    auto amount = (std::abs(position) - filterDeadZone) / (1.0f - filterDeadZone);
+    auto nyquistLimit = 0.45 * sampleRate;
+
+    if (position < 0.0f) {
+        auto frequency = lowPassTop * std::pow(lowPassBottom / lowPassTop, (double) amount);
+        return makeLowPass(sampleRate, juce::jmin(frequency, nyquistLimit), q);
+    }
+
+    auto frequency = highPassBottom * std::pow(highPassTop / highPassBottom, (double) amount);
+    return makeHighPass(sampleRate, juce::jmin(frequency, nyquistLimit), q);
+}
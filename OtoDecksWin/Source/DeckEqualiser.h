@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    DeckEqualiser.h
+    Created: 18 Oct 2026 8:03:26pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    The tone controls of one deck: a 3-band kill EQ followed by a sweepable
+    resonant high-/low-pass filter.
+
+    The bands are split by Linkwitz-Riley crossovers, so every band can be
+    killed completely and the EQ is flat (an allpass) when all gains are 1.
+    All filters are biquads running on juce::dsp::SIMDRegister, one channel
+    per lane, so stereo costs the same as mono. The sweep filter's
+    coefficients and the band gains are interpolated across each block.
+    Nothing is allocated after prepare().
+*/
+class DeckEqualiser
+{
+public:
+    enum Band
+    {
+        lowBand = 0,
+        midBand,
+        highBand,
+        numBands
+    };
+
+    DeckEqualiser();
+    ~DeckEqualiser();
+
+    /**
+    *   Compute the crossovers for the sample rate and clear the filter state.
+    *   @param sampleRate the sample rate of the device
+    */
+    void prepare(double sampleRate);
+
+    /** clear the filter state and move the gains straight to their targets, e.g. after a silent stretch */
+    void reset();
+
+    /**
+    *   Filter a block in place. Channels beyond the SIMD width are left untouched.
+    *   @param buffer the buffer to be processed
+    *   @param startSample the first sample of the block
+    *   @param numSamples the number of samples in the block
+    */
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /**
+    *   Set the gain of a band, may be called from any thread.
+    *   @param band the band to be changed
+    *   @param gain 0 to kill the band, 1 for flat, up to 2 (+6 dB)
+    */
+    void setBandGain(Band band, float gain);
+
+    /**
+    *   Set the sweep filter, may be called from any thread.
+    *   @param position -1 to 0 sweeps a low-pass down, 0 is off, 0 to 1 sweeps a high-pass up
+    */
+    void setFilterPosition(float position);
+
+    /**
+    *   Set the resonance of the sweep filter.
+    *   @param q the filter Q, from 0.5 to 8
+    */
+    void setFilterResonance(float q);
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    enum Stage
+    {
+        lowPassA = 0, lowPassB,            // low band: LR4 low-pass at the low crossover
+        highPassA, highPassB,              // rest: LR4 high-pass at the low crossover
+        midPassA, midPassB,                // mid band: LR4 low-pass of the rest at the high crossover
+        topPassA, topPassB,                // high band: LR4 high-pass of the rest at the high crossover
+        lowAllPass,                        // keeps the low band in phase with the other two
+        sweep,                             // the sweep filter
+        numStages
+    };
+
+    static constexpr int maxLanes = 8;
+
+    static Coefficients makeLowPass(double rate, double frequency, double q);
+    static Coefficients makeHighPass(double rate, double frequency, double q);
+    static Coefficients makeAllPass(double rate, double frequency, double q);
+    Coefficients makeSweepCoefficients(float position, float q) const;
+
+    double sampleRate = 44100.0;
+
+    Coefficients coefficients[numStages];
+    float state1[numStages][maxLanes] = {};
+    float state2[numStages][maxLanes] = {};
+    float gains[numBands] = { 1.0f, 1.0f, 1.0f };
+
+    std::atomic<float> targetGains[numBands];
+    std::atomic<float> filterPosition{ 0.0f };
+    std::atomic<float> filterResonance{ 1.2f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckEqualiser)
+};
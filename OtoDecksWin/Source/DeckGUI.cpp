@@ -1,153 +1,475 @@
-/*
-  ==============================================================================
-
-    DeckGUI.cpp
-    Created: 4 Aug 2020 12:09:53pm
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "DeckGUI.h"
-
-//==============================================================================
-DeckGUI::DeckGUI(DJAudioPlayer* _player) : player{ _player }     
-{
-    addAndMakeVisible(playButton);
-    addAndMakeVisible(stopButton);
-
-    addAndMakeVisible(volSlider);
-    addAndMakeVisible(speedSlider);
-    addAndMakeVisible(posSlider);
-
-    addAndMakeVisible(speedLabel);
-    addAndMakeVisible(volLabel);
-    addAndMakeVisible(posLabel);
-
-    playButton.addListener(this);
-    stopButton.addListener(this);
-
-    volSlider.addListener(this);
-    speedSlider.addListener(this);
-    posSlider.addListener(this);
-
-    volSlider.setRange(0.0, 1.0);
-    speedSlider.setRange(0.0, 100.0);
-    posSlider.setRange(0.0, 1.0);  
-}
-
-DeckGUI::~DeckGUI()
-{
-
-}
-
-void DeckGUI::resized()
-{
-    // set bounds for buttons
-    double rowH = getHeight() / 6;
-    playButton.setBounds(0, 0, getWidth()/2, rowH);
-    stopButton.setBounds(getWidth()/2, 0 , getWidth()/2, rowH);
-
-    // set bounds for labels
-    volLabel.setBounds(40, rowH, 100, 50);    
-    speedLabel.setBounds(getWidth() / 3 + 30, rowH, 100, 50);
-    posLabel.setBounds(getWidth() / 3 * 2 + 10, rowH, 100, 50);
-
-    // set bounds for sliders    
-    volSlider.setBounds(20, rowH + 30, getWidth()/4, rowH * 3.5);
-    speedSlider.setBounds(getWidth() / 3+10, rowH + 30, getWidth() / 4, rowH * 3.5);
-    posSlider.setBounds(getWidth() / 3*2, rowH + 30, getWidth() / 4, rowH * 3.5); 
-}
-
-/**
-*   R1A: Component has custom graphics implemented in a paint function.
-*   Set the custom styles and colors for widgets.
-*   @param g the graphics to be painted
-*/
-
-void DeckGUI::paint(juce::Graphics& g)
-{
-    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));   // clear the background
-
-    g.setColour(juce::Colours::navy);
-    g.fillAll();
-
-    g.setColour(juce::Colours::grey);
-    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
-
-    g.setColour(juce::Colours::white);
-    g.setFont(14.0f);
-    g.drawText("CustomeDeckGUI", getLocalBounds(),
-        juce::Justification::centredBottom, true);   // draw some placeholder text
-
-    // set color for buttons
-    playButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
-    stopButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
-
-    // set color for button text
-    playButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
-    stopButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
-
-    double rowH = getHeight() / 8;
-
-    // set style for volume label    
-    volLabel.setFont(juce::Font(15.0f, juce::Font::bold));
-    volLabel.setText("Volume", juce::dontSendNotification);
-    volLabel.setColour(juce::Label::textColourId, juce::Colours::lightyellow);
-
-    // set style for speed label    
-    speedLabel.setFont(juce::Font(15.0f, juce::Font::bold));
-    speedLabel.setText("Speed", juce::dontSendNotification);
-    speedLabel.setColour(juce::Label::textColourId, juce::Colours::lightyellow);
-
-    // set style for position label    
-    posLabel.setFont(juce::Font(15.0f, juce::Font::bold));
-    posLabel.setText("Position", juce::dontSendNotification);
-    posLabel.setColour(juce::Label::textColourId, juce::Colours::lightyellow);
-
-    // set style for sliders
-    volSlider.setSliderStyle(juce::Slider::SliderStyle::LinearBarVertical);
-    speedSlider.setSliderStyle(juce::Slider::SliderStyle::LinearBarVertical);
-    posSlider.setSliderStyle(juce::Slider::SliderStyle::LinearBarVertical);
-
-    // set track color for sliders
-    volSlider.setColour(juce::Slider::trackColourId, juce::Colour(115, 181, 221));
-    speedSlider.setColour(juce::Slider::trackColourId, juce::Colour(115, 181, 221));
-    posSlider.setColour(juce::Slider::trackColourId, juce::Colour(115, 181, 221));
-}
-
-/**
-*   R1B: Component enables the user to control the playback of a deck somehow.
-*   implement Button::Listener for PLAY and STOP buttons.
-*   @param button the button to be processed
-*/
-
-void DeckGUI::buttonClicked(juce::Button* button)
-{
-    if (button == &playButton) {
-        player->setPosition(0);
-        player->start();
-    }
-    if (button == &stopButton) {
-        player->stop();
-    }    
-}
-
-/**
-*   R1B: Component enables the user to control the playback of a deck somehow.
-*   implement Slider::Listener for sliders.
-*   @param slider the slider to be processed
-*/
-
-void DeckGUI::sliderValueChanged(juce::Slider* slider)
-{
-        if (slider == &posSlider)
-            player->setPositionRelative(slider->getValue());
-
-        if (slider == &speedSlider)
-            player->setSpeed(slider->getValue());
-
-        if (slider == &volSlider)
-            player->setGain(slider->getValue()); 
-}
\ No newline at end of file
+/*
+  ==============================================================================
+
+    DeckGUI.cpp
+    Created: 4 Aug 2020 12:09:53pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DeckGUI.h"
+
+namespace
+{
+    // a 33 1/3 rpm record turns once every 1.8 seconds
+    const double secondsPerTurn = 1.8;
+}
+
+//==============================================================================
+DeckGUI::DeckGUI(DJAudioPlayer* _player, DeckMixer* _mixer) : player{ _player }, mixer{ _mixer }, fxMenu{ _mixer->getChain(_player) }     
+{
+    addAndMakeVisible(playButton);
+    addAndMakeVisible(stopButton);
+    addAndMakeVisible(syncButton);
+    addAndMakeVisible(reverseButton);
+    addAndMakeVisible(cueButton);
+    addAndMakeVisible(fxButton);
+
+    addAndMakeVisible(volSlider);
+    addAndMakeVisible(speedSlider);
+    addAndMakeVisible(posSlider);
+
+    addAndMakeVisible(speedLabel);
+    addAndMakeVisible(volLabel);
+    addAndMakeVisible(posLabel);
+
+    for (auto* knob : { &lowKnob, &midKnob, &highKnob, &filterKnob }) {
+        addAndMakeVisible(*knob);
+        knob->addListener(this);
+    }
+    lowLabel.attachToComponent(&lowKnob, false);
+    midLabel.attachToComponent(&midKnob, false);
+    highLabel.attachToComponent(&highKnob, false);
+    filterLabel.attachToComponent(&filterKnob, false);
+
+    playButton.addListener(this);
+    stopButton.addListener(this);
+    syncButton.addListener(this);
+    syncButton.setClickingTogglesState(true);
+    reverseButton.addListener(this);
+    reverseButton.setClickingTogglesState(true);
+    cueButton.addListener(this);
+    cueButton.setClickingTogglesState(true);
+    fxButton.addListener(this);
+
+    for (int i = 0; i < DJAudioPlayer::numHotCues; ++i) {
+        hotCueButtons[i].setButtonText("CUE " + juce::String(i + 1));
+        addAndMakeVisible(hotCueButtons[i]);
+        hotCueButtons[i].addListener(this);
+    }
+    for (auto* button : { &loopInButton, &loopOutButton, &beatLoopButton, &exitLoopButton }) {
+        addAndMakeVisible(*button);
+        button->addListener(this);
+    }
+
+    volSlider.addListener(this);
+    speedSlider.addListener(this);
+    posSlider.addListener(this);
+
+    volSlider.setRange(0.0, 1.0);
+    speedSlider.setRange(0.0, 100.0);
+    posSlider.setRange(0.0, 1.0);  
+
+    // EQ gains: 0 kills the band, 1 is flat at the centre of the knob
+    for (auto* knob : { &lowKnob, &midKnob, &highKnob }) {
+        knob->setRange(0.0, 2.0);
+        knob->setSkewFactorFromMidPoint(1.0);
+        knob->setValue(1.0, juce::dontSendNotification);
+        knob->setDoubleClickReturnValue(true, 1.0);
+    }
+    filterKnob.setRange(-1.0, 1.0);
+    filterKnob.setValue(0.0, juce::dontSendNotification);
+    filterKnob.setDoubleClickReturnValue(true, 0.0);
+
+    for (auto* button : { &echoButton, &reverbButton, &flangerButton }) {
+        addAndMakeVisible(*button);
+        button->addListener(this);
+        button->setClickingTogglesState(true);
+    }
+
+    // echo times in beats, the item id is the number of quarter beats
+    addAndMakeVisible(echoBeatsBox);
+    for (auto quarters : { 1, 2, 3, 4, 8, 16 })
+        echoBeatsBox.addItem(juce::String(quarters / 4.0) + " beat", quarters);
+    echoBeatsBox.setSelectedId(3, juce::dontSendNotification);
+    echoBeatsBox.addListener(this);
+
+    addAndMakeVisible(effectAmountSlider);
+    effectAmountSlider.addListener(this);
+    effectAmountSlider.setRange(0.0, 1.0);
+    effectAmountSlider.setValue(0.5, juce::dontSendNotification);
+    effectAmountSlider.setDoubleClickReturnValue(true, 0.5);
+
+    // the jog wheel turns endlessly, a full turn is 0 to 1
+    addAndMakeVisible(jogWheel);
+    jogWheel.addListener(this);
+    jogWheel.setRange(0.0, 1.0);
+    jogWheel.setRotaryParameters(0.0f, juce::MathConstants<float>::twoPi, false);
+
+    startTimer(100);
+}
+
+DeckGUI::~DeckGUI()
+{
+
+}
+
+void DeckGUI::resized()
+{
+    // set bounds for buttons
+    double rowH = getHeight() / 7;
+    playButton.setBounds(0, 0, getWidth()/6, rowH);
+    stopButton.setBounds(getWidth()/6, 0 , getWidth()/6, rowH);
+    syncButton.setBounds(getWidth()/6*2, 0 , getWidth()/6, rowH);
+    reverseButton.setBounds(getWidth()/6*3, 0 , getWidth()/6, rowH);
+    cueButton.setBounds(getWidth()/6*4, 0 , getWidth()/6, rowH);
+    fxButton.setBounds(getWidth()/6*5, 0 , getWidth()/6, rowH);
+
+    // set bounds for the hot cue and loop buttons along the bottom
+    double buttonW = getWidth() / 8;
+    for (int i = 0; i < DJAudioPlayer::numHotCues; ++i)
+        hotCueButtons[i].setBounds(buttonW * i, rowH * 5, buttonW, rowH);
+    loopInButton.setBounds(buttonW * 4, rowH * 5, buttonW, rowH);
+    loopOutButton.setBounds(buttonW * 5, rowH * 5, buttonW, rowH);
+    beatLoopButton.setBounds(buttonW * 6, rowH * 5, buttonW, rowH);
+    exitLoopButton.setBounds(buttonW * 7, rowH * 5, buttonW, rowH);
+
+    // set bounds for the effects in the last row
+    echoButton.setBounds(0, rowH * 6, buttonW, rowH);
+    reverbButton.setBounds(buttonW, rowH * 6, buttonW, rowH);
+    flangerButton.setBounds(buttonW * 2, rowH * 6, buttonW, rowH);
+    echoBeatsBox.setBounds(buttonW * 3, rowH * 6, buttonW, rowH);
+    effectAmountSlider.setBounds(buttonW * 4, rowH * 6, buttonW * 4, rowH);
+
+    // set bounds for labels, the sliders take the left 60%
+    double colW = getWidth() / 5;
+    volLabel.setBounds(20, rowH, 100, 50);    
+    speedLabel.setBounds(colW + 20, rowH, 100, 50);
+    posLabel.setBounds(colW * 2 + 10, rowH, 100, 50);
+
+    // set bounds for sliders    
+    volSlider.setBounds(10, rowH + 30, colW - 20, rowH * 4 - 40);
+    speedSlider.setBounds(colW + 10, rowH + 30, colW - 20, rowH * 4 - 40);
+    posSlider.setBounds(colW * 2 + 10, rowH + 30, colW - 20, rowH * 4 - 40); 
+
+    // set bounds for the EQ and filter knobs in a row over the jog wheel, in the right 40%
+    double knobW = colW / 2;
+    lowKnob.setBounds(colW * 3, rowH + 20, knobW, rowH * 1.5 - 20);
+    midKnob.setBounds(colW * 3 + knobW, rowH + 20, knobW, rowH * 1.5 - 20);
+    highKnob.setBounds(colW * 4, rowH + 20, knobW, rowH * 1.5 - 20);
+    filterKnob.setBounds(colW * 4 + knobW, rowH + 20, knobW, rowH * 1.5 - 20);
+
+    // set bounds for the jog wheel
+    jogWheel.setBounds(colW * 3, rowH * 2.5, colW * 2, rowH * 2.5);
+}
+
+/**
+*   R1A: Component has custom graphics implemented in a paint function.
+*   Set the custom styles and colors for widgets.
+*   @param g the graphics to be painted
+*/
+
+void DeckGUI::paint(juce::Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));   // clear the background
+
+    g.setColour(juce::Colours::navy);
+    g.fillAll();
+
+    g.setColour(juce::Colours::grey);
+    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
+
+    g.setColour(juce::Colours::white);
+    g.setFont(14.0f);
+    g.drawText("CustomeDeckGUI", getLocalBounds(),
+        juce::Justification::centredBottom, true);   // draw some placeholder text
+
+    // set color for buttons
+    playButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+    stopButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+    syncButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+    syncButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(115, 181, 221));
+
+    // set color for button text
+    playButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+    stopButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+    syncButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+    syncButton.setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+    reverseButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+    reverseButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(115, 181, 221));
+    reverseButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+    reverseButton.setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+    cueButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+    cueButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(255, 179, 71));
+    cueButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+    cueButton.setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+    fxButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+    fxButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+
+    // set color for hot cue and loop buttons, lit while set or active
+    for (auto& button : hotCueButtons) {
+        button.setColour(juce::TextButton::buttonColourId, juce::Colour(34, 53, 70));
+        button.setColour(juce::TextButton::buttonOnColourId, juce::Colour(255, 179, 71));
+        button.setColour(juce::TextButton::textColourOffId, juce::Colours::lightyellow);
+        button.setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+    }
+    for (auto* button : { &loopInButton, &loopOutButton, &beatLoopButton, &exitLoopButton }) {
+        button->setColour(juce::TextButton::buttonColourId, juce::Colour(34, 53, 70));
+        button->setColour(juce::TextButton::buttonOnColourId, juce::Colour(115, 181, 221));
+        button->setColour(juce::TextButton::textColourOffId, juce::Colours::lightyellow);
+        button->setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+    }
+    for (auto* button : { &echoButton, &reverbButton, &flangerButton }) {
+        button->setColour(juce::TextButton::buttonColourId, juce::Colour(34, 53, 70));
+        button->setColour(juce::TextButton::buttonOnColourId, juce::Colour(255, 179, 71));
+        button->setColour(juce::TextButton::textColourOffId, juce::Colours::lightyellow);
+        button->setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+    }
+
+    // set style for the effect amount, dry on the left and wet on the right
+    effectAmountSlider.setSliderStyle(juce::Slider::SliderStyle::LinearHorizontal);
+    effectAmountSlider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+    effectAmountSlider.setColour(juce::Slider::trackColourId, juce::Colour(115, 181, 221));
+    effectAmountSlider.setColour(juce::Slider::thumbColourId, juce::Colour(255, 219, 255));
+
+    double rowH = getHeight() / 8;
+
+    // set style for volume label    
+    volLabel.setFont(juce::Font(15.0f, juce::Font::bold));
+    volLabel.setText("Volume", juce::dontSendNotification);
+    volLabel.setColour(juce::Label::textColourId, juce::Colours::lightyellow);
+
+    // set style for speed label    
+    speedLabel.setFont(juce::Font(15.0f, juce::Font::bold));
+    speedLabel.setText("Speed", juce::dontSendNotification);
+    speedLabel.setColour(juce::Label::textColourId, juce::Colours::lightyellow);
+
+    // set style for position label    
+    posLabel.setFont(juce::Font(15.0f, juce::Font::bold));
+    posLabel.setText("Position", juce::dontSendNotification);
+    posLabel.setColour(juce::Label::textColourId, juce::Colours::lightyellow);
+
+    // set style for sliders
+    volSlider.setSliderStyle(juce::Slider::SliderStyle::LinearBarVertical);
+    speedSlider.setSliderStyle(juce::Slider::SliderStyle::LinearBarVertical);
+    posSlider.setSliderStyle(juce::Slider::SliderStyle::LinearBarVertical);
+
+    // set track color for sliders
+    volSlider.setColour(juce::Slider::trackColourId, juce::Colour(115, 181, 221));
+    speedSlider.setColour(juce::Slider::trackColourId, juce::Colour(115, 181, 221));
+    posSlider.setColour(juce::Slider::trackColourId, juce::Colour(115, 181, 221));
+
+    // set style for the EQ and filter knobs
+    lowLabel.setText("Low", juce::dontSendNotification);
+    midLabel.setText("Mid", juce::dontSendNotification);
+    highLabel.setText("High", juce::dontSendNotification);
+    filterLabel.setText("Filter", juce::dontSendNotification);
+    for (auto* label : { &lowLabel, &midLabel, &highLabel, &filterLabel }) {
+        label->setFont(juce::Font(13.0f, juce::Font::bold));
+        label->setJustificationType(juce::Justification::centred);
+        label->setColour(juce::Label::textColourId, juce::Colours::lightyellow);
+    }
+    for (auto* knob : { &lowKnob, &midKnob, &highKnob, &filterKnob }) {
+        knob->setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+        knob->setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+        knob->setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(115, 181, 221));
+        knob->setColour(juce::Slider::thumbColourId, juce::Colour(255, 219, 255));
+    }
+
+    // set style for the jog wheel
+    jogWheel.setSliderStyle(juce::Slider::SliderStyle::Rotary);
+    jogWheel.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+    jogWheel.setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(34, 53, 70));
+    jogWheel.setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(34, 53, 70));
+    jogWheel.setColour(juce::Slider::thumbColourId, juce::Colour(255, 219, 255));
+}
+
+/**
+*   R1B: Component enables the user to control the playback of a deck somehow.
+*   implement Button::Listener for PLAY and STOP buttons.
+*   @param button the button to be processed
+*/
+
+void DeckGUI::buttonClicked(juce::Button* button)
+{
+    // starts and stops go through the mixer, so they land on an exact sample
+    if (button == &playButton) {
+        if (player->isSyncEnabled() && player->getSyncTarget() != nullptr) {
+            // a synced deck comes in on the next bar of the deck it follows
+            mixer->startOnNextBar(player, player->getSyncTarget());
+        }
+        else {
+            // skip the silence before the track
+            player->setPosition(player->getAutoCue());
+            mixer->scheduleStart(player);
+        }
+    }
+    if (button == &stopButton) {
+        mixer->scheduleStop(player);
+    }    
+    if (button == &syncButton) {
+        player->setSyncEnabled(syncButton.getToggleState());
+    }
+    if (button == &reverseButton) {
+        sliderValueChanged(&speedSlider);
+    }
+    if (button == &fxButton) {
+        fxMenu.show(fxButton);
+    }
+    if (button == &cueButton) {
+        mixer->setCueEnabled(player, cueButton.getToggleState());
+    }
+    for (int i = 0; i < DJAudioPlayer::numHotCues; ++i) {
+        if (button != &hotCueButtons[i])
+            continue;
+
+        if (juce::ModifierKeys::currentModifiers.isShiftDown())
+            player->clearHotCue(i);
+        else if (player->hasHotCue(i))
+            player->triggerHotCue(i);
+        else
+            player->setHotCue(i);
+    }
+    if (button == &loopInButton) {
+        player->setLoopIn();
+    }
+    if (button == &loopOutButton) {
+        player->setLoopOut();
+    }
+    if (button == &beatLoopButton) {
+        player->setBeatLoop(4.0);
+    }
+    if (button == &exitLoopButton) {
+        player->exitLoop();
+    }
+    if (button == &echoButton) {
+        player->setEffectEnabled(DeckEffects::echo, echoButton.getToggleState());
+    }
+    if (button == &reverbButton) {
+        player->setEffectEnabled(DeckEffects::reverb, reverbButton.getToggleState());
+    }
+    if (button == &flangerButton) {
+        player->setEffectEnabled(DeckEffects::flanger, flangerButton.getToggleState());
+    }
+}
+
+/**
+*   R1B: Component enables the user to control the playback of a deck somehow.
+*   implement Slider::Listener for sliders.
+*   @param slider the slider to be processed
+*/
+
+void DeckGUI::sliderValueChanged(juce::Slider* slider)
+{
+        if (slider == &posSlider)
+            player->setPositionRelative(slider->getValue());
+
+        if (slider == &speedSlider)
+            player->setSpeed(reverseButton.getToggleState() ? -slider->getValue() : slider->getValue());
+
+        if (slider == &volSlider)
+            player->setGain(slider->getValue()); 
+
+        if (slider == &lowKnob)
+            player->setEqualiserGain(DeckEqualiser::lowBand, slider->getValue());
+
+        if (slider == &midKnob)
+            player->setEqualiserGain(DeckEqualiser::midBand, slider->getValue());
+
+        if (slider == &highKnob)
+            player->setEqualiserGain(DeckEqualiser::highBand, slider->getValue());
+
+        if (slider == &filterKnob)
+            player->setFilterPosition(slider->getValue());
+
+        if (slider == &effectAmountSlider) {
+            for (int effect = 0; effect < DeckEffects::numEffects; ++effect)
+                player->setEffectAmount(effect, slider->getValue());
+        }
+
+        if (slider == &jogWheel) {
+            // the first value of a drag is where the wheel was touched, not a movement
+            if (lastJogValue < 0.0) {
+                lastJogValue = slider->getValue();
+                return;
+            }
+
+            // the wheel wraps from 1 to 0, take the short way round
+            auto turns = slider->getValue() - lastJogValue;
+            if (turns > 0.5)
+                turns -= 1.0;
+            if (turns < -0.5)
+                turns += 1.0;
+            lastJogValue = slider->getValue();
+            player->jog(turns * secondsPerTurn);
+        }
+}
+
+/**
+*   Set the echo time from the beats box.
+*   @param comboBox the combo box that changed
+*/
+
+void DeckGUI::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    if (comboBox == &echoBeatsBox)
+        player->setEchoBeats(echoBeatsBox.getSelectedId() / 4.0);
+}
+
+/**
+*   Touching the jog wheel holds the platter for scratching.
+*   @param slider the slider being dragged
+*/
+
+void DeckGUI::sliderDragStarted(juce::Slider* slider)
+{
+    if (slider == &jogWheel) {
+        lastJogValue = -1.0;
+        player->setScratching(true);
+    }
+}
+
+/**
+*   Letting go of the jog wheel lets the deck play on.
+*   @param slider the slider that was dragged
+*/
+
+void DeckGUI::sliderDragEnded(juce::Slider* slider)
+{
+    if (slider == &jogWheel)
+        player->setScratching(false);
+}
+
+/**
+*   Keep the SYNC button and the speed slider in step with the player,
+*   which changes both on its own while it follows the other deck.
+*   Light up the hot cues which are set and the active loop.
+*/
+
+void DeckGUI::timerCallback()
+{
+    syncButton.setToggleState(player->isSyncEnabled(), juce::dontSendNotification);
+
+    if (player->isSyncEnabled())
+        speedSlider.setValue(player->getSpeed(), juce::dontSendNotification);
+
+    for (int i = 0; i < DJAudioPlayer::numHotCues; ++i)
+        hotCueButtons[i].setToggleState(player->hasHotCue(i), juce::dontSendNotification);
+    beatLoopButton.setToggleState(player->isLoopActive(), juce::dontSendNotification);
+}
+
+/**
+*   Show the player's volume, speed, direction and headphone cue on the controls,
+*   after they were set on the player directly, e.g. by a restored session.
+*/
+
+void DeckGUI::updateFromPlayer()
+{
+    auto speed = player->getSpeedSetting();
+    volSlider.setValue(player->getGain(), juce::dontSendNotification);
+    speedSlider.setValue(std::abs(speed), juce::dontSendNotification);
+    reverseButton.setToggleState(speed < 0.0, juce::dontSendNotification);
+    cueButton.setToggleState(mixer->isCueEnabled(player), juce::dontSendNotification);
+}
@@ -1,70 +1,150 @@
-/*
-  ==============================================================================
-
-    DeckGUI.h
-    Created: 4 Aug 2020 12:09:53pm
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "DJAudioPlayer.h"
-
-//==============================================================================
-/*
-*/
-class DeckGUI  : public juce::Component,
-                 public juce::Button::Listener,
-                 public juce::Slider::Listener               
-{
-public:
-    DeckGUI(DJAudioPlayer* _player);
-
-    ~DeckGUI() override;
-    
-    void resized() override;
-
-    /**
-    *   R1A: Component has custom graphics implemented in a paint function.
-    *   Set the custom styles and colors for widgets.
-    *   @param g the graphics to be painted
-    */
-
-    void paint(juce::Graphics& g) override;
-
-    /** 
-    *   R1B: Component enables the user to control the playback of a deck somehow.
-    *   implement Button::Listener for PLAY and STOP buttons.
-    *   @param button the button to be processed
-    */
-
-    void buttonClicked(juce::Button* button) override;
-
-    /**
-    *   R1B: Component enables the user to control the playback of a deck somehow.
-    *   implement Slider::Listener for sliders.
-    *   @param slider the slider to be processed
-    */
-
-    void sliderValueChanged(juce::Slider* slider) override;
-
-
-private:
-    juce::TextButton playButton{ "PLAY" };
-    juce::TextButton stopButton{ "STOP" };
-
-    DJAudioPlayer* player;
-
-    juce::Slider volSlider;
-    juce::Slider speedSlider;
-    juce::Slider posSlider;
-
-    juce::Label speedLabel;
-    juce::Label volLabel;
-    juce::Label posLabel;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckGUI)
-};
+/*
+  ==============================================================================
+
+    DeckGUI.h
+    Created: 4 Aug 2020 12:09:53pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "DeckMixer.h"
+#include "PluginChainMenu.h"
+
+//==============================================================================
+/*
+*/
+class DeckGUI  : public juce::Component,
+                 public juce::Button::Listener,
+                 public juce::Slider::Listener,
+                 public juce::ComboBox::Listener,
+                 public juce::Timer
+{
+public:
+    DeckGUI(DJAudioPlayer* _player, DeckMixer* _mixer);
+
+    ~DeckGUI() override;
+    
+    void resized() override;
+
+    /**
+    *   R1A: Component has custom graphics implemented in a paint function.
+    *   Set the custom styles and colors for widgets.
+    *   @param g the graphics to be painted
+    */
+
+    void paint(juce::Graphics& g) override;
+
+    /** 
+    *   R1B: Component enables the user to control the playback of a deck somehow.
+    *   implement Button::Listener for PLAY and STOP buttons.
+    *   @param button the button to be processed
+    */
+
+    void buttonClicked(juce::Button* button) override;
+
+    /**
+    *   R1B: Component enables the user to control the playback of a deck somehow.
+    *   implement Slider::Listener for sliders.
+    *   @param slider the slider to be processed
+    */
+
+    void sliderValueChanged(juce::Slider* slider) override;
+
+    /**
+    *   Set the echo time from the beats box.
+    *   @param comboBox the combo box that changed
+    */
+
+    void comboBoxChanged(juce::ComboBox* comboBox) override;
+
+    /**
+    *   Touching the jog wheel holds the platter for scratching.
+    *   @param slider the slider being dragged
+    */
+
+    void sliderDragStarted(juce::Slider* slider) override;
+
+    /**
+    *   Letting go of the jog wheel lets the deck play on.
+    *   @param slider the slider that was dragged
+    */
+
+    void sliderDragEnded(juce::Slider* slider) override;
+
+    /**
+    *   Keep the SYNC button and the speed slider in step with the player,
+    *   which changes both on its own while it follows the other deck.
+    *   Light up the hot cues which are set and the active loop.
+    */
+
+    void timerCallback() override;
+
+    /**
+    *   Show the player's volume, speed, direction and headphone cue on the controls,
+    *   after they were set on the player directly, e.g. by a restored session.
+    */
+
+    void updateFromPlayer();
+
+
+private:
+    juce::TextButton playButton{ "PLAY" };
+    juce::TextButton stopButton{ "STOP" };
+    juce::TextButton syncButton{ "SYNC" };
+    juce::TextButton reverseButton{ "REV" };
+
+    // pre-fade listen: sends the deck to the headphones
+    juce::TextButton cueButton{ "PFL" };
+
+    // the deck's insert effects
+    juce::TextButton fxButton{ "FX" };
+
+    // the built-in effects: switching one off lets its tail ring out
+    juce::TextButton echoButton{ "ECHO" };
+    juce::TextButton reverbButton{ "REVERB" };
+    juce::TextButton flangerButton{ "FLANGER" };
+    juce::ComboBox echoBeatsBox;
+    juce::Slider effectAmountSlider;
+
+    // hot cues: click to set an empty one or jump to a set one, shift-click to clear
+    juce::TextButton hotCueButtons[DJAudioPlayer::numHotCues];
+
+    juce::TextButton loopInButton{ "IN" };
+    juce::TextButton loopOutButton{ "OUT" };
+    juce::TextButton beatLoopButton{ "LOOP 4" };
+    juce::TextButton exitLoopButton{ "EXIT" };
+
+    DJAudioPlayer* player;
+    DeckMixer* mixer;
+    PluginChainMenu fxMenu;
+
+    juce::Slider volSlider;
+    juce::Slider speedSlider;
+    juce::Slider posSlider;
+
+    // EQ and filter knobs
+    juce::Slider lowKnob;
+    juce::Slider midKnob;
+    juce::Slider highKnob;
+    juce::Slider filterKnob;
+
+    // the platter: one turn moves the playhead as far as a turn of a 33 rpm record
+    juce::Slider jogWheel;
+    double lastJogValue = -1.0;
+
+    juce::Label speedLabel;
+    juce::Label volLabel;
+    juce::Label posLabel;
+
+    juce::Label lowLabel;
+    juce::Label midLabel;
+    juce::Label highLabel;
+    juce::Label filterLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckGUI)
+};
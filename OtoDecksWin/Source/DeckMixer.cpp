@@ -0,0 +1,704 @@
+/*
+  ==============================================================================
+
+    DeckMixer.cpp
+    Created: 18 Oct 2026 10:41:17pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "DeckMixer.h"
+#include <cmath>
+
+namespace
+{
+    // crossfade gains are exact at the ends of slices this long and ramped in between
+    const int fadeSliceSize = 64;
+
+    // nextJob between rounds, past any job list
+    const int noChainJobs = 1 << 30;
+
+    // a chain is heavy when it takes this share of the block's duration
+    const double heavyChainShare = 0.05;
+}
+
+//==============================================================================
+// runs the deck chains the audio thread hands out, woken once per round
+class DeckMixer::ChainWorker  : public juce::Thread
+{
+public:
+    ChainWorker(DeckMixer& _mixer) : juce::Thread("Deck chain worker"), mixer(_mixer)
+    {
+    }
+
+    void run() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+        while (!threadShouldExit()) {
+            if (wakeUp.wait(100))
+                mixer.runChainJobs();
+        }
+    }
+
+    juce::WaitableEvent wakeUp;
+
+private:
+    DeckMixer& mixer;
+};
+
+//==============================================================================
+DeckMixer::DeckMixer(const juce::Array<DJAudioPlayer*>& _decks) : decks(_decks), nextJob(noChainJobs)
+{
+    jassert(decks.size() <= maxDecks);
+    for (auto& enabled : cueEnabled)
+        enabled = false;
+    for (auto& busy : chainBusy)
+        busy = false;
+
+    // the audio thread takes a share itself, so one thread fewer than decks
+    auto numWorkers = juce::jmin(decks.size(), juce::SystemStats::getNumCpus()) - 1;
+    for (int i = 0; i < numWorkers; ++i) {
+        auto* worker = workers.add(new ChainWorker(*this));
+        worker->startThread(juce::Thread::realtimeAudioPriority);
+    }
+}
+
+DeckMixer::~DeckMixer()
+{
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+    for (auto* worker : workers) {
+        worker->wakeUp.signal();
+        worker->stopThread(1000);
+    }
+}
+
+void DeckMixer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    blockSize = samplesPerBlockExpected;
+    deviceSampleRate = sampleRate;
+    maxBlockSize = juce::jmax(1, samplesPerBlockExpected);
+    cueBuffer.setSize(2, maxBlockSize);
+
+    // the plugins get the device's block size, which the decks are rendered in
+    for (int index = 0; index < decks.size(); ++index) {
+        deckBuffers[index].setSize(2, maxBlockSize);
+        delayLines[index].setSize(2, maxLatencyCompensation);
+        delayLines[index].clear();
+        delayPositions[index] = 0;
+        chains[index].prepareToPlay(sampleRate, samplesPerBlockExpected);
+    }
+    masterChain.prepareToPlay(sampleRate, samplesPerBlockExpected);
+    compensatedLatency = 0;
+
+    if (auto* secondDevice = cueOutput.load())
+        secondDevice->setSourceSampleRate(sampleRate);
+
+    if (auto* pads = padBank.load())
+        pads->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    for (auto* deck : decks)
+        deck->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void DeckMixer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    bufferToFill.clearActiveBufferRegion();
+
+    // no decks to render, or no buffers to render them into yet
+    if (decks.isEmpty() || maxBlockSize == 0)
+        return;
+
+    collectCommands();
+
+    auto& output = *bufferToFill.buffer;
+    numOutputChannels = output.getNumChannels();
+
+    // where the cue bus is mixed: straight into the device buffer when it has
+    // the outputs, otherwise into our own buffer for the second device
+    float* cue[2] = { nullptr, nullptr };
+    bool toSecondDevice = false;
+    auto routing = cueRouting.load();
+    auto* secondDevice = cueOutput.load();
+    if (routing == cueOnDeviceChannels && output.getNumChannels() >= 4) {
+        cue[0] = output.getWritePointer(2, bufferToFill.startSample);
+        cue[1] = output.getWritePointer(3, bufferToFill.startSample);
+    }
+    else if (routing == cueOnSecondDevice && secondDevice != nullptr
+             && bufferToFill.numSamples <= cueBuffer.getNumSamples()) {
+        cueBuffer.clear(0, bufferToFill.numSamples);
+        cue[0] = cueBuffer.getWritePointer(0);
+        cue[1] = cueBuffer.getWritePointer(1);
+        toSecondDevice = true;
+    }
+
+    auto clock = masterClock.load();
+    ++blockSequence;
+    blockStartClock = clock;
+    blockStartTime = juce::Time::getMillisecondCounterHiRes();
+    ++blockSequence;
+
+    int done = 0;
+
+    while (done < bufferToFill.numSamples) {
+        // carry out everything due at this sample, late commands included
+        int numDue = 0;
+        while (numDue < numPending && pending[numDue].time <= clock + done) {
+            perform(pending[numDue++], done);
+        }
+        if (numDue > 0) {
+            numPending -= numDue;
+            for (int i = 0; i < numPending; ++i)
+                pending[i] = pending[i + numDue];
+        }
+
+        // render up to the next command, or the end of the block
+        auto end = bufferToFill.numSamples;
+        if (numPending > 0)
+            end = (int) juce::jmin<juce::int64>(end, pending[0].time - clock);
+        end = juce::jmin(end, done + maxBlockSize);
+
+        renderDecks(bufferToFill, done, end - done, cue);
+        done = end;
+    }
+
+    if (auto* pads = padBank.load())
+        pads->renderNextBlock(output, bufferToFill.startSample, bufferToFill.numSamples, clock);
+
+    masterChain.process(output, bufferToFill.startSample, bufferToFill.numSamples);
+
+    if (cue[0] != nullptr) {
+        mixMasterIntoCue(bufferToFill, cue);
+        if (toSecondDevice)
+            secondDevice->push(cueBuffer, 0, bufferToFill.numSamples);
+    }
+
+    if (auto* tap = recorder.load())
+        tap->pushMaster(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    masterClock = clock + bufferToFill.numSamples;
+
+    // the share of the block's duration it took to render
+    auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    auto load = elapsed * deviceSampleRate / juce::jmax(1, bufferToFill.numSamples);
+    cpuLoad = cpuLoad + 0.05 * (load - cpuLoad);
+}
+
+void DeckMixer::releaseResources()
+{
+    for (auto* deck : decks)
+        deck->releaseResources();
+
+    for (auto& chain : chains)
+        chain.releaseResources();
+    masterChain.releaseResources();
+}
+
+juce::int64 DeckMixer::getMasterClock() const
+{
+    return masterClock;
+}
+
+void DeckMixer::scheduleStart(DJAudioPlayer* deck, juce::int64 time, CommandSource source, double timestamp)
+{
+    ScheduledCommand command{ time, deck, ScheduledCommand::start };
+    command.timestamp = timestamp;
+    schedule(command, source);
+}
+
+void DeckMixer::scheduleStop(DJAudioPlayer* deck, juce::int64 time, CommandSource source, double timestamp)
+{
+    ScheduledCommand command{ time, deck, ScheduledCommand::stop };
+    command.timestamp = timestamp;
+    schedule(command, source);
+}
+
+void DeckMixer::scheduleControl(DJAudioPlayer* deck, Control control, double value, juce::int64 time,
+                                CommandSource source, double timestamp)
+{
+    schedule({ time, deck, ScheduledCommand::control, 0, control, value, timestamp }, source);
+}
+
+juce::int64 DeckMixer::getClockTimeAt(double milliseconds) const
+{
+    juce::int64 clock;
+    double time;
+
+    // retry while the audio thread is in the middle of publishing
+    for (;;) {
+        auto sequence = blockSequence.load();
+        clock = blockStartClock;
+        time = blockStartTime;
+        if ((sequence & 1) == 0 && sequence == blockSequence.load())
+            break;
+    }
+    return clock + (juce::int64) std::round((milliseconds - time) * 0.001 * deviceSampleRate);
+}
+
+void DeckMixer::getControlLatency(double& average, double& maximum) const
+{
+    average = averageLatency;
+    maximum = maximumLatency;
+}
+
+void DeckMixer::resetControlLatency()
+{
+    maximumLatency = 0.0;
+}
+
+void DeckMixer::startOnNextBar(DJAudioPlayer* deck, DJAudioPlayer* reference)
+{
+    deck->stop();
+
+    auto ownBpm = deck->getBpm();
+    auto referenceBpm = reference->getBpm();
+    if (ownBpm <= 0 || referenceBpm <= 0) {
+        deck->setPosition(deck->getAutoCue());
+        scheduleStart(deck);
+        return;
+    }
+
+    // skip the silence before the track, but not past the first downbeat
+    auto startPosition = juce::jmin(deck->getAutoCue(), deck->getDownbeatOffset());
+    deck->setPosition(startPosition);
+
+    // start early by the time it takes to play up to the first downbeat,
+    // at the speed the deck will play at once it follows the other one
+    auto ratio = referenceBpm * reference->getSpeed() / ownBpm;
+    auto leadIn = (juce::int64) std::round((deck->getDownbeatOffset() - startPosition) / ratio * deviceSampleRate);
+
+    // leave a block of slack, so the start is never late
+    auto barTime = reference->getNextBarTime(masterClock + blockSize + leadIn);
+    scheduleStart(deck, barTime < 0 ? 0 : barTime - leadIn);
+}
+
+void DeckMixer::scheduleCrossfade(DJAudioPlayer* from, DJAudioPlayer* to, juce::int64 time, juce::int64 length)
+{
+    if (length <= 0) {
+        std::cout << "DeckMixer::scheduleCrossfade length should be more than 0" << std::endl;
+        return;
+    }
+    schedule({ time, to, ScheduledCommand::fadeIn, length });
+    schedule({ time, from, ScheduledCommand::fadeOut, length });
+}
+
+void DeckMixer::cancelCrossfade(DJAudioPlayer* deck)
+{
+    schedule({ 0, deck, ScheduledCommand::cancelFade });
+}
+
+void DeckMixer::setRecorder(SetRecorder* _recorder)
+{
+    recorder = _recorder;
+}
+
+void DeckMixer::setPadBank(SamplePadBank* pads)
+{
+    padBank = pads;
+}
+
+PluginChain* DeckMixer::getChain(DJAudioPlayer* deck)
+{
+    auto index = decks.indexOf(deck);
+    return index >= 0 ? &chains[index] : nullptr;
+}
+
+PluginChain* DeckMixer::getMasterChain()
+{
+    return &masterChain;
+}
+
+int DeckMixer::getPluginLatency() const
+{
+    return deckLatency + masterChain.getLatencySamples();
+}
+
+double DeckMixer::getCpuLoad() const
+{
+    return cpuLoad;
+}
+
+double DeckMixer::getSampleRate() const
+{
+    return deviceSampleRate;
+}
+
+int DeckMixer::getBlockSize() const
+{
+    return blockSize;
+}
+
+int DeckMixer::getNumOutputChannels() const
+{
+    return numOutputChannels;
+}
+
+void DeckMixer::setCueRouting(CueRouting routing, CueOutput* output)
+{
+    cueRouting = cueOff;
+    cueOutput = output;
+    if (output != nullptr)
+        output->setSourceSampleRate(deviceSampleRate);
+    cueRouting = routing;
+}
+
+void DeckMixer::setCueEnabled(DJAudioPlayer* deck, bool enabled)
+{
+    auto index = decks.indexOf(deck);
+    if (index < 0) {
+        std::cout << "DeckMixer::setCueEnabled the deck is not on this mixer" << std::endl;
+        return;
+    }
+    cueEnabled[index] = enabled;
+}
+
+bool DeckMixer::isCueEnabled(DJAudioPlayer* deck) const
+{
+    auto index = decks.indexOf(deck);
+    return index >= 0 && cueEnabled[index];
+}
+
+void DeckMixer::setCueMix(double mix)
+{
+    if (mix < 0 || mix > 1.0) {
+        std::cout << "DeckMixer::setCueMix mix should be between 0 and 1" << std::endl;
+        return;
+    }
+    cueMix = (float) mix;
+}
+
+void DeckMixer::schedule(const ScheduledCommand& command, CommandSource source)
+{
+    auto& queue = commandQueues[source];
+
+    int start1, size1, start2, size2;
+    queue.fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1) {
+        std::cout << "DeckMixer::schedule the command queue is full" << std::endl;
+        return;
+    }
+    queue.commands[size1 > 0 ? start1 : start2] = command;
+    queue.fifo.finishedWrite(1);
+}
+
+void DeckMixer::collectCommands()
+{
+    for (auto& queue : commandQueues) {
+        int start1, size1, start2, size2;
+        queue.fifo.prepareToRead(queue.fifo.getNumReady(), start1, size1, start2, size2);
+
+        int numRead = 0;
+        for (; numRead < size1 + size2; ++numRead) {
+            auto& command = queue.commands[numRead < size1 ? start1 + numRead : start2 + numRead - size1];
+
+            // a cancel takes the deck's fades out of the pending list as soon as it arrives
+            if (command.type == ScheduledCommand::cancelFade) {
+                int kept = 0;
+                for (int j = 0; j < numPending; ++j) {
+                    auto isFade = pending[j].type == ScheduledCommand::fadeIn || pending[j].type == ScheduledCommand::fadeOut;
+                    if (!(isFade && pending[j].deck == command.deck))
+                        pending[kept++] = pending[j];
+                }
+                numPending = kept;
+
+                auto index = decks.indexOf(command.deck);
+                if (index >= 0 && (fades[index].state == DeckFade::fadingIn || fades[index].state == DeckFade::fadingOut))
+                    fades[index].state = DeckFade::none;
+                continue;
+            }
+
+            // the pending list is as big as a queue, so it only fills up when far
+            // future commands pile up; the rest stay queued until some are done
+            if (numPending == commandQueueSize)
+                break;
+
+            // insert sorted, commands due at the same time keep their order
+            auto index = numPending;
+            while (index > 0 && pending[index - 1].time > command.time) {
+                pending[index] = pending[index - 1];
+                --index;
+            }
+            pending[index] = command;
+            ++numPending;
+        }
+        queue.fifo.finishedRead(numRead);
+    }
+}
+
+void DeckMixer::perform(const ScheduledCommand& command, int offset)
+{
+    auto index = decks.indexOf(command.deck);
+    if (index < 0)
+        return;
+
+    // from arrival to the sample the change is rendered at
+    if (command.timestamp > 0.0) {
+        auto latency = blockStartTime + offset * 1000.0 / deviceSampleRate - command.timestamp;
+        averageLatency = averageLatency + 0.05 * (latency - averageLatency);
+        if (latency > maximumLatency)
+            maximumLatency = latency;
+    }
+
+    auto& fade = fades[index];
+    switch (command.type) {
+    case ScheduledCommand::start:
+        fade.state = DeckFade::none;
+        command.deck->start();
+        break;
+
+    case ScheduledCommand::stop:
+        command.deck->stop();
+        break;
+
+    case ScheduledCommand::fadeIn:
+        fade = { DeckFade::fadingIn, command.length, 0 };
+        command.deck->start();
+        break;
+
+    case ScheduledCommand::fadeOut:
+        if (command.deck->isPlaying())
+            fade = { DeckFade::fadingOut, command.length, 0 };
+        break;
+
+    case ScheduledCommand::cancelFade:
+        break;
+
+    case ScheduledCommand::control:
+        performControl(command);
+        break;
+    }
+}
+
+void DeckMixer::performControl(const ScheduledCommand& command)
+{
+    auto* deck = command.deck;
+    switch (command.control) {
+    case gainControl:
+        deck->setGain(juce::jlimit(0.0, 1.0, command.value));
+        break;
+
+    case speedControl:
+        deck->setSpeed(command.value);
+        break;
+
+    case positionControl:
+        deck->jumpTo(juce::jlimit(0.0, 1.0, command.value) * deck->getLengthInSeconds());
+        break;
+
+    case jogControl:
+        deck->jog(command.value);
+        break;
+
+    case jogTouchControl:
+        deck->setScratching(command.value > 0.5);
+        break;
+    }
+}
+
+void DeckMixer::applyFade(int index, int numSamples)
+{
+    auto& fade = fades[index];
+    auto& deckBuffer = deckBuffers[index];
+
+    // a deck the fade stopped stays silent until something starts it again
+    if (fade.state == DeckFade::silenced) {
+        if (decks.getUnchecked(index)->isPlaying())
+            fade.state = DeckFade::none;
+        else
+            deckBuffer.clear(0, numSamples);
+    }
+    if (fade.state != DeckFade::fadingIn && fade.state != DeckFade::fadingOut)
+        return;
+
+    // equal power: the gains of both decks stay on a quarter circle
+    auto gainAt = [&fade](juce::int64 done) {
+        auto angle = juce::MathConstants<double>::halfPi * (double) done / (double) fade.length;
+        return (float) (fade.state == DeckFade::fadingIn ? std::sin(angle) : std::cos(angle));
+    };
+
+    int position = 0;
+    while (position < numSamples && fade.done < fade.length) {
+        auto num = (int) juce::jmin<juce::int64>(juce::jmin(fadeSliceSize, numSamples - position), fade.length - fade.done);
+        deckBuffer.applyGainRamp(position, num, gainAt(fade.done), gainAt(fade.done + num));
+        fade.done += num;
+        position += num;
+    }
+
+    if (fade.done >= fade.length) {
+        if (fade.state == DeckFade::fadingOut) {
+            deckBuffer.clear(position, numSamples - position);
+            decks.getUnchecked(index)->stop();
+            fade.state = DeckFade::silenced;
+        }
+        else {
+            fade.state = DeckFade::none;
+        }
+    }
+}
+
+void DeckMixer::renderDecks(const juce::AudioSourceChannelInfo& bufferToFill, int offset, int numSamples, float* const* cue)
+{
+    auto& output = *bufferToFill.buffer;
+    auto numMasterChannels = juce::jmin(2, output.getNumChannels());
+    auto* tap = recorder.load();
+
+    for (int index = 0; index < decks.size(); ++index) {
+        // a worker is still running the deck's chain from an earlier slice
+        if (chainBusy[index])
+            continue;
+
+        juce::AudioSourceChannelInfo deckInfo(&deckBuffers[index], 0, numSamples);
+        decks.getUnchecked(index)->getNextAudioBlock(deckInfo);
+    }
+
+    processChains(numSamples);
+
+    // every deck waits for the chain with the most latency
+    int maxLatency = 0;
+    for (int index = 0; index < decks.size(); ++index)
+        maxLatency = juce::jmax(maxLatency, chains[index].getLatencySamples());
+    maxLatency = juce::jmin(maxLatency, maxLatencyCompensation - 1);
+
+    // the delay lines only run while there is latency to make up, so they start from silence
+    if (maxLatency > 0 && compensatedLatency == 0) {
+        for (int index = 0; index < decks.size(); ++index)
+            delayLines[index].clear();
+    }
+    compensatedLatency = maxLatency;
+    deckLatency = maxLatency;
+
+    for (int index = 0; index < decks.size(); ++index) {
+        if (chainBusy[index])
+            continue;
+
+        auto& deckBuffer = deckBuffers[index];
+
+        // an idle deck rendered silence with nothing after it to ring out: only the stem is kept going
+        auto fadeState = fades[index].state;
+        if (decks.getUnchecked(index)->isIdle() && chains[index].getNumPlugins() == 0 && maxLatency == 0
+            && (fadeState == DeckFade::none || fadeState == DeckFade::silenced)) {
+            if (tap != nullptr)
+                tap->pushStem(index, deckBuffer, 0, numSamples);
+            continue;
+        }
+
+        if (maxLatency > 0)
+            compensateLatency(index, maxLatency - chains[index].getLatencySamples(), numSamples);
+
+        // the cue bus listens before the crossfade
+        if (cue[0] != nullptr && cueEnabled[index]) {
+            for (int channel = 0; channel < 2; ++channel)
+                juce::FloatVectorOperations::add(cue[channel] + offset,
+                                                 deckBuffer.getReadPointer(juce::jmin(channel, deckBuffer.getNumChannels() - 1)),
+                                                 numSamples);
+        }
+
+        applyFade(index, numSamples);
+
+        if (tap != nullptr)
+            tap->pushStem(index, deckBuffer, 0, numSamples);
+
+        for (int channel = 0; channel < numMasterChannels; ++channel)
+            output.addFrom(channel, bufferToFill.startSample + offset, deckBuffer,
+                           juce::jmin(channel, deckBuffer.getNumChannels() - 1), 0, numSamples);
+    }
+}
+
+void DeckMixer::processChains(int numSamples)
+{
+    auto heavyCost = heavyChainShare * blockSize * 1000.0 / deviceSampleRate;
+
+    int numJobs = 0;
+    int numHeavy = 0;
+    for (int index = 0; index < decks.size(); ++index) {
+        if (chains[index].getNumPlugins() == 0 || chainBusy[index])
+            continue;
+        chainJobs[numJobs++] = index;
+        if (chains[index].getAverageCost() > heavyCost)
+            ++numHeavy;
+    }
+
+    // light chains cost less than waking a thread
+    if (numHeavy < 2 || workers.isEmpty()) {
+        for (int job = 0; job < numJobs; ++job)
+            chains[chainJobs[job]].process(deckBuffers[chainJobs[job]], 0, numSamples);
+        return;
+    }
+
+    chainJobSamples = numSamples;
+    for (int job = 0; job < numJobs; ++job)
+        chainBusy[chainJobs[job]] = true;
+    numChainJobs = numJobs;
+    nextJob = 0;
+    for (int i = 0; i < juce::jmin(workers.size(), numJobs - 1); ++i)
+        workers.getUnchecked(i)->wakeUp.signal();
+
+    // the audio thread takes every job no worker has started yet
+    runChainJobs();
+
+    // the last chains may still be running on the workers; a descheduled
+    // worker keeps its deck out of the mix rather than make the device late
+    auto deadline = juce::Time::getHighResolutionTicks()
+                    + juce::Time::secondsToHighResolutionTicks(0.5 * numSamples / deviceSampleRate);
+    for (int job = 0; job < numJobs; ++job) {
+        while (chainBusy[chainJobs[job]].load() && juce::Time::getHighResolutionTicks() < deadline)
+            ;
+    }
+    nextJob = noChainJobs;
+}
+
+void DeckMixer::runChainJobs()
+{
+    for (;;) {
+        auto job = nextJob++;
+        if (job >= numChainJobs.load())
+            return;
+
+        auto index = chainJobs[job];
+        chains[index].process(deckBuffers[index], 0, chainJobSamples);
+        chainBusy[index] = false;
+    }
+}
+
+void DeckMixer::compensateLatency(int index, int delay, int numSamples)
+{
+    const int mask = maxLatencyCompensation - 1;
+    auto& deckBuffer = deckBuffers[index];
+    auto& line = delayLines[index];
+    auto start = delayPositions[index];
+
+    for (int channel = 0; channel < deckBuffer.getNumChannels(); ++channel) {
+        auto* samples = deckBuffer.getWritePointer(channel);
+        auto* history = line.getWritePointer(channel);
+        auto position = start;
+        for (int i = 0; i < numSamples; ++i) {
+            history[position & mask] = samples[i];
+            samples[i] = history[(position - delay) & mask];
+            ++position;
+        }
+    }
+    delayPositions[index] = (start + numSamples) & mask;
+}
+
+void DeckMixer::mixMasterIntoCue(const juce::AudioSourceChannelInfo& bufferToFill, float* const* cue)
+{
+    auto& output = *bufferToFill.buffer;
+    auto numSamples = bufferToFill.numSamples;
+
+    // the knob moves smoothly across the block
+    auto targetMix = cueMix.load();
+    auto step = (targetMix - currentCueMix) / (float) numSamples;
+
+    for (int channel = 0; channel < 2; ++channel) {
+        auto* master = output.getReadPointer(juce::jmin(channel, output.getNumChannels() - 1), bufferToFill.startSample);
+        auto mix = currentCueMix;
+        for (int i = 0; i < numSamples; ++i) {
+            mix += step;
+            cue[channel][i] += mix * (master[i] - cue[channel][i]);
+        }
+    }
+    currentCueMix = targetMix;
+}
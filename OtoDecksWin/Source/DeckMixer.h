@@ -0,0 +1,372 @@
+/*
+  ==============================================================================
+
+    DeckMixer.h
+    Created: 18 Oct 2026 10:41:17pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "DJAudioPlayer.h"
+#include "SetRecorder.h"
+#include "CueOutput.h"
+#include "SamplePadBank.h"
+#include "PluginChain.h"
+
+//==============================================================================
+/*
+    The audio engine: mixes the decks and keeps the master sample clock, the
+    shared timeline that transport commands are scheduled on.
+
+    Scheduled commands are queued lock-free from the message thread and carried
+    out inside the audio callback at the exact sample they are due: the block
+    is split there, so the decks before and after the command are rendered
+    separately. Every deck is rendered for every sample, which keeps the sample
+    clocks of the decks equal to the master clock.
+
+    Decks can also be sent to the cue bus, the headphone mix of the cued decks
+    and the master. On a device with four or more outputs the cue bus is mixed
+    straight into outputs 3 and 4 of the device buffer; otherwise it can be
+    handed to a CueOutput on a second device.
+
+    Sample pads go to the master bus only, on the same clock as the decks.
+
+    A deck that is stopped or empty, with nothing left ringing, renders
+    silence without touching its resampler, EQ or effects, and the mixer skips
+    its cue, fade and master mixing as well.
+
+    Every deck has an insert chain of effect plugins, and the master bus has
+    one after the pads. The decks whose chains have less latency are delayed
+    to match the one with the most, so they stay in phase. When two or more
+    deck chains are heavy, they run in parallel on worker threads while the
+    audio thread takes its share.
+*/
+class DeckMixer  : public juce::AudioSource
+{
+public:
+    enum CueRouting
+    {
+        cueOff = 0,
+        cueOnDeviceChannels,    // outputs 3 and 4 of the main device
+        cueOnSecondDevice       // a CueOutput
+    };
+
+    /** the threads that schedule commands, each has its own queue */
+    enum CommandSource
+    {
+        messageThread = 0,
+        midiThread,
+        numCommandSources
+    };
+
+    /** the deck controls that can be set on the master clock */
+    enum Control
+    {
+        gainControl = 0,        // 0 to 1
+        speedControl,           // the speed ratio
+        positionControl,        // 0 to 1 of the track
+        jogControl,             // seconds to move a held platter by
+        jogTouchControl         // 1 holds the platter, 0 lets go
+    };
+
+    /**
+    *   @param decks the decks to mix, which must outlive the mixer
+    */
+    DeckMixer(const juce::Array<DJAudioPlayer*>& decks);
+    ~DeckMixer() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    /** get the master clock: the number of samples rendered so far */
+    juce::int64 getMasterClock() const;
+
+    /**
+    *   Start a deck at a sample of the master clock.
+    *   @param deck the deck to start
+    *   @param time the master clock time, a time that has passed starts it in the next block
+    *   @param source the thread calling, only one thread may use each source
+    *   @param timestamp when the request arrived in Time::getMillisecondCounterHiRes() time,
+    *                    0 if it is not to be counted in the control latency
+    */
+    void scheduleStart(DJAudioPlayer* deck, juce::int64 time = 0,
+                       CommandSource source = messageThread, double timestamp = 0.0);
+
+    /**
+    *   Stop a deck at a sample of the master clock.
+    *   @param deck the deck to stop
+    *   @param time the master clock time, a time that has passed stops it in the next block
+    *   @param source the thread calling, only one thread may use each source
+    *   @param timestamp when the request arrived, 0 if it is not to be counted in the control latency
+    */
+    void scheduleStop(DJAudioPlayer* deck, juce::int64 time = 0,
+                      CommandSource source = messageThread, double timestamp = 0.0);
+
+    /**
+    *   Set a control of a deck at a sample of the master clock.
+    *   @param deck the deck
+    *   @param control the control to set
+    *   @param value the new value, see Control
+    *   @param time the master clock time, a time that has passed sets it in the next block
+    *   @param source the thread calling, only one thread may use each source
+    *   @param timestamp when the request arrived, 0 if it is not to be counted in the control latency
+    */
+    void scheduleControl(DJAudioPlayer* deck, Control control, double value, juce::int64 time = 0,
+                         CommandSource source = messageThread, double timestamp = 0.0);
+
+    /**
+    *   Convert a Time::getMillisecondCounterHiRes() time to the master clock, by the
+    *   time the current block started.
+    *   @param milliseconds the time
+    *   @return the master clock time, which may have passed
+    */
+    juce::int64 getClockTimeAt(double milliseconds) const;
+
+    /**
+    *   Get the time from the arrival of timestamped commands to the audio thread
+    *   rendering their change, in milliseconds. The device output latency comes on top.
+    *   @param average the moving average
+    *   @param maximum the largest since the last reset
+    */
+    void getControlLatency(double& average, double& maximum) const;
+
+    /** start measuring the largest control latency again */
+    void resetControlLatency();
+
+    /**
+    *   Play a deck from its auto-cue point so that its first downbeat lands on the next bar
+    *   of another deck. Starts it in the next block if either deck has no beatgrid
+    *   or the other deck is stopped.
+    *   @param deck the deck to start
+    *   @param reference the deck to start in time with
+    */
+    void startOnNextBar(DJAudioPlayer* deck, DJAudioPlayer* reference);
+
+    /**
+    *   Crossfade from one deck to another at a sample of the master clock. The
+    *   incoming deck starts there and both decks follow equal-power curves; the
+    *   outgoing deck stops when the fade ends.
+    *   @param from the deck to fade out
+    *   @param to the deck to start and fade in
+    *   @param time the master clock time the fade starts at
+    *   @param length the length of the fade in samples
+    */
+    void scheduleCrossfade(DJAudioPlayer* from, DJAudioPlayer* to, juce::int64 time, juce::int64 length);
+
+    /**
+    *   Drop the crossfades queued for a deck, and end one it is in the middle of at full gain.
+    *   A deck waiting to be faded in is not started.
+    *   @param deck the deck
+    */
+    void cancelCrossfade(DJAudioPlayer* deck);
+
+    /**
+    *   Tap the master bus and the deck stems into a recorder.
+    *   @param recorder the recorder, nullptr to remove it; it must outlive the mixer
+    */
+    void setRecorder(SetRecorder* recorder);
+
+    /**
+    *   Mix a bank of sample pads into the master bus. Set it before the device starts.
+    *   @param pads the pads, nullptr to remove them; they must outlive the mixer
+    */
+    void setPadBank(SamplePadBank* pads);
+
+    /**
+    *   Get the insert chain of a deck.
+    *   @param deck the deck
+    *   @return the chain, nullptr if the deck is not on this mixer
+    */
+    PluginChain* getChain(DJAudioPlayer* deck);
+
+    /** get the insert chain of the master bus */
+    PluginChain* getMasterChain();
+
+    /** get the latency the plugins add to the master bus, in samples */
+    int getPluginLatency() const;
+
+    /**
+    *   Get how much of each block's duration the mixer takes to render it, decks
+    *   and plugins included, as a moving average.
+    *   @return 0 to 1, more than 1 if it cannot keep up
+    */
+    double getCpuLoad() const;
+
+    /** get the sample rate of the device */
+    double getSampleRate() const;
+
+    /** get the block size of the device */
+    int getBlockSize() const;
+
+    /** get the number of output channels of the device, known after the first block */
+    int getNumOutputChannels() const;
+
+    /**
+    *   Choose where the cue bus goes.
+    *   @param routing the destination of the cue bus
+    *   @param output the second device for cueOnSecondDevice; it must outlive the mixer
+    */
+    void setCueRouting(CueRouting routing, CueOutput* output = nullptr);
+
+    /**
+    *   Send a deck to the cue bus, or take it off.
+    *   @param deck the deck
+    *   @param enabled true to pre-listen to the deck
+    */
+    void setCueEnabled(DJAudioPlayer* deck, bool enabled);
+
+    /** true if the deck is on the cue bus */
+    bool isCueEnabled(DJAudioPlayer* deck) const;
+
+    /**
+    *   Set the headphone mix.
+    *   @param mix 0 for the cued decks only, 1 for the master only
+    */
+    void setCueMix(double mix);
+
+private:
+    struct ScheduledCommand
+    {
+        enum Type { start, stop, fadeIn, fadeOut, cancelFade, control };
+
+        juce::int64 time = 0;
+        DJAudioPlayer* deck = nullptr;
+        Type type = start;
+        juce::int64 length = 0;
+
+        Control control = gainControl;
+        double value = 0.0;
+        double timestamp = 0.0;
+    };
+
+    // the fader of a deck under a timed crossfade, audio thread only
+    struct DeckFade
+    {
+        enum State { none, fadingIn, fadingOut, silenced };
+
+        State state = none;
+        juce::int64 length = 0;
+        juce::int64 done = 0;
+    };
+
+    /**
+    *   Carry out a command at its time.
+    *   @param offset where in the block the command lands
+    */
+    void perform(const ScheduledCommand& command, int offset);
+
+    /** set a control of a deck, on the audio thread */
+    void performControl(const ScheduledCommand& command);
+
+    /** apply a deck's fade to the block just rendered into its deck buffer */
+    void applyFade(int index, int numSamples);
+
+    /** queue a command for the audio thread */
+    void schedule(const ScheduledCommand& command, CommandSource source = messageThread);
+
+    /** move the queued commands into the pending list, sorted by time */
+    void collectCommands();
+
+    /**
+    *   Render all decks into part of the block.
+    *   @param cue the cue bus channels at the start of the block, or nullptrs
+    */
+    void renderDecks(const juce::AudioSourceChannelInfo& bufferToFill, int offset, int numSamples, float* const* cue);
+
+    /**
+    *   Run the deck chains over the block just rendered, in parallel if more than
+    *   one of them is heavy. Waits for the workers for at most half the slice.
+    */
+    void processChains(int numSamples);
+
+    /** take jobs from the current round of chains until none is left; audio or worker thread */
+    void runChainJobs();
+
+    /**
+    *   Delay a deck's block through its delay line.
+    *   @param index the deck
+    *   @param delay the delay in samples
+    */
+    void compensateLatency(int index, int delay, int numSamples);
+
+    /** blend the master into the cue bus by the cue mix */
+    void mixMasterIntoCue(const juce::AudioSourceChannelInfo& bufferToFill, float* const* cue);
+
+    static constexpr int maxDecks = 8;
+
+    juce::Array<DJAudioPlayer*> decks;
+    juce::AudioBuffer<float> deckBuffers[maxDecks];
+    int maxBlockSize = 0;  // the length of the deck buffers, 0 until prepareToPlay()
+
+    PluginChain chains[maxDecks];
+    PluginChain masterChain;
+
+    // lines up the decks behind the chain with the most latency, audio thread only
+    static constexpr int maxLatencyCompensation = 32768;
+    juce::AudioBuffer<float> delayLines[maxDecks];
+    int delayPositions[maxDecks] = {};
+    int compensatedLatency = 0;
+    std::atomic<int> deckLatency{ 0 };
+
+    // a round of chains run in parallel: the job list is written before nextJob
+    // is reset, and nextJob stays past the end between rounds
+    class ChainWorker;
+    juce::OwnedArray<ChainWorker> workers;
+    int chainJobs[maxDecks] = {};
+    std::atomic<int> numChainJobs{ 0 };
+    int chainJobSamples = 0;
+    std::atomic<int> nextJob;
+    // set while a round has the deck's buffer, cleared when its chain is done;
+    // a deck whose worker is late stays out of the mix until it is back
+    std::atomic<bool> chainBusy[maxDecks];
+
+    std::atomic<juce::int64> masterClock{ 0 };
+    std::atomic<int> blockSize{ 512 };
+    std::atomic<double> deviceSampleRate{ 44100.0 };
+    std::atomic<SetRecorder*> recorder{ nullptr };
+    std::atomic<SamplePadBank*> padBank{ nullptr };
+    std::atomic<int> numOutputChannels{ 2 };
+
+    std::atomic<int> cueRouting{ cueOff };
+    std::atomic<CueOutput*> cueOutput{ nullptr };
+    std::atomic<bool> cueEnabled[maxDecks];
+    DeckFade fades[maxDecks];
+    std::atomic<float> cueMix{ 0.5f };
+    float currentCueMix = 0.5f;
+    juce::AudioBuffer<float> cueBuffer;
+
+    // single producer, single consumer: one queue per source; a controller
+    // streams fader moves, so they are deep enough for a few blocks of those
+    static constexpr int commandQueueSize = 256;
+    struct CommandQueue
+    {
+        juce::AbstractFifo fifo{ commandQueueSize };
+        ScheduledCommand commands[commandQueueSize];
+    };
+    CommandQueue commandQueues[numCommandSources];
+
+    // the master clock and the time at the start of the current block,
+    // the sequence is odd while they are being written
+    std::atomic<juce::uint32> blockSequence{ 0 };
+    std::atomic<juce::int64> blockStartClock{ 0 };
+    std::atomic<double> blockStartTime{ 0.0 };
+
+    // the render time over the block duration, written by the audio thread
+    std::atomic<double> cpuLoad{ 0.0 };
+
+    // control latency in milliseconds, written by the audio thread
+    std::atomic<double> averageLatency{ 0.0 };
+    std::atomic<double> maximumLatency{ 0.0 };
+
+    // commands waiting for their time, audio thread only
+    ScheduledCommand pending[commandQueueSize];
+    int numPending = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckMixer)
+};
@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    KeyAnalyser.cpp
+    Created: 18 Oct 2026 6:14:55pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "KeyAnalyser.h"
+#include <cmath>
+
+namespace
+{
+    // Krumhansl-Kessler key profiles, starting at the tonic
+    const double majorProfile[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+    const double minorProfile[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+    const char* const noteNames[12] = { "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+
+    // the pitch range the chromagram is built from
+    const double lowestPitchHz = 50.0;
+    const double highestPitchHz = 2100.0;
+
+    double correlate(const double* chroma, const double* profile, int tonic)
+    {
+        double chromaMean = 0.0, profileMean = 0.0;
+        for (int i = 0; i < 12; ++i) {
+            chromaMean += chroma[i] / 12.0;
+            profileMean += profile[i] / 12.0;
+        }
+
+        double covariance = 0.0, chromaVariance = 0.0, profileVariance = 0.0;
+        for (int i = 0; i < 12; ++i) {
+            auto c = chroma[(i + tonic) % 12] - chromaMean;
+            auto p = profile[i] - profileMean;
+            covariance += c * p;
+            chromaVariance += c * c;
+            profileVariance += p * p;
+        }
+        return covariance / std::sqrt(chromaVariance * profileVariance + 1.0e-20);
+    }
+}
+
+KeyAnalyser::KeyAnalyser()
+{
+}
+
+KeyAnalyser::~KeyAnalyser()
+{
+}
+
+void KeyAnalyser::prepare(double sampleRate)
+{
+    decimation = juce::jmax(1, (int) (sampleRate / 11025.0));
+    decimationPhase = 0;
+    auto decimatedRate = sampleRate / decimation;
+
+    auto cutoff = 0.4 * decimatedRate;
+    lowPass[0].setCoefficients(juce::IIRCoefficients::makeLowPass(sampleRate, cutoff, 0.5412));
+    lowPass[1].setCoefficients(juce::IIRCoefficients::makeLowPass(sampleRate, cutoff, 1.3065));
+    lowPass[0].reset();
+    lowPass[1].reset();
+
+    frame.assign((size_t) fftSize, 0.0f);
+    frameFill = 0;
+    fftData.assign((size_t) fftSize * 2, 0.0f);
+
+    // the pitch class of every FFT bin inside the pitch range
+    binPitchClass.assign((size_t) fftSize / 2 + 1, -1);
+    for (int bin = 1; bin <= fftSize / 2; ++bin) {
+        auto frequency = bin * decimatedRate / fftSize;
+        if (frequency < lowestPitchHz || frequency > highestPitchHz)
+            continue;
+
+        auto midiNote = juce::roundToInt(69.0 + 12.0 * std::log2(frequency / 440.0));
+        binPitchClass[(size_t) bin] = ((midiNote % 12) + 12) % 12;
+    }
+
+    for (auto& value : chroma)
+        value = 0.0;
+}
+
+void KeyAnalyser::process(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (numSamples > scratchSize) {
+        mono.allocate((size_t) numSamples, false);
+        scratchSize = numSamples;
+    }
+
+    juce::FloatVectorOperations::copy(mono, buffer.getReadPointer(0), numSamples);
+    if (buffer.getNumChannels() > 1) {
+        juce::FloatVectorOperations::add(mono, buffer.getReadPointer(1), numSamples);
+        juce::FloatVectorOperations::multiply(mono, 0.5f, numSamples);
+    }
+
+    lowPass[0].processSamples(mono, numSamples);
+    lowPass[1].processSamples(mono, numSamples);
+
+    for (int i = decimationPhase; i < numSamples; i += decimation) {
+        frame[(size_t) frameFill++] = mono[i];
+
+        if (frameFill == fftSize) {
+            analyseFrame();
+
+            // frames overlap by half
+            std::copy(frame.begin() + hopSize, frame.end(), frame.begin());
+            frameFill = fftSize - hopSize;
+        }
+    }
+    decimationPhase = (decimationPhase + decimation - numSamples % decimation) % decimation;
+}
+
+void KeyAnalyser::analyseFrame()
+{
+    std::copy(frame.begin(), frame.end(), fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    for (size_t bin = 0; bin < binPitchClass.size(); ++bin)
+        if (binPitchClass[bin] >= 0)
+            chroma[binPitchClass[bin]] += fftData[bin];
+}
+
+void KeyAnalyser::finish(TrackAnalysis& analysis)
+{
+    analysis.key = -1;
+
+    double total = 0.0;
+    for (auto value : chroma)
+        total += value;
+    if (total <= 0.0)
+        return;
+
+    double bestCorrelation = -2.0;
+    for (int tonic = 0; tonic < 12; ++tonic) {
+        auto major = correlate(chroma, majorProfile, tonic);
+        auto minor = correlate(chroma, minorProfile, tonic);
+
+        if (major > bestCorrelation) {
+            bestCorrelation = major;
+            analysis.key = tonic;
+        }
+        if (minor > bestCorrelation) {
+            bestCorrelation = minor;
+            analysis.key = 12 + tonic;
+        }
+    }
+}
+
+juce::String KeyAnalyser::getKeyName(int key)
+{
+    if (key < 0 || key >= 24)
+        return "-";
+    return juce::String(noteNames[key % 12]) + (key >= 12 ? "m" : "");
+}
+
+juce::String KeyAnalyser::getCamelotName(int key)
+{
+    if (key < 0 || key >= 24)
+        return "-";
+    return juce::String(getCamelotNumber(key)) + (key >= 12 ? "A" : "B");
+}
+
+bool KeyAnalyser::areCompatible(int key, int otherKey)
+{
+    if (key < 0 || key >= 24 || otherKey < 0 || otherKey >= 24)
+        return false;
+
+    auto number = getCamelotNumber(key), otherNumber = getCamelotNumber(otherKey);
+    bool sameMode = (key >= 12) == (otherKey >= 12);
+
+    // same key or its relative, or one step around the wheel in the same mode
+    if (number == otherNumber)
+        return true;
+    auto steps = (number - otherNumber + 12) % 12;
+    return sameMode && (steps == 1 || steps == 11);
+}
+
+int KeyAnalyser::getCamelotNumber(int key)
+{
+    // minor keys share the number of their relative major
+    auto majorTonic = key >= 12 ? (key - 12 + 3) % 12 : key;
+
+    // a fifth up is one step clockwise, C major is 8B
+    return (majorTonic * 7 + 7) % 12 + 1;
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    KeyAnalyser.h
+    Created: 18 Oct 2026 6:14:55pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Detects the musical key of a track for harmonic mixing.
+
+    The track is downmixed and decimated to around 11 kHz, a chromagram is
+    accumulated from overlapping FFT frames, and the key is the major or minor
+    key profile (Krumhansl-Kessler) that correlates best with it.
+
+    Keys are numbered 0-11 for C major to B major and 12-23 for C minor to
+    B minor, -1 means unknown.
+*/
+class KeyAnalyser
+{
+public:
+    KeyAnalyser();
+    ~KeyAnalyser();
+
+    /**
+    *   Reset the analyser for a new track.
+    *   @param sampleRate the sample rate of the track
+    */
+    void prepare(double sampleRate);
+
+    /**
+    *   Feed the next block of the track.
+    *   @param buffer the decoded audio, one or two channels
+    *   @param numSamples the number of samples to use from the buffer
+    */
+    void process(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    /**
+    *   Pick the key from the chromagram of everything fed so far.
+    *   @param analysis the analysis to fill in
+    */
+    void finish(TrackAnalysis& analysis);
+
+    /** get the name of a key, e.g. "Am" */
+    static juce::String getKeyName(int key);
+
+    /** get the Camelot wheel notation of a key, e.g. "8A" */
+    static juce::String getCamelotName(int key);
+
+    /**
+    *   Check if two keys mix well: the same key, the relative major/minor,
+    *   or a neighbour on the Camelot wheel.
+    *   @return true if both keys are known and compatible
+    */
+    static bool areCompatible(int key, int otherKey);
+
+private:
+    void analyseFrame();
+
+    static int getCamelotNumber(int key);
+
+    static constexpr int fftOrder = 13;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann };
+
+    // anti-aliasing filter in front of the decimation, a 4th order Butterworth
+    juce::IIRFilter lowPass[2];
+    int decimation = 4;
+    int decimationPhase = 0;
+
+    juce::HeapBlock<float> mono;
+    int scratchSize = 0;
+
+    std::vector<float> frame;
+    int frameFill = 0;
+    std::vector<float> fftData;
+    std::vector<int> binPitchClass;
+
+    double chroma[12] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyAnalyser)
+};
@@ -0,0 +1,438 @@
+/*
+  ==============================================================================
+
+    LibraryIndex.cpp
+    Created: 18 Oct 2026 1:05:12pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "LibraryIndex.h"
+#include "AppData.h"
+
+LibraryIndex::LibraryIndex(juce::File _indexFile) : indexFile(_indexFile)
+{
+}
+
+LibraryIndex::~LibraryIndex()
+{
+}
+
+void LibraryIndex::load()
+{
+    entries.clear();
+    titles.clear();
+    crates.clear();
+    nextTrackId = 1;
+    dirty = false;
+
+    if (!indexFile.existsAsFile())
+        return;
+
+    auto xml = juce::parseXML(indexFile);
+    if (xml == nullptr || !xml->hasTagName("LIBRARY")) {
+        std::cout << "LibraryIndex::load could not parse " << indexFile.getFullPathName() << std::endl;
+        return;
+    }
+
+    for (auto* track : xml->getChildWithTagNameIterator("TRACK")) {
+        Entry entry;
+        entry.id = track->getIntAttribute("id");
+        entry.modified = track->getStringAttribute("modified").getLargeIntValue();
+        entry.version = track->getIntAttribute("version", 1);
+        entry.analysis.bpm = track->getDoubleAttribute("bpm");
+        entry.analysis.downbeatOffset = track->getDoubleAttribute("downbeat");
+        entry.analysis.loudness = track->getDoubleAttribute("loudness");
+        entry.analysis.truePeak = track->getDoubleAttribute("truePeak");
+        entry.analysis.key = track->getIntAttribute("key", -1);
+        entry.analysis.autoCue = track->getDoubleAttribute("autoCue");
+        entry.analysis.autoEnd = track->getDoubleAttribute("autoEnd");
+        entry.tags.artist = track->getStringAttribute("artist");
+        entry.tags.album = track->getStringAttribute("album");
+        entry.tags.genre = track->getStringAttribute("genre");
+        entry.tags.sampleRate = track->getDoubleAttribute("sampleRate");
+        entry.tags.numChannels = track->getIntAttribute("channels");
+        entry.tags.bitrate = track->getIntAttribute("bitrate");
+
+        // lengths stored before the tags were read are read again, with the tags
+        entry.length = entry.tags.sampleRate > 0.0 ? track->getDoubleAttribute("length", -1.0) : -1.0;
+        for (auto& cue : juce::StringArray::fromTokens(track->getStringAttribute("hotCues"), false))
+            entry.hotCues.add(cue.getDoubleValue());
+        entries[track->getStringAttribute("title")] = entry;
+        nextTrackId = juce::jmax(nextTrackId, entry.id + 1);
+    }
+
+    // entries written before tracks had ids get new ones
+    for (auto& item : entries) {
+        if (item.second.id <= 0 || titles.count(item.second.id) > 0) {
+            item.second.id = nextTrackId++;
+            dirty = true;
+        }
+        titles[item.second.id] = item.first;
+    }
+
+    for (auto* element : xml->getChildWithTagNameIterator("CRATE")) {
+        Crate crate;
+        crate.name = element->getStringAttribute("name");
+        crate.smart = element->getBoolAttribute("smart");
+        for (auto& id : juce::StringArray::fromTokens(element->getStringAttribute("tracks"), false))
+            crate.trackIds.add(id.getIntValue());
+        crate.keyword = element->getStringAttribute("keyword");
+        crate.minBpm = element->getDoubleAttribute("minBpm");
+        crate.maxBpm = element->getDoubleAttribute("maxBpm");
+        crate.minLength = element->getDoubleAttribute("minLength");
+        crate.maxLength = element->getDoubleAttribute("maxLength");
+        crates.push_back(crate);
+    }
+}
+
+void LibraryIndex::save()
+{
+    juce::XmlElement xml("LIBRARY");
+
+    for (auto& item : entries) {
+        auto* track = xml.createNewChildElement("TRACK");
+        track->setAttribute("title", item.first);
+        track->setAttribute("id", item.second.id);
+        track->setAttribute("modified", juce::String(item.second.modified));
+        track->setAttribute("version", item.second.version);
+        track->setAttribute("bpm", item.second.analysis.bpm);
+        track->setAttribute("downbeat", item.second.analysis.downbeatOffset);
+        track->setAttribute("loudness", item.second.analysis.loudness);
+        track->setAttribute("truePeak", item.second.analysis.truePeak);
+        track->setAttribute("key", item.second.analysis.key);
+        track->setAttribute("autoCue", item.second.analysis.autoCue);
+        track->setAttribute("autoEnd", item.second.analysis.autoEnd);
+        if (item.second.length >= 0.0)
+            track->setAttribute("length", item.second.length);
+
+        // the tags the file has, and its format once it has been read
+        auto& tags = item.second.tags;
+        if (tags.artist.isNotEmpty())
+            track->setAttribute("artist", tags.artist);
+        if (tags.album.isNotEmpty())
+            track->setAttribute("album", tags.album);
+        if (tags.genre.isNotEmpty())
+            track->setAttribute("genre", tags.genre);
+        if (tags.sampleRate > 0.0) {
+            track->setAttribute("sampleRate", tags.sampleRate);
+            track->setAttribute("channels", tags.numChannels);
+            track->setAttribute("bitrate", tags.bitrate);
+        }
+
+        if (!item.second.hotCues.isEmpty()) {
+            juce::StringArray cues;
+            for (auto cue : item.second.hotCues)
+                cues.add(juce::String(cue));
+            track->setAttribute("hotCues", cues.joinIntoString(" "));
+        }
+    }
+
+    // a crate is a list of track ids, a smart crate only its filter
+    for (auto& crate : crates) {
+        auto* element = xml.createNewChildElement("CRATE");
+        element->setAttribute("name", crate.name);
+        if (crate.smart) {
+            element->setAttribute("smart", true);
+            element->setAttribute("keyword", crate.keyword);
+            element->setAttribute("minBpm", crate.minBpm);
+            element->setAttribute("maxBpm", crate.maxBpm);
+            element->setAttribute("minLength", crate.minLength);
+            element->setAttribute("maxLength", crate.maxLength);
+        }
+        else {
+            juce::StringArray ids;
+            for (auto id : crate.trackIds)
+                ids.add(juce::String(id));
+            element->setAttribute("tracks", ids.joinIntoString(" "));
+        }
+    }
+
+    if (xml.writeTo(indexFile))
+        dirty = false;
+    else
+        std::cout << "LibraryIndex::save could not write " << indexFile.getFullPathName() << std::endl;
+}
+
+bool LibraryIndex::needsSaving() const
+{
+    return dirty;
+}
+
+void LibraryIndex::swapWith(LibraryIndex& other)
+{
+    entries.swap(other.entries);
+    titles.swap(other.titles);
+    crates.swap(other.crates);
+    std::swap(nextTrackId, other.nextTrackId);
+    std::swap(dirty, other.dirty);
+}
+
+bool LibraryIndex::hasAnalysis(const juce::File& trackFile) const
+{
+    auto found = entries.find(trackFile.getFileName());
+    return found != entries.end()
+        && found->second.modified == trackFile.getLastModificationTime().toMilliseconds()
+        && found->second.version == analysisVersion;
+}
+
+bool LibraryIndex::isAnalysed(const juce::File& trackFile) const
+{
+    auto found = entries.find(trackFile.getFileName());
+    return found != entries.end()
+        && found->second.checked
+        && found->second.version == analysisVersion;
+}
+
+TrackAnalysis LibraryIndex::getAnalysis(const juce::File& trackFile) const
+{
+    auto found = entries.find(trackFile.getFileName());
+    return found != entries.end() ? found->second.analysis : TrackAnalysis();
+}
+
+void LibraryIndex::setAnalysis(const juce::File& trackFile, const TrackAnalysis& analysis)
+{
+    auto& entry = getEntry(trackFile);
+    auto modified = trackFile.getLastModificationTime().toMilliseconds();
+    if (entry.modified != modified)
+        entry.length = -1.0;
+    entry.modified = modified;
+    entry.checked = true;
+    entry.version = analysisVersion;
+    entry.analysis = analysis;
+    dirty = true;
+}
+
+juce::Array<double> LibraryIndex::getHotCues(const juce::File& trackFile) const
+{
+    auto found = entries.find(trackFile.getFileName());
+    return found != entries.end() ? found->second.hotCues : juce::Array<double>();
+}
+
+void LibraryIndex::setHotCues(const juce::File& trackFile, const juce::Array<double>& hotCues)
+{
+    // a new entry stays unanalysed until setAnalysis() fills it in
+    auto& entry = getEntry(trackFile);
+    if (entry.modified == 0)
+        entry.modified = trackFile.getLastModificationTime().toMilliseconds();
+    entry.hotCues = hotCues;
+    dirty = true;
+}
+
+bool LibraryIndex::hasLength(const juce::File& trackFile)
+{
+    auto found = entries.find(trackFile.getFileName());
+    if (found == entries.end())
+        return false;
+
+    auto& entry = found->second;
+    entry.checked = entry.modified == trackFile.getLastModificationTime().toMilliseconds();
+
+    // a re-encoded or replaced file keeps nothing read from the old one
+    if (!entry.checked && (entry.length >= 0.0 || entry.version != 0)) {
+        entry.length = -1.0;
+        entry.tags = TrackTags();
+        entry.version = 0;
+        entry.analysis = TrackAnalysis();
+        dirty = true;
+    }
+    return entry.checked && entry.length >= 0.0;
+}
+
+double LibraryIndex::getLength(const juce::File& trackFile) const
+{
+    auto found = entries.find(trackFile.getFileName());
+    return found != entries.end() ? found->second.length : -1.0;
+}
+
+void LibraryIndex::setLength(const juce::File& trackFile, double seconds)
+{
+    auto& entry = getEntry(trackFile);
+    auto modified = trackFile.getLastModificationTime().toMilliseconds();
+
+    // the file has changed since the entry was made, so its analysis is out of date too
+    if (entry.modified != modified) {
+        entry.modified = modified;
+        entry.version = 0;
+    }
+    entry.checked = true;
+    entry.length = seconds;
+    dirty = true;
+}
+
+TrackTags LibraryIndex::getTags(const juce::File& trackFile) const
+{
+    auto found = entries.find(trackFile.getFileName());
+    return found != entries.end() ? found->second.tags : TrackTags();
+}
+
+void LibraryIndex::setTags(const juce::File& trackFile, const TrackTags& tags)
+{
+    // called right after setLength(), which brings the entry up to date with the file
+    getEntry(trackFile).tags = tags;
+    dirty = true;
+}
+
+int LibraryIndex::getTrackId(const juce::File& trackFile)
+{
+    return getEntry(trackFile).id;
+}
+
+juce::String LibraryIndex::getTitle(int trackId) const
+{
+    auto found = titles.find(trackId);
+    return found != titles.end() ? found->second : juce::String();
+}
+
+double LibraryIndex::getLength(int trackId) const
+{
+    auto found = titles.find(trackId);
+    return found != titles.end() ? entries.at(found->second).length : -1.0;
+}
+
+TrackTags LibraryIndex::getTags(int trackId) const
+{
+    auto found = titles.find(trackId);
+    return found != titles.end() ? entries.at(found->second).tags : TrackTags();
+}
+
+int LibraryIndex::getNumCrates() const
+{
+    return (int) crates.size();
+}
+
+Crate LibraryIndex::getCrate(int index) const
+{
+    return juce::isPositiveAndBelow(index, getNumCrates()) ? crates[(size_t) index] : Crate();
+}
+
+int LibraryIndex::addCrate(const Crate& crate)
+{
+    crates.push_back(crate);
+    dirty = true;
+    return getNumCrates() - 1;
+}
+
+void LibraryIndex::setCrate(int index, const Crate& crate)
+{
+    if (!juce::isPositiveAndBelow(index, getNumCrates())) {
+        std::cout << "LibraryIndex::setCrate index should be between 0 and " << getNumCrates() - 1 << std::endl;
+        return;
+    }
+    crates[(size_t) index] = crate;
+    dirty = true;
+}
+
+void LibraryIndex::removeCrate(int index)
+{
+    if (!juce::isPositiveAndBelow(index, getNumCrates())) {
+        std::cout << "LibraryIndex::removeCrate index should be between 0 and " << getNumCrates() - 1 << std::endl;
+        return;
+    }
+    crates.erase(crates.begin() + index);
+    dirty = true;
+}
+
+void LibraryIndex::addToCrate(int index, const juce::Array<int>& trackIds)
+{
+    if (!juce::isPositiveAndBelow(index, getNumCrates()) || crates[(size_t) index].smart) {
+        std::cout << "LibraryIndex::addToCrate index should be a crate which is not smart" << std::endl;
+        return;
+    }
+    for (auto id : trackIds)
+        crates[(size_t) index].trackIds.addIfNotAlreadyThere(id);
+    dirty = true;
+}
+
+void LibraryIndex::removeFromCrate(int index, const juce::Array<int>& trackIds)
+{
+    if (!juce::isPositiveAndBelow(index, getNumCrates()) || crates[(size_t) index].smart) {
+        std::cout << "LibraryIndex::removeFromCrate index should be a crate which is not smart" << std::endl;
+        return;
+    }
+    crates[(size_t) index].trackIds.removeValuesIn(trackIds);
+    dirty = true;
+}
+
+void LibraryIndex::moveInCrate(int index, const juce::SparseSet<int>& positions, int insertPosition)
+{
+    if (!juce::isPositiveAndBelow(index, getNumCrates()) || crates[(size_t) index].smart) {
+        std::cout << "LibraryIndex::moveInCrate index should be a crate which is not smart" << std::endl;
+        return;
+    }
+
+    auto& trackIds = crates[(size_t) index].trackIds;
+    juce::Array<int> moved, kept;
+    int keptBeforeInsert = 0;
+    for (int i = 0; i < trackIds.size(); ++i) {
+        if (positions.contains(i)) {
+            moved.add(trackIds[i]);
+        }
+        else {
+            kept.add(trackIds[i]);
+            if (i < insertPosition)
+                ++keptBeforeInsert;
+        }
+    }
+
+    kept.insertArray(keptBeforeInsert, moved.getRawDataPointer(), moved.size());
+    trackIds.swapWith(kept);
+    dirty = true;
+}
+
+juce::Array<int> LibraryIndex::getCrateTracks(int index) const
+{
+    if (!juce::isPositiveAndBelow(index, getNumCrates()))
+        return {};
+
+    auto& crate = crates[(size_t) index];
+    if (!crate.smart)
+        return crate.trackIds;
+
+    juce::Array<int> trackIds;
+    for (auto& item : entries)
+        if (matchesFilter(crate, item.first, item.second))
+            trackIds.add(item.second.id);
+    return trackIds;
+}
+
+juce::File LibraryIndex::getDefaultIndexFile()
+{
+    // the Tracks folder only holds audio files, the index goes with the app's own files
+    return AppData::getFile("library.xml");
+}
+
+LibraryIndex::Entry& LibraryIndex::getEntry(const juce::File& trackFile)
+{
+    auto title = trackFile.getFileName();
+    auto& entry = entries[title];
+    if (entry.id == 0) {
+        entry.id = nextTrackId++;
+        titles[entry.id] = title;
+    }
+    return entry;
+}
+
+bool LibraryIndex::matchesFilter(const Crate& crate, const juce::String& title, const Entry& entry) const
+{
+    // the file is gone or was not checked against its entry
+    if (!entry.checked)
+        return false;
+
+    auto& tags = entry.tags;
+    if (crate.keyword.isNotEmpty() && !title.containsIgnoreCase(crate.keyword) && !tags.artist.containsIgnoreCase(crate.keyword)
+        && !tags.album.containsIgnoreCase(crate.keyword) && !tags.genre.containsIgnoreCase(crate.keyword))
+        return false;
+
+    // a track which is not analysed, or whose length is not known, only passes without a limit
+    auto bpm = entry.version == analysisVersion ? entry.analysis.bpm : 0.0;
+    if ((crate.minBpm > 0.0 && bpm < crate.minBpm) || (crate.maxBpm > 0.0 && (bpm <= 0.0 || bpm > crate.maxBpm)))
+        return false;
+
+    auto length = entry.length;
+    if ((crate.minLength > 0.0 && length < crate.minLength) || (crate.maxLength > 0.0 && (length < 0.0 || length > crate.maxLength)))
+        return false;
+
+    return true;
+}
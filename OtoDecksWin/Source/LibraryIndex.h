@@ -0,0 +1,324 @@
+/*
+  ==============================================================================
+
+    LibraryIndex.h
+    Created: 18 Oct 2026 1:05:12pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <vector>
+
+//==============================================================================
+/*
+    The results of the background analysis of one track.
+*/
+struct TrackAnalysis
+{
+    /** tempo in beats per minute, 0 if no tempo was found */
+    double bpm = 0.0;
+
+    /** position of the first downbeat in seconds, the beatgrid starts here */
+    double downbeatOffset = 0.0;
+
+    /** integrated loudness in LUFS (EBU R128), 0 if it could not be measured */
+    double loudness = 0.0;
+
+    /** true peak in dBTP */
+    double truePeak = 0.0;
+
+    /** musical key, 0-11 for C to B major, 12-23 for C to B minor, -1 if unknown */
+    int key = -1;
+
+    /** position of the first audible sample in seconds, where PLAY and automix start */
+    double autoCue = 0.0;
+
+    /** position just after the last audible sample in seconds, 0 if unknown */
+    double autoEnd = 0.0;
+};
+
+//==============================================================================
+/*
+    The tags and the format of one track, read from the file together with its length.
+*/
+struct TrackTags
+{
+    /** from the ID3, Vorbis comment or RIFF INFO tags, empty if the file has none */
+    juce::String artist;
+    juce::String album;
+    juce::String genre;
+
+    /** sample rate in Hz, 0 if the file has not been read */
+    double sampleRate = 0.0;
+
+    int numChannels = 0;
+
+    /** average bitrate in kbit/s, the file size over the length */
+    int bitrate = 0;
+};
+
+//==============================================================================
+/*
+    A crate of the user's: a list of tracks in play order, or for a smart crate
+    a saved filter whose tracks are worked out from the index when it is shown.
+*/
+struct Crate
+{
+    juce::String name;
+
+    /** true if the tracks are the ones matching the filter below */
+    bool smart = false;
+
+    /** the ids of the tracks in play order, for a crate which is not smart */
+    juce::Array<int> trackIds;
+
+    /** the filter of a smart crate, text in the title, artist, album or genre; an empty one matches every track */
+    juce::String keyword;
+
+    /** tempo range in beats per minute, 0 for no limit */
+    double minBpm = 0.0;
+    double maxBpm = 0.0;
+
+    /** length range in seconds, 0 for no limit */
+    double minLength = 0.0;
+    double maxLength = 0.0;
+};
+
+//==============================================================================
+/*
+    Metadata of the tracks in the library which is too expensive to compute on
+    every start, persisted next to the Tracks folder. Entries are keyed by the
+    file name; when the file has changed on disk the entry loses its length,
+    tags and analysis, and keeps its number and hot cues. Every entry has a
+    number which stays the same, so the crates can refer to tracks by it.
+
+    Only used from the message thread, except for a separate instance which
+    is loaded on a background thread and then swapped in.
+*/
+class LibraryIndex
+{
+public:
+    LibraryIndex(juce::File indexFile);
+    ~LibraryIndex();
+
+    /** R2E: restore the index written by a previous session */
+    void load();
+
+    /** write the index to disk */
+    void save();
+
+    /** true if there are changes which are not written to disk yet */
+    bool needsSaving() const;
+
+    /**
+    *   Exchange the entries with another index, so one loaded on a background thread can be taken over.
+    *   @param other the index to exchange the entries with
+    */
+    void swapWith(LibraryIndex& other);
+
+    /**
+    *   Check if an up to date analysis of the track exists.
+    *   @param trackFile the track file
+    *   @return true if the track has been analysed since it was last modified
+    */
+    bool hasAnalysis(const juce::File& trackFile) const;
+
+    /**
+    *   Check if an up to date analysis of the track exists, without looking at the file:
+    *   trusts the check made by hasLength() when the library was loaded. For painting and sorting.
+    *   @param trackFile the track file
+    *   @return true if the track had been analysed when it was last checked, or has been since
+    */
+    bool isAnalysed(const juce::File& trackFile) const;
+
+    /**
+    *   Get the analysis of a track.
+    *   @param trackFile the track file
+    *   @return the analysis, or a default one if the track is not analysed yet
+    */
+    TrackAnalysis getAnalysis(const juce::File& trackFile) const;
+
+    /**
+    *   Store the analysis of a track.
+    *   @param trackFile the track file
+    *   @param analysis the analysis results
+    */
+    void setAnalysis(const juce::File& trackFile, const TrackAnalysis& analysis);
+
+    /**
+    *   Get the hot cues of a track, which the user sets on the decks.
+    *   @param trackFile the track file
+    *   @return the cue positions in seconds, negative for an empty slot
+    */
+    juce::Array<double> getHotCues(const juce::File& trackFile) const;
+
+    /**
+    *   Store the hot cues of a track. They are kept when the track is analysed again.
+    *   @param trackFile the track file
+    *   @param hotCues the cue positions in seconds, negative for an empty slot
+    */
+    void setHotCues(const juce::File& trackFile, const juce::Array<double>& hotCues);
+
+    /**
+    *   Check if the length of a track is known since it was last modified.
+    *   Whether the entry is up to date with the file is remembered for isAnalysed() and
+    *   the smart crates; an entry whose file has changed loses its length, tags and analysis.
+    *   @param trackFile the track file
+    *   @return true if getLength() can be used instead of opening the file
+    */
+    bool hasLength(const juce::File& trackFile);
+
+    /**
+    *   Get the length of a track, without opening the file.
+    *   @param trackFile the track file
+    *   @return the length in seconds, negative if unknown
+    */
+    double getLength(const juce::File& trackFile) const;
+
+    /**
+    *   Store the length of a track, read from the file.
+    *   @param trackFile the track file
+    *   @param seconds the length in seconds
+    */
+    void setLength(const juce::File& trackFile, double seconds);
+
+    /**
+    *   Get the tags and the format of a track, without opening the file.
+    *   @param trackFile the track file
+    *   @return the tags, with a sample rate of 0 if the file has not been read
+    */
+    TrackTags getTags(const juce::File& trackFile) const;
+
+    /**
+    *   Store the tags and the format of a track, read from the file with its length.
+    *   hasLength() covers them too, since both are stored from the same read.
+    *   @param trackFile the track file
+    *   @param tags the tags and the format
+    */
+    void setTags(const juce::File& trackFile, const TrackTags& tags);
+
+    /**
+    *   Get the number of a track, giving it one if it has none yet.
+    *   @param trackFile the track file
+    *   @return the track id, which is never 0
+    */
+    int getTrackId(const juce::File& trackFile);
+
+    /**
+    *   Get the file name of a track from its number.
+    *   @param trackId the track id
+    *   @return the file name in the Tracks folder, empty if there is no such track
+    */
+    juce::String getTitle(int trackId) const;
+
+    /**
+    *   Get the length of a track from its number, as last stored; the file is not looked at.
+    *   @param trackId the track id
+    *   @return the length in seconds, negative if unknown
+    */
+    double getLength(int trackId) const;
+
+    /**
+    *   Get the tags and the format of a track from its number, as last stored; the file is not looked at.
+    *   @param trackId the track id
+    *   @return the tags, with a sample rate of 0 if the file has not been read
+    */
+    TrackTags getTags(int trackId) const;
+
+    /** get the number of crates */
+    int getNumCrates() const;
+
+    /**
+    *   Get a crate.
+    *   @param index the crate, 0 to getNumCrates() - 1
+    *   @return the crate, or an empty one for an index out of range
+    */
+    Crate getCrate(int index) const;
+
+    /**
+    *   Add a crate after the others.
+    *   @param crate the crate to be added
+    *   @return the index of the new crate
+    */
+    int addCrate(const Crate& crate);
+
+    /**
+    *   Replace a crate, e.g. to rename it or to change its filter.
+    *   @param index the crate, 0 to getNumCrates() - 1
+    *   @param crate the new contents
+    */
+    void setCrate(int index, const Crate& crate);
+
+    /** delete a crate, the tracks stay in the library */
+    void removeCrate(int index);
+
+    /**
+    *   Add tracks to the end of a crate which is not smart, skipping the ones already in it.
+    *   @param index the crate, 0 to getNumCrates() - 1
+    *   @param trackIds the tracks to be added
+    */
+    void addToCrate(int index, const juce::Array<int>& trackIds);
+
+    /**
+    *   Take tracks out of a crate which is not smart.
+    *   @param index the crate, 0 to getNumCrates() - 1
+    *   @param trackIds the tracks to be taken out
+    */
+    void removeFromCrate(int index, const juce::Array<int>& trackIds);
+
+    /**
+    *   Move tracks of a crate which is not smart, keeping their order, e.g. after a drag.
+    *   @param index the crate, 0 to getNumCrates() - 1
+    *   @param positions the positions of the tracks being moved
+    *   @param insertPosition the position they are dropped at, counted before the move
+    */
+    void moveInCrate(int index, const juce::SparseSet<int>& positions, int insertPosition);
+
+    /**
+    *   Get the tracks of a crate, in play order; for a smart crate the ones which match its filter, by title.
+    *   Only the index is used, the Tracks folder is not looked at: a smart crate only takes the
+    *   tracks hasLength() found up to date when the library was loaded.
+    *   @param index the crate, 0 to getNumCrates() - 1
+    *   @return the track ids
+    */
+    juce::Array<int> getCrateTracks(int index) const;
+
+    /** the index file used by the application */
+    static juce::File getDefaultIndexFile();
+
+    /** bumped whenever the analysis gains a field, so older entries get analysed again */
+    static constexpr int analysisVersion = 4;
+
+private:
+    struct Entry
+    {
+        int id = 0;
+        juce::int64 modified = 0;
+        int version = 0;
+        double length = -1.0;
+        bool checked = false;  // modified was last found to match the file, not persisted
+        TrackTags tags;
+        TrackAnalysis analysis;
+        juce::Array<double> hotCues;
+    };
+
+    /** get the entry of a track, adding one with a new id if there is none */
+    Entry& getEntry(const juce::File& trackFile);
+
+    /** check a track against the filter of a smart crate */
+    bool matchesFilter(const Crate& crate, const juce::String& title, const Entry& entry) const;
+
+    juce::File indexFile;
+    std::map<juce::String, Entry> entries;
+    std::map<int, juce::String> titles;  // the key of the entry with each id
+    int nextTrackId = 1;
+    std::vector<Crate> crates;
+    bool dirty = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryIndex)
+};
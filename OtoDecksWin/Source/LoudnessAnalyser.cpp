@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.cpp
+    Created: 18 Oct 2026 4:38:09pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "LoudnessAnalyser.h"
+#include <cmath>
+
+namespace
+{
+    // BS.1770 gates
+    const double absoluteGate = -70.0;
+    const double relativeGate = -10.0;
+
+    double toLoudness(double meanSquare)
+    {
+        return -0.691 + 10.0 * std::log10(meanSquare);
+    }
+}
+
+LoudnessAnalyser::LoudnessAnalyser()
+{
+}
+
+LoudnessAnalyser::~LoudnessAnalyser()
+{
+}
+
+void LoudnessAnalyser::prepare(double _sampleRate, int _numChannels)
+{
+    sampleRate = _sampleRate;
+    numChannels = juce::jlimit(1, maxChannels, _numChannels);
+
+    // the K-weighting filters of BS.1770, derived for any sample rate
+    {
+        auto f0 = 1681.974450955533, gain = 3.999843853973347, q = 0.7071752369554196;
+        auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        auto vh = std::pow(10.0, gain / 20.0);
+        auto vb = std::pow(vh, 0.4996667741545416);
+        auto a0 = 1.0 + k / q + k * k;
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        auto f0 = 38.13547087602444, q = 0.5003270373238773;
+        auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        auto a0 = 1.0 + k / q + k * k;
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    for (int channel = 0; channel < maxChannels; ++channel)
+        shelfZ1[channel] = shelfZ2[channel] = highPassZ1[channel] = highPassZ2[channel] = 0.0;
+
+    stepSize = juce::jmax(1, juce::roundToInt(sampleRate / 10.0));
+    stepFill = 0;
+    stepEnergy = 0.0;
+    stepEnergies.clear();
+
+    // windowed sinc interpolator, phase 0 passes the original samples through
+    for (int phase = 0; phase < oversampling; ++phase) {
+        auto centre = tapsPerPhase / 2 - 1 + (double) phase / oversampling;
+        double sum = 0.0;
+        for (int tap = 0; tap < tapsPerPhase; ++tap) {
+            auto x = tap - centre;
+            auto sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            auto window = 0.5 * (1.0 + std::cos(juce::MathConstants<double>::pi * x / (tapsPerPhase / 2)));
+            interpolator[phase][tap] = (float) (sinc * window);
+            sum += sinc * window;
+        }
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+            interpolator[phase][tap] = (float) (interpolator[phase][tap] / sum);
+    }
+    for (auto& channelHistory : history)
+        for (auto& sample : channelHistory)
+            sample = 0.0f;
+    historyPos = 0;
+    truePeak = 0.0f;
+}
+
+void LoudnessAnalyser::process(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    const float* input[maxChannels] = { buffer.getReadPointer(0),
+                                        buffer.getReadPointer(numChannels > 1 ? 1 : 0) };
+    const double weight[maxChannels] = { 1.0, numChannels > 1 ? 1.0 : 0.0 };
+
+    for (int i = 0; i < numSamples; ++i) {
+        double energy = 0.0;
+
+        // fixed trip count, so both channels go through the filters as one vector
+        for (int channel = 0; channel < maxChannels; ++channel) {
+            double x = input[channel][i];
+
+            auto y = shelf.b0 * x + shelfZ1[channel];
+            shelfZ1[channel] = shelf.b1 * x - shelf.a1 * y + shelfZ2[channel];
+            shelfZ2[channel] = shelf.b2 * x - shelf.a2 * y;
+
+            auto z = highPass.b0 * y + highPassZ1[channel];
+            highPassZ1[channel] = highPass.b1 * y - highPass.a1 * z + highPassZ2[channel];
+            highPassZ2[channel] = highPass.b2 * y - highPass.a2 * z;
+
+            energy += weight[channel] * z * z;
+        }
+
+        stepEnergy += energy;
+        if (++stepFill == stepSize) {
+            stepEnergies.push_back(stepEnergy / stepSize);
+            stepEnergy = 0.0;
+            stepFill = 0;
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            updateTruePeak(channel, input[channel][i]);
+        historyPos = (historyPos + 1) % tapsPerPhase;
+    }
+}
+
+void LoudnessAnalyser::updateTruePeak(int channel, float sample)
+{
+    // written twice, so the last tapsPerPhase samples are always contiguous
+    auto* channelHistory = history[channel];
+    channelHistory[historyPos] = channelHistory[historyPos + tapsPerPhase] = sample;
+    auto* window = channelHistory + historyPos + 1;
+
+    for (int phase = 0; phase < oversampling; ++phase) {
+        float y = 0.0f;
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+            y += interpolator[phase][tap] * window[tap];
+        truePeak = juce::jmax(truePeak, std::abs(y));
+    }
+}
+
+void LoudnessAnalyser::finish(TrackAnalysis& analysis)
+{
+    analysis.loudness = 0.0;
+    analysis.truePeak = 0.0;
+
+    if (stepEnergies.size() < 4)
+        return;
+
+    // 400 ms gating blocks overlapping by 75%
+    std::vector<double> blocks;
+    blocks.reserve(stepEnergies.size());
+    for (size_t i = 0; i + 4 <= stepEnergies.size(); ++i)
+        blocks.push_back(0.25 * (stepEnergies[i] + stepEnergies[i + 1] + stepEnergies[i + 2] + stepEnergies[i + 3]));
+
+    auto gatedMean = [&blocks](double threshold) {
+        double sum = 0.0;
+        int count = 0;
+        for (auto block : blocks) {
+            if (block > 0.0 && toLoudness(block) > threshold) {
+                sum += block;
+                ++count;
+            }
+        }
+        return count > 0 ? sum / count : 0.0;
+    };
+
+    auto absoluteMean = gatedMean(absoluteGate);
+    if (absoluteMean <= 0.0)
+        return;
+
+    auto threshold = juce::jmax(absoluteGate, toLoudness(absoluteMean) + relativeGate);
+    auto relativeMean = gatedMean(threshold);
+    if (relativeMean <= 0.0)
+        return;
+
+    analysis.loudness = toLoudness(relativeMean);
+    analysis.truePeak = juce::Decibels::gainToDecibels((double) truePeak, -100.0);
+}
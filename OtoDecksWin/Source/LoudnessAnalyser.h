@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.h
+    Created: 18 Oct 2026 4:38:09pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Measures the integrated loudness (EBU R128 / ITU-R BS.1770) and the true
+    peak of a track.
+
+    The K-weighting filters run on both channels in the same loop, with the
+    filter state laid out per channel, so the two channels share one vector
+    register. The true peak is the highest sample of a 4x oversampled signal.
+*/
+class LoudnessAnalyser
+{
+public:
+    LoudnessAnalyser();
+    ~LoudnessAnalyser();
+
+    /**
+    *   Reset the analyser for a new track.
+    *   @param sampleRate the sample rate of the track
+    *   @param numChannels 1 for mono tracks, otherwise the first two channels are measured
+    */
+    void prepare(double sampleRate, int numChannels);
+
+    /**
+    *   Feed the next block of the track.
+    *   @param buffer the decoded audio, with at least numChannels channels
+    *   @param numSamples the number of samples to use from the buffer
+    */
+    void process(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    /**
+    *   Compute the gated integrated loudness and the true peak of everything fed so far.
+    *   @param analysis the analysis to fill in
+    */
+    void finish(TrackAnalysis& analysis);
+
+private:
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    void updateTruePeak(int channel, float sample);
+
+    static constexpr int maxChannels = 2;
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+
+    // K-weighting: a high shelf followed by a high pass, state per channel
+    Biquad shelf, highPass;
+    double shelfZ1[maxChannels] = {}, shelfZ2[maxChannels] = {};
+    double highPassZ1[maxChannels] = {}, highPassZ2[maxChannels] = {};
+
+    // energy of every 100 ms step, the gating blocks are four steps long
+    int stepSize = 4410;
+    int stepFill = 0;
+    double stepEnergy = 0.0;
+    std::vector<double> stepEnergies;
+
+    // polyphase interpolator for the true peak
+    float interpolator[oversampling][tapsPerPhase] = {};
+    float history[maxChannels][2 * tapsPerPhase] = {};
+    int historyPos = 0;
+    float truePeak = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessAnalyser)
+};
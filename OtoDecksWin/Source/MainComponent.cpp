@@ -1,99 +1,389 @@
-#include "MainComponent.h"
-
-//==============================================================================
-MainComponent::MainComponent()
-{
-    // Make sure you set the size of the component after
-    // you add any child components.
-
-    // Some platforms require permissions to open input channels so request that here
-    if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
-        && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
-    {
-        juce::RuntimePermissions::request (juce::RuntimePermissions::recordAudio,
-                                           [&] (bool granted) { setAudioChannels (granted ? 2 : 0, 2); });
-    }
-    else
-    {
-        // Specify the number of input and output channels that we want to open
-        setAudioChannels (0, 2);
-    }
-    setSize(800, 600);
-    addAndMakeVisible(deckGUI1);
-    addAndMakeVisible(deckGUI2);
-    addAndMakeVisible(playlistComponent);
-
-    formatManager.registerBasicFormats();
-}
-
-MainComponent::~MainComponent()
-{
-    // This shuts down the audio device and clears the audio source.
-    shutdownAudio();
-}
-
-//==============================================================================
-void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
-{        
-    gain = 0.5;
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-    
-    // This function will be called when the audio device is started, or when
-    // its settings (i.e. sample rate, block size, etc) are changed.
-
-    // You can use this function to initialise any resources you might need,
-    // but be careful - it will be called on the audio thread, not the GUI thread.
-
-    // For more details, see the help for AudioProcessor::prepareToPlay()
-}
-
-void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
-{
-    if (!playing) {
-        bufferToFill.clearActiveBufferRegion();
-        return;
-    }
-    mixerSource.getNextAudioBlock(bufferToFill);
-}
-
-void MainComponent::releaseResources()
-{
-    mixerSource.removeAllInputs();
-    mixerSource.releaseResources(); 
-    player1.releaseResources();
-    player2.releaseResources();
-}
-
-//==============================================================================
-void MainComponent::paint (juce::Graphics& g)
-{
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    // You can add your drawing code here!
-    g.fillAll(juce::Colours::lightblue);
-    g.setFont(20.0f);
-    if (message == "") {
-        g.drawText("Hello from Japan", getLocalBounds(),
-            juce::Justification::bottom, true);
-    }
-    else {
-        g.drawText(message, getLocalBounds(),
-            juce::Justification::bottom, true); // test
-    }   
-}
-
-void MainComponent::resized()
-{
-    double rowH = getHeight() / 10;
-    deckGUI1.setBounds(0, 0, getWidth()/2, rowH * 4);
-    deckGUI2.setBounds(getWidth() / 2, 0, getWidth() / 2, rowH * 4);
-    playlistComponent.setBounds(0, rowH * 4, getWidth(), rowH * 6);
-}
-
-
+#include "MainComponent.h"
+
+//==============================================================================
+MainComponent::MainComponent()
+{
+    // Make sure you set the size of the component after
+    // you add any child components.
+
+    // startup is staged: the window first, then the devices, then the library
+    startupTrace.mark("components");
+    formatManager.registerBasicFormats();
+    startupTrace.mark("format registration");
+
+    // the pads are prepared with the mixer, so they are set before the device starts
+    mixer.setPadBank(&padBank);
+
+    setSize(800, 600);
+    addAndMakeVisible(deckGUI1);
+    addAndMakeVisible(deckGUI2);
+    addAndMakeVisible(padGUI);
+    addAndMakeVisible(playlistComponent);
+
+    addAndMakeVisible(recordButton);
+    addAndMakeVisible(recordFormatBox);
+    addAndMakeVisible(recordStemsToggle);
+    addAndMakeVisible(recordStatus);
+    addAndMakeVisible(masterFxButton);
+    masterFxButton.addListener(this);
+    recordButton.addListener(this);
+    recordFormatBox.addItem("WAV", SetRecorder::wavFormat + 1);
+    recordFormatBox.addItem("FLAC", SetRecorder::flacFormat + 1);
+    recordFormatBox.setSelectedId(SetRecorder::wavFormat + 1, juce::dontSendNotification);
+    mixer.setRecorder(&recorder);
+
+    addAndMakeVisible(cueMixLabel);
+    addAndMakeVisible(cueMixSlider);
+    addAndMakeVisible(masterMixLabel);
+    addAndMakeVisible(cueOutputBox);
+    cueMixSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    cueMixSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    cueMixSlider.setRange(0.0, 1.0);
+    cueMixSlider.setValue(0.5);
+    cueMixSlider.addListener(this);
+    cueOutputBox.addListener(this);
+
+    addAndMakeVisible(midiButton);
+    midiButton.addListener(this);
+
+    // SYNC on either deck follows the other one
+    player1.setSyncTarget(&player2);
+    player2.setSyncTarget(&player1);
+
+    // the status shows the audio load all the time, and the recording while there is one
+    startTimer(250);
+
+    // the library load ends the startup
+    playlistComponent.onLibraryLoaded = [this] {
+        startupTrace.mark("library load");
+        startupTrace.writeLog(StartupTrace::getDefaultLogFile());
+    };
+    startupTrace.mark("layout");
+}
+
+MainComponent::~MainComponent()
+{
+    // the session store writes this last snapshot when it goes
+    saveSession();
+
+    // no more commands from the MIDI thread once the audio has stopped
+    midiController.closeInputs();
+
+    // This shuts down the audio device and clears the audio source.
+    shutdownAudio();
+    stopRecording();
+    cueOutput.close();
+}
+
+void MainComponent::openDevices()
+{
+    // Some platforms require permissions to open input channels so request that here
+    if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
+        && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
+    {
+        juce::RuntimePermissions::request (juce::RuntimePermissions::recordAudio,
+                                           [&] (bool granted) { setAudioChannels (granted ? 2 : 0, 4); });
+    }
+    else
+    {
+        // Specify the number of input and output channels that we want to open,
+        // outputs 3 and 4 carry the headphones where the device has them
+        setAudioChannels (0, 4);
+    }
+    updateCueOutputs();
+    midiController.openInputs();
+    startupTrace.mark("device open");
+
+    // the library loads first so the restored decks wait for its index,
+    // finishLibraryLoad() then gives them their analysis from it
+    playlistComponent.loadLibraryAsync();
+    restoreSession();
+    startupTrace.mark("session restore");
+}
+
+//==============================================================================
+void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{        
+    gain = 0.5;
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    
+    // This function will be called when the audio device is started, or when
+    // its settings (i.e. sample rate, block size, etc) are changed.
+
+    // You can use this function to initialise any resources you might need,
+    // but be careful - it will be called on the audio thread, not the GUI thread.
+
+    // For more details, see the help for AudioProcessor::prepareToPlay()
+}
+
+void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // stopped and empty decks are skipped inside the mixer
+    mixer.getNextAudioBlock(bufferToFill);
+}
+
+void MainComponent::releaseResources()
+{
+    mixer.releaseResources();
+}
+
+//==============================================================================
+void MainComponent::paint (juce::Graphics& g)
+{
+    // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+
+    // You can add your drawing code here!
+    g.fillAll(juce::Colours::lightblue);
+    recordButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::red);
+    recordStemsToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::black);
+    recordStemsToggle.setColour(juce::ToggleButton::tickColourId, juce::Colours::black);
+    recordStatus.setColour(juce::Label::textColourId, juce::Colours::black);
+    cueMixLabel.setColour(juce::Label::textColourId, juce::Colours::black);
+    masterMixLabel.setColour(juce::Label::textColourId, juce::Colours::black);
+    g.setFont(20.0f);
+    if (message == "") {
+        g.drawText("Hello from Japan", getLocalBounds(),
+            juce::Justification::bottom, true);
+    }
+    else {
+        g.drawText(message, getLocalBounds(),
+            juce::Justification::bottom, true); // test
+    }   
+
+    // the window is up, the devices are opened once this frame is on screen
+    if (!startupTrace.isInteractive()) {
+        startupTrace.markInteractive();
+        juce::Component::SafePointer<MainComponent> safeThis(this);
+        juce::MessageManager::callAsync([safeThis] {
+            if (safeThis != nullptr)
+                safeThis->openDevices();
+        });
+    }
+}
+
+void MainComponent::resized()
+{
+    double rowH = getHeight() / 10;
+    deckGUI1.setBounds(0, 0, getWidth() / 5 * 2, rowH * 4);
+    padGUI.setBounds(getWidth() / 5 * 2, 0, getWidth() / 5, rowH * 4);
+    deckGUI2.setBounds(getWidth() / 5 * 3, 0, getWidth() / 5 * 2, rowH * 4);
+    double stripW = getWidth() / 20;
+    recordButton.setBounds(0, rowH * 4, stripW * 2, rowH * 0.5);
+    recordFormatBox.setBounds(stripW * 2, rowH * 4, stripW * 2, rowH * 0.5);
+    recordStemsToggle.setBounds(stripW * 4, rowH * 4, stripW * 2, rowH * 0.5);
+    recordStatus.setBounds(stripW * 6, rowH * 4, stripW * 3, rowH * 0.5);
+    masterFxButton.setBounds(stripW * 9, rowH * 4, stripW, rowH * 0.5);
+    cueMixLabel.setBounds(stripW * 10, rowH * 4, stripW, rowH * 0.5);
+    cueMixSlider.setBounds(stripW * 11, rowH * 4, stripW * 3, rowH * 0.5);
+    masterMixLabel.setBounds(stripW * 14, rowH * 4, stripW, rowH * 0.5);
+    cueOutputBox.setBounds(stripW * 15, rowH * 4, stripW * 3, rowH * 0.5);
+    midiButton.setBounds(stripW * 18, rowH * 4, stripW * 2, rowH * 0.5);
+    playlistComponent.setBounds(0, rowH * 4.5, getWidth(), rowH * 5.5);
+}
+
+void MainComponent::buttonClicked(juce::Button* button)
+{
+    if (button == &recordButton) {
+        if (recorder.isRecording())
+            stopRecording();
+        else
+            startRecording();
+    }
+    if (button == &midiButton) {
+        showMidiMenu();
+    }
+    if (button == &masterFxButton) {
+        masterFxMenu.show(masterFxButton);
+    }
+}
+
+void MainComponent::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    if (comboBox != &cueOutputBox)
+        return;
+
+    cueOutput.close();
+    auto id = cueOutputBox.getSelectedId();
+
+    if (id == 2) {
+        if (mixer.getNumOutputChannels() < 4)
+            std::cout << "MainComponent::comboBoxChanged the device has no outputs 3 and 4" << std::endl;
+        mixer.setCueRouting(DeckMixer::cueOnDeviceChannels);
+    }
+    else if (id > 2) {
+        auto* type = deviceManager.getCurrentDeviceTypeObject();
+        if (type != nullptr && cueOutput.open(type->getTypeName(), cueOutputBox.getText(), mixer.getSampleRate()))
+            mixer.setCueRouting(DeckMixer::cueOnSecondDevice, &cueOutput);
+        else
+            cueOutputBox.setSelectedId(1);
+    }
+    else {
+        mixer.setCueRouting(DeckMixer::cueOff);
+    }
+}
+
+void MainComponent::sliderValueChanged(juce::Slider* slider)
+{
+    if (slider == &cueMixSlider)
+        mixer.setCueMix(slider->getValue());
+}
+
+void MainComponent::updateCueOutputs()
+{
+    cueOutputBox.clear(juce::dontSendNotification);
+    cueOutputBox.addItem("Headphones off", 1);
+    cueOutputBox.addItem("Headphones on outputs 3-4", 2);
+
+    // any other output of the same device type, played through drift-compensating resampling
+    if (auto* type = deviceManager.getCurrentDeviceTypeObject()) {
+        auto mainOutput = deviceManager.getAudioDeviceSetup().outputDeviceName;
+        auto names = type->getDeviceNames(false);
+        for (int i = 0; i < names.size(); ++i)
+            if (names[i] != mainOutput)
+                cueOutputBox.addItem(names[i], 3 + i);
+    }
+    cueOutputBox.setSelectedId(1, juce::dontSendNotification);
+}
+
+void MainComponent::timerCallback()
+{
+    auto seconds = (int) (recorder.getRecordedSamples() / juce::jmax(1.0, mixer.getSampleRate()));
+    auto status = juce::String::formatted("%02d:%02d:%02d", seconds / 3600, seconds / 60 % 60, seconds % 60);
+
+    // samples lost because the disk could not keep up
+    auto dropped = recorder.getDroppedSamples();
+    if (dropped > 0)
+        status << "   dropped " << dropped << " samples";
+
+    status << "   CPU " << juce::roundToInt(mixer.getCpuLoad() * 100.0) << "%";
+
+    recordStatus.setText(status, juce::dontSendNotification);
+
+    // every 2 seconds
+    if (++timerTicks % 8 == 0)
+        saveSession();
+}
+
+void MainComponent::restoreSession()
+{
+    auto decks = session.load();
+    DJAudioPlayer* players[] = { &player1, &player2 };
+    DeckGUI* deckGUIs[] = { &deckGUI1, &deckGUI2 };
+
+    for (int i = 0; i < juce::jmin(2, decks.size()); ++i) {
+        auto& deck = decks.getReference(i);
+        if (!deck.trackFile.existsAsFile())
+            continue;
+
+        // opens the decoders and builds the waveform; the prefetcher then
+        // decodes around the position and the hot cues in the background
+        playlistComponent.loadTrack(players[i], deck.trackFile);
+        players[i]->setHotCues(deck.hotCues);
+        players[i]->setPosition(deck.position);
+        players[i]->setSpeed(deck.speed);
+        players[i]->setGain(juce::jlimit(0.0, 1.0, deck.gain));
+        mixer.setCueEnabled(players[i], deck.cueEnabled);
+        deckGUIs[i]->updateFromPlayer();
+    }
+    sessionRestored = true;
+}
+
+void MainComponent::saveSession()
+{
+    // nothing to save over the previous session until it is restored
+    if (!sessionRestored)
+        return;
+
+    juce::Array<DeckSession> decks;
+    for (auto* player : { &player1, &player2 }) {
+        DeckSession deck;
+        deck.trackFile = player->getLoadedURL().getLocalFile();
+        deck.position = player->getPosition();
+        deck.speed = player->getSpeedSetting();
+        deck.gain = player->getGain();
+        deck.cueEnabled = mixer.isCueEnabled(player);
+        deck.hotCues = player->getHotCues();
+        decks.add(deck);
+    }
+    session.save(decks);
+}
+
+void MainComponent::startRecording()
+{
+    auto folder = juce::File::getSpecialLocation(juce::File::userMusicDirectory).getChildFile("Recordings");
+    folder.createDirectory();
+
+    auto format = (SetRecorder::Format) (recordFormatBox.getSelectedId() - 1);
+    auto name = "Set " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S")
+                + (format == SetRecorder::flacFormat ? ".flac" : ".wav");
+    auto numStems = recordStemsToggle.getToggleState() ? 2 : 0;
+
+    if (!recorder.start(folder.getChildFile(name), format, numStems, mixer.getSampleRate()))
+        return;
+
+    recordButton.setToggleState(true, juce::dontSendNotification);
+    recordFormatBox.setEnabled(false);
+    recordStemsToggle.setEnabled(false);
+}
+
+void MainComponent::stopRecording()
+{
+    recorder.stop();
+    timerCallback();
+
+    recordButton.setToggleState(false, juce::dontSendNotification);
+    recordFormatBox.setEnabled(true);
+    recordStemsToggle.setEnabled(true);
+}
+
+void MainComponent::showMidiMenu()
+{
+    juce::PopupMenu menu;
+
+    auto inputs = midiController.getInputNames();
+    menu.addSectionHeader(inputs.isEmpty() ? "No MIDI inputs" : inputs.joinIntoString(", "));
+
+    // measured up to the audio thread, plus the plugins and the device's own output latency
+    double average, maximum;
+    mixer.getControlLatency(average, maximum);
+    if (auto* device = deviceManager.getCurrentAudioDevice()) {
+        auto output = (device->getOutputLatencyInSamples() + device->getCurrentBufferSizeSamples() + mixer.getPluginLatency())
+                      * 1000.0 / juce::jmax(1.0, device->getCurrentSampleRate());
+        average += output;
+        maximum += output;
+    }
+    menu.addItem(1, juce::String::formatted("Latency %.1f ms, max %.1f ms", average, maximum), false);
+    menu.addSeparator();
+
+    // item ids: 100 + 100 * target + action
+    for (int deck = 0; deck < 2; ++deck) {
+        juce::PopupMenu deckMenu;
+        for (int action = MidiController::playAction; action < MidiController::padAction; ++action)
+            deckMenu.addItem(100 + 100 * deck + action, MidiController::getActionName((MidiController::Action) action));
+        menu.addSubMenu("Learn Deck" + juce::String(deck + 1), deckMenu);
+    }
+    juce::PopupMenu padMenu;
+    for (int pad = 0; pad < SamplePadBank::numPads; ++pad)
+        padMenu.addItem(100 + 100 * pad + MidiController::padAction, "PAD " + juce::String(pad + 1));
+    menu.addSubMenu("Learn pad", padMenu);
+
+    menu.addSeparator();
+    if (midiController.isLearning())
+        menu.addItem(2, "Cancel learning");
+    menu.addItem(3, "Clear mapping (" + juce::String(midiController.getNumBindings()) + " controls)");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&midiButton), [this](int result) {
+        if (result == 2) {
+            midiController.cancelLearning();
+        }
+        else if (result == 3) {
+            midiController.clearMapping();
+            mixer.resetControlLatency();
+        }
+        else if (result >= 100) {
+            // move the control on the controller next
+            midiController.learn(result / 100 - 1, (MidiController::Action) (result % 100));
+        }
+    });
+}
\ No newline at end of file
@@ -1,55 +1,135 @@
-#pragma once
-
-#include <JuceHeader.h>
-#include "DJAudioPlayer.h"
-#include "DeckGUI.h"
-#include "PlaylistComponent.h"
-#include "WaveformDisplay.h"
-
-//==============================================================================
-/*
-    This component lives inside our window, and this is where you should put all
-    your controls and content.
-*/
-class MainComponent : public juce::AudioAppComponent
-
-{
-public:
-    //==============================================================================
-    MainComponent();
-    ~MainComponent() override;
-
-    //==============================================================================
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
-    void releaseResources() override;
-
-    //==============================================================================
-    void paint(juce::Graphics& g) override;
-    void resized() override;
-
-    /** test */
-    //void sliderDragStarted(juce::Slider*) override;
-    std::string message = "";
-
-private:
-    //==============================================================================
-    bool playing;
-    double gain;
-
-    juce::AudioFormatManager formatManager;
-    juce::AudioThumbnailCache thumbCache{100};
-
-    DJAudioPlayer player1{formatManager};
-    DeckGUI deckGUI1{ &player1 };
-
-    DJAudioPlayer player2{formatManager};
-    DeckGUI deckGUI2{ &player2 };
-
-    juce::MixerAudioSource mixerSource;
-
-    // added two pairs of formatManager and thumbCache to display waveforms in the playlist
-    PlaylistComponent playlistComponent{ &player1, &player2,  formatManager, thumbCache,  formatManager, thumbCache };
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
-};
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "DeckMixer.h"
+#include "SetRecorder.h"
+#include "CueOutput.h"
+#include "MidiController.h"
+#include "DeckGUI.h"
+#include "SamplePadGUI.h"
+#include "PluginChainMenu.h"
+#include "PlaylistComponent.h"
+#include "WaveformDisplay.h"
+#include "StartupTrace.h"
+#include "SessionStore.h"
+
+//==============================================================================
+/*
+    This component lives inside our window, and this is where you should put all
+    your controls and content.
+*/
+class MainComponent : public juce::AudioAppComponent,
+                      public juce::Button::Listener,
+                      public juce::ComboBox::Listener,
+                      public juce::Slider::Listener,
+                      public juce::Timer
+
+{
+public:
+    //==============================================================================
+    MainComponent();
+    ~MainComponent() override;
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //==============================================================================
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    /** implement Button::Listener */
+    void buttonClicked(juce::Button* button) override;
+
+    /** implement ComboBox::Listener, routes the headphones */
+    void comboBoxChanged(juce::ComboBox* comboBox) override;
+
+    /** implement Slider::Listener, sets the headphone mix */
+    void sliderValueChanged(juce::Slider* slider) override;
+
+    /** implement Timer, shows the time recorded, the dropped samples and the audio load, and saves the session */
+    void timerCallback() override;
+
+    /** test */
+    //void sliderDragStarted(juce::Slider*) override;
+    std::string message = "";
+
+private:
+    //==============================================================================
+    // declared first, so the trace starts before the other members are built
+    StartupTrace startupTrace;
+
+    double gain;
+
+    juce::AudioFormatManager formatManager;
+    juce::AudioThumbnailCache thumbCache{100};
+
+    DJAudioPlayer player1{formatManager};
+    DJAudioPlayer player2{formatManager};
+
+    // declared before the mixer, which writes into them from the audio thread
+    SetRecorder recorder;
+    CueOutput cueOutput;
+    SamplePadBank padBank;
+
+    // mixes the decks on the master clock that deck starts and stops are scheduled on
+    DeckMixer mixer{ { &player1, &player2 } };
+
+    // controller input, queued from the MIDI thread straight to the mixer and the pads
+    MidiController midiController{ &mixer, { &player1, &player2 }, &padBank };
+
+    DeckGUI deckGUI1{ &player1, &mixer };
+    DeckGUI deckGUI2{ &player2, &mixer };
+    SamplePadGUI padGUI{ &padBank, formatManager };
+
+    // added two pairs of formatManager and thumbCache to display waveforms in the playlist
+    PlaylistComponent playlistComponent{ &player1, &player2, &mixer,  formatManager, thumbCache,  formatManager, thumbCache };
+
+    juce::TextButton recordButton{ "REC" };
+    juce::ComboBox recordFormatBox;
+    juce::ToggleButton recordStemsToggle{ "Stems" };
+    juce::Label recordStatus;
+
+    // the insert effects on the master bus
+    juce::TextButton masterFxButton{ "FX" };
+    PluginChainMenu masterFxMenu{ mixer.getMasterChain() };
+
+    // headphones: the cue/master mix and where the cue bus goes
+    juce::Label cueMixLabel{ "", "CUE" };
+    juce::Slider cueMixSlider;
+    juce::Label masterMixLabel{ "", "MST" };
+    juce::ComboBox cueOutputBox;
+
+    // MIDI learn and the measured controller latency
+    juce::TextButton midiButton{ "MIDI" };
+
+    // what is on the decks, saved every few seconds once the previous session is restored
+    SessionStore session{ SessionStore::getDefaultSessionFile() };
+    bool sessionRestored = false;
+    int timerTicks = 0;
+
+    /** second startup stage, after the first paint: open the audio and MIDI devices, then load the library */
+    void openDevices();
+
+    /** load the tracks of the previous session onto the decks, at their positions, ready to play */
+    void restoreSession();
+
+    /** take a snapshot of the decks for the session store */
+    void saveSession();
+
+    /** list the places the cue bus can go, the second device choices are the other outputs of the device type */
+    void updateCueOutputs();
+
+    /** start recording into a new file in the Recordings folder */
+    void startRecording();
+
+    /** stop recording */
+    void stopRecording();
+
+    /** show the MIDI menu: the open inputs, the latency, and the controls to learn */
+    void showMidiMenu();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
+};
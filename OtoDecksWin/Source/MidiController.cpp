@@ -0,0 +1,381 @@
+/*
+  ==============================================================================
+
+    MidiController.cpp
+    Created: 19 Oct 2026 1:14:36pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "MidiController.h"
+#include "AppData.h"
+
+namespace
+{
+    // the same platter as the jog wheel on screen: a 33 1/3 rpm record
+    const double secondsPerTurn = 1.8;
+
+    // a 7-bit relative jog wheel sends this many ticks per turn
+    const double ticksPerTurn = 128.0;
+
+    // a 14-bit jog wheel goes round once over its whole range
+    const int jogRange = 16384;
+
+    // the pitch fader covers +-8%, as on a turntable
+    const double pitchRange = 0.08;
+}
+
+MidiController::MidiController(DeckMixer* _mixer, const juce::Array<DJAudioPlayer*>& _decks, SamplePadBank* _pads,
+                               juce::File _mappingFile)
+    : mixer(_mixer), decks(_decks), pads(_pads), mappingFile(_mappingFile)
+{
+    for (int channel = 0; channel < 16; ++channel) {
+        for (int number = 0; number < 32; ++number) {
+            msbValues[channel][number] = 0;
+            jogPositions[channel][number] = -1;
+        }
+    }
+    loadMapping();
+}
+
+MidiController::~MidiController()
+{
+    closeInputs();
+    cancelPendingUpdate();
+}
+
+void MidiController::openInputs()
+{
+    closeInputs();
+
+    for (auto& device : juce::MidiInput::getAvailableDevices()) {
+        if (auto input = juce::MidiInput::openDevice(device.identifier, this)) {
+            input->start();
+            inputs.add(input.release());
+        }
+        else {
+            std::cout << "MidiController::openInputs could not open " << device.name << std::endl;
+        }
+    }
+
+#if JUCE_LINUX || JUCE_MAC
+    // a port other programs connect to, e.g. with aconnect
+    if (auto input = juce::MidiInput::createNewDevice("OtoDecks", this)) {
+        input->start();
+        inputs.add(input.release());
+    }
+#endif
+}
+
+void MidiController::closeInputs()
+{
+    for (auto* input : inputs)
+        input->stop();
+    inputs.clear();
+}
+
+juce::StringArray MidiController::getInputNames() const
+{
+    juce::StringArray names;
+    for (auto* input : inputs)
+        names.add(input->getName());
+    return names;
+}
+
+void MidiController::learn(int target, Action action)
+{
+    if (action == padAction ? (target < 0 || target >= SamplePadBank::numPads)
+                            : (target < 0 || target >= decks.size())) {
+        std::cout << "MidiController::learn target is not a deck or pad" << std::endl;
+        return;
+    }
+
+    const juce::SpinLock::ScopedLockType sl(mappingLock);
+    learned.action = action;
+    learned.target = target;
+    learnMsb = -1;
+    learning = true;
+}
+
+void MidiController::cancelLearning()
+{
+    learning = false;
+}
+
+bool MidiController::isLearning() const
+{
+    return learning;
+}
+
+void MidiController::clearMapping()
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(mappingLock);
+        numBindings = 0;
+    }
+    saveMapping();
+}
+
+int MidiController::getNumBindings() const
+{
+    return numBindings;
+}
+
+juce::String MidiController::getActionName(Action action)
+{
+    switch (action) {
+    case playAction:     return "Play";
+    case stopAction:     return "Stop";
+    case volumeAction:   return "Volume";
+    case speedAction:    return "Speed";
+    case positionAction: return "Position";
+    case jogAction:      return "Jog wheel";
+    case jogTouchAction: return "Jog touch";
+    case padAction:      return "Pad";
+    default:             return {};
+    }
+}
+
+juce::File MidiController::getDefaultMappingFile()
+{
+    // one mapping for every controller the user has learned, kept across sessions
+    return AppData::getFile("midimap.xml");
+}
+
+void MidiController::handleIncomingMidiMessage(juce::MidiInput* /*source*/, const juce::MidiMessage& message)
+{
+    // the time the driver stamped on arrival, in the hi-res millisecond counter
+    auto timestamp = message.getTimeStamp() * 1000.0;
+    if (timestamp <= 0.0)
+        timestamp = juce::Time::getMillisecondCounterHiRes();
+
+    // also keeps callbacks from several inputs from queueing at once, the
+    // mixer and pad queues take one producer each
+    const juce::SpinLock::ScopedLockType sl(mappingLock);
+
+    if (learning) {
+        learnFrom(message);
+        return;
+    }
+
+    auto channel = message.getChannel();
+    for (int i = 0; i < numBindings; ++i) {
+        auto& binding = bindings[i];
+        if (binding.channel != channel)
+            continue;
+
+        switch (binding.kind) {
+        case Binding::note:
+            if (message.isNoteOnOrOff() && message.getNoteNumber() == binding.number)
+                perform(binding, message.isNoteOn() ? message.getFloatVelocity() : 0.0, timestamp);
+            break;
+
+        case Binding::controller:
+            if (message.isController() && message.getControllerNumber() == binding.number) {
+                auto value = message.getControllerValue();
+                if (binding.action == jogAction)
+                    // two's complement: 1 to 63 forwards, 127 down to 65 backwards
+                    perform(binding, (value < 64 ? value : value - 128) / ticksPerTurn, timestamp);
+                else
+                    perform(binding, value / 127.0, timestamp);
+            }
+            break;
+
+        case Binding::controller14: {
+            if (!message.isController())
+                break;
+
+            auto number = message.getControllerNumber();
+            auto& msb = msbValues[channel - 1][binding.number];
+            if (number == binding.number) {
+                msb = message.getControllerValue();
+                // a jog moves on the LSB, which completes the position
+                if (binding.action != jogAction)
+                    perform(binding, (msb << 7) / 16383.0, timestamp);
+            }
+            else if (number == binding.number + 32) {
+                auto value = (msb << 7) | message.getControllerValue();
+                if (binding.action == jogAction) {
+                    auto& last = jogPositions[channel - 1][binding.number];
+                    if (last >= 0) {
+                        // the short way round the wheel
+                        auto delta = (value - last + jogRange + jogRange / 2) % jogRange - jogRange / 2;
+                        perform(binding, (double) delta / jogRange, timestamp);
+                    }
+                    last = value;
+                }
+                else {
+                    perform(binding, value / 16383.0, timestamp);
+                }
+            }
+            break;
+        }
+
+        case Binding::pitchWheel:
+            if (message.isPitchWheel())
+                perform(binding, message.getPitchWheelValue() / 16383.0, timestamp);
+            break;
+        }
+    }
+}
+
+void MidiController::learnFrom(const juce::MidiMessage& message)
+{
+    Binding binding = learned;
+    binding.channel = message.getChannel();
+
+    if (message.isController()) {
+        auto number = message.getControllerNumber();
+
+        // controllers 0 to 31 may be the MSB of a 14-bit pair, the next message tells
+        if (learnMsb < 0 && number < 32) {
+            learnMsb = number;
+            return;
+        }
+        if (learnMsb >= 0) {
+            binding.kind = number == learnMsb + 32 ? Binding::controller14 : Binding::controller;
+            binding.number = learnMsb;
+        }
+        else {
+            binding.kind = Binding::controller;
+            binding.number = number;
+        }
+    }
+    else if (message.isNoteOn()) {
+        binding.kind = Binding::note;
+        binding.number = message.getNoteNumber();
+    }
+    else if (message.isPitchWheel()) {
+        binding.kind = Binding::pitchWheel;
+        binding.number = 0;
+    }
+    else {
+        return;
+    }
+
+    // the control loses whatever it did before
+    int kept = 0;
+    for (int i = 0; i < numBindings; ++i) {
+        auto& other = bindings[i];
+        if (other.kind != binding.kind || other.channel != binding.channel || other.number != binding.number)
+            bindings[kept++] = other;
+    }
+    numBindings = kept;
+
+    if (numBindings < maxBindings)
+        bindings[numBindings++] = binding;
+    else
+        std::cout << "MidiController::learnFrom the mapping is full" << std::endl;
+
+    learning = false;
+
+    // the file is written on the message thread
+    triggerAsyncUpdate();
+}
+
+void MidiController::handleAsyncUpdate()
+{
+    saveMapping();
+}
+
+void MidiController::perform(const Binding& binding, double value, double timestamp)
+{
+    // a block after arrival, so every message waits the same time
+    auto time = mixer->getClockTimeAt(timestamp) + mixer->getBlockSize();
+    auto source = DeckMixer::midiThread;
+
+    if (binding.action == padAction) {
+        if (pads != nullptr && value > 0.0)
+            pads->trigger(binding.target, time, SamplePadBank::midiThread);
+        return;
+    }
+
+    auto* deck = decks[binding.target];
+    if (deck == nullptr)
+        return;
+
+    switch (binding.action) {
+    case playAction:
+        if (value >= 0.5)
+            mixer->scheduleStart(deck, time, source, timestamp);
+        break;
+
+    case stopAction:
+        if (value >= 0.5)
+            mixer->scheduleStop(deck, time, source, timestamp);
+        break;
+
+    case volumeAction:
+        mixer->scheduleControl(deck, DeckMixer::gainControl, value, time, source, timestamp);
+        break;
+
+    case speedAction:
+        mixer->scheduleControl(deck, DeckMixer::speedControl, 1.0 + (value - 0.5) * 2.0 * pitchRange, time, source, timestamp);
+        break;
+
+    case positionAction:
+        mixer->scheduleControl(deck, DeckMixer::positionControl, value, time, source, timestamp);
+        break;
+
+    case jogAction:
+        mixer->scheduleControl(deck, DeckMixer::jogControl, value * secondsPerTurn, time, source, timestamp);
+        break;
+
+    case jogTouchAction:
+        mixer->scheduleControl(deck, DeckMixer::jogTouchControl, value >= 0.5 ? 1.0 : 0.0, time, source, timestamp);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void MidiController::loadMapping()
+{
+    if (!mappingFile.existsAsFile())
+        return;
+
+    auto xml = juce::parseXML(mappingFile);
+    if (xml == nullptr || !xml->hasTagName("MIDIMAP")) {
+        std::cout << "MidiController::loadMapping could not parse " << mappingFile.getFullPathName() << std::endl;
+        return;
+    }
+
+    const juce::SpinLock::ScopedLockType sl(mappingLock);
+    numBindings = 0;
+    for (auto* element : xml->getChildWithTagNameIterator("BINDING")) {
+        if (numBindings == maxBindings)
+            break;
+
+        Binding binding;
+        binding.kind = (Binding::Kind) juce::jlimit(0, (int) Binding::pitchWheel, element->getIntAttribute("kind"));
+        binding.channel = juce::jlimit(1, 16, element->getIntAttribute("channel", 1));
+        binding.number = juce::jlimit(0, 127, element->getIntAttribute("number"));
+        binding.action = (Action) juce::jlimit(0, numActions - 1, element->getIntAttribute("action"));
+        binding.target = element->getIntAttribute("target");
+
+        // a 14-bit pair starts on controllers 0 to 31
+        if (binding.kind == Binding::controller14 && binding.number >= 32)
+            continue;
+        bindings[numBindings++] = binding;
+    }
+}
+
+void MidiController::saveMapping()
+{
+    juce::XmlElement xml("MIDIMAP");
+    {
+        const juce::SpinLock::ScopedLockType sl(mappingLock);
+        for (int i = 0; i < numBindings; ++i) {
+            auto* element = xml.createNewChildElement("BINDING");
+            element->setAttribute("kind", (int) bindings[i].kind);
+            element->setAttribute("channel", bindings[i].channel);
+            element->setAttribute("number", bindings[i].number);
+            element->setAttribute("action", (int) bindings[i].action);
+            element->setAttribute("target", bindings[i].target);
+        }
+    }
+    if (!xml.writeTo(mappingFile))
+        std::cout << "MidiController::saveMapping could not write " << mappingFile.getFullPathName() << std::endl;
+}
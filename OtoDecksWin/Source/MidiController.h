@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    MidiController.h
+    Created: 19 Oct 2026 1:14:36pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include "DJAudioPlayer.h"
+#include "DeckMixer.h"
+#include "SamplePadBank.h"
+
+//==============================================================================
+/*
+    MIDI controller input with a learnable mapping.
+
+    Messages are turned into deck commands on the MIDI thread and queued
+    straight to the audio engine, on DeckMixer's and SamplePadBank's own MIDI
+    queues, so a busy message thread never delays them. Each command is
+    scheduled a block after the time the message arrived, which keeps the
+    latency constant instead of depending on where in a block it came in.
+
+    Faders and knobs may send 14-bit values (MSB on controller n, LSB on
+    n + 32) or pitch wheel messages. Jog wheels may send 7-bit relative values
+    in two's complement, or a 14-bit absolute wheel position.
+
+    On Linux and macOS a virtual input port called "OtoDecks" is opened as
+    well, so software controllers and ALSA sequencer tools can connect to it.
+*/
+class MidiController  : private juce::MidiInputCallback,
+                        private juce::AsyncUpdater
+{
+public:
+    enum Action
+    {
+        playAction = 0,
+        stopAction,
+        volumeAction,
+        speedAction,
+        positionAction,
+        jogAction,
+        jogTouchAction,
+        padAction,
+        numActions
+    };
+
+    /**
+    *   @param mixer the mixer the deck commands are scheduled on
+    *   @param decks the decks the mapping refers to by index
+    *   @param pads the sample pads
+    *   @param mappingFile where the mapping is kept between sessions
+    */
+    MidiController(DeckMixer* mixer, const juce::Array<DJAudioPlayer*>& decks, SamplePadBank* pads,
+                   juce::File mappingFile = getDefaultMappingFile());
+    ~MidiController() override;
+
+    /** open every MIDI input there is, and the virtual port where the platform has one */
+    void openInputs();
+
+    /** close all MIDI inputs */
+    void closeInputs();
+
+    /** get the names of the open inputs */
+    juce::StringArray getInputNames() const;
+
+    /**
+    *   Bind the next control that is moved to an action. A moved control replaces
+    *   the binding it had.
+    *   @param target the deck index, or the pad for padAction
+    *   @param action the action
+    */
+    void learn(int target, Action action);
+
+    /** stop waiting for a control to learn */
+    void cancelLearning();
+
+    /** true while waiting for a control to learn */
+    bool isLearning() const;
+
+    /** remove every binding */
+    void clearMapping();
+
+    /** get the number of bindings */
+    int getNumBindings() const;
+
+    /** get the name of an action, for menus */
+    static juce::String getActionName(Action action);
+
+    /** the mapping file used by the application */
+    static juce::File getDefaultMappingFile();
+
+private:
+    struct Binding
+    {
+        enum Kind { note, controller, controller14, pitchWheel };
+
+        Kind kind = note;
+        int channel = 1;
+        int number = 0;
+        Action action = playAction;
+        int target = 0;
+    };
+
+    void handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) override;
+
+    /** write the mapping after a control was learned on the MIDI thread */
+    void handleAsyncUpdate() override;
+
+    /** bind the control a message came from to the action being learned, if it is one */
+    void learnFrom(const juce::MidiMessage& message);
+
+    /**
+    *   Carry out a binding's action.
+    *   @param value the control value, 0 to 1, or the relative jog movement in turns for a jog
+    *   @param timestamp when the message arrived, in milliseconds
+    */
+    void perform(const Binding& binding, double value, double timestamp);
+
+    /** read the mapping file */
+    void loadMapping();
+
+    /** write the mapping file */
+    void saveMapping();
+
+    static constexpr int maxBindings = 128;
+
+    DeckMixer* mixer;
+    juce::Array<DJAudioPlayer*> decks;
+    SamplePadBank* pads;
+    juce::File mappingFile;
+
+    juce::OwnedArray<juce::MidiInput> inputs;
+
+    // the MIDI thread reads the bindings under it, the message thread only
+    // takes it for the rare change of the mapping
+    juce::SpinLock mappingLock;
+    Binding bindings[maxBindings];
+    int numBindings = 0;
+
+    // the action being learned, MIDI thread only once set
+    std::atomic<bool> learning{ false };
+    Binding learned;
+    int learnMsb = -1;
+
+    // MIDI thread only: the last MSB of each 14-bit controller, the last jog positions
+    int msbValues[16][32];
+    int jogPositions[16][32];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiController)
+};
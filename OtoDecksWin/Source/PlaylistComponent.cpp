@@ -1,407 +1,1247 @@
-/*
-  ==============================================================================
-
-    PlaylistComponent.cpp
-    Created: 26 Aug 2020 5:25:27am
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "PlaylistComponent.h"
-#include <algorithm>
-
-//==============================================================================
-PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1, DJAudioPlayer* _player2, 
-                            juce::AudioFormatManager& formatManagerToUse, 
-                            juce::AudioThumbnailCache& cacheToUse,
-                            juce::AudioFormatManager& formatManagerToUse2, 
-                            juce::AudioThumbnailCache& cacheToUse2 )
-                            : player1{ _player1 }, player2{ _player2 }, 
-                            waveformDisplay(formatManagerToUse, cacheToUse), 
-                            waveformDisplay2(formatManagerToUse2, cacheToUse2)
-    
-{
-    // R2E: restore library
-    restoreLibrary();
-
-    // create columns for the library
-    tableComponent.getHeader().addColumn("Track Title", 0, 200);    
-    tableComponent.getHeader().addColumn("Length", 3, 200);
-    tableComponent.getHeader().addColumn("Load to Deck1", 1, 200);
-    tableComponent.getHeader().addColumn("Load to Deck2", 2, 200);
-    
-    // add table component 
-    tableComponent.setModel(this);
-    addAndMakeVisible(tableComponent);
-
-    // add ADD button 
-    addAndMakeVisible(addButton);
-    addButton.addListener(this); 
-
-    // add searchBox text editor
-    addAndMakeVisible(searchBox);
-    searchBox.addListener(this);
-
-    // add waveforms
-    addAndMakeVisible(waveformDisplay);
-    addAndMakeVisible(waveformDisplay2);
-    startTimer(500);
-}
-
-PlaylistComponent::~PlaylistComponent()
-{
-    
-}
-
-/**
-*   Set the location (counds) for the add button, the search box, and the table component.
-*/
-void PlaylistComponent::resized()
-{
-    double rowH = getHeight() / 8;
-
-    // set bounds for widgets
-    waveformDisplay.setBounds(0, 0, getWidth() / 2, rowH * 2.5);
-    waveformDisplay2.setBounds(getWidth() / 2, 0, getWidth() / 2, rowH * 2.5);
-    addButton.setBounds(0, rowH * 2.5, getWidth()/2, rowH * 0.7);
-    searchBox.setBounds(getWidth() / 2, rowH * 2.5, getWidth() / 2, rowH * 0.7);
-    tableComponent.setBounds(0, rowH * 3.2, getWidth(), rowH * 4.8);
-    
-}
-
-/**
-*   Get the number of rows in the table component.
-*   @return the number of rows.
-*/
-int PlaylistComponent::getNumRows()
-{
-    return trackTitles.size();
-}
-
-/**
-*   Paint the row background. 
-*   @param g the graphics to be painted
-*   @param rowNumber the number of the row
-*   @param width the number of width of the row
-*   @param height the number of height of the row
-*   @param rowIsSelected true if the row is selected and false otherwise
-*/
-void PlaylistComponent::paintRowBackground(juce::Graphics& g, 
-                            int rowNumber, 
-                            int width, 
-                            int height, 
-                            bool rowIsSelected )
-{
-    if (rowIsSelected) {
-        g.fillAll(juce::Colour(115, 181, 221)); // use same color with waveform
-    }
-    else {
-        g.fillAll(juce::Colours::white);
-    }
-}
-
-/**
-*   R1A: Component has custom graphics implemented in a paint function.
-*   Set the custom styles and colors for widgets.
-*   @param g the graphics to be painted
-*/
-
-void PlaylistComponent::paint(juce::Graphics& g)
-{
-    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));   // clear the background
-
-    g.setColour(juce::Colours::grey);
-    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
-
-    g.setColour(juce::Colours::black);
-    g.setFont(14.0f);
-    g.drawText("PlaylistComponent", getLocalBounds(),
-        juce::Justification::centred, true);   // draw some placeholder text
-
-    // set color for the add button and its text
-    addButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 53, 90));
-    addButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
-
-    // set default text to show on a search box as well as set color
-    searchBox.setTextToShowWhenEmpty("Search...", juce::Colours::darkgrey);
-    searchBox.setColour(juce::TextEditor::backgroundColourId, juce::Colour(255, 255, 255));
-    searchBox.setColour(juce::TextEditor::textColourId, juce::Colours::darkgrey);
-}
-
-/**
-*   R1B: Component enables the user to control the playback of a deck somehow.
-*   R2D: Component allows the user to load files from the library into a deck.
-*   If LOAD1 or LOAD2 button is clicked, load a track to a subjected deck and to a waveform.
-*   @param buttonId the button id number
-*/
-
-void PlaylistComponent::loadFromLibrary(int buttonId)
-{
-    if (buttonId % 2 == 0) {  // even ID: load to player 1
-        player1->loadURL(juce::URL{ trackFiles[buttonId / 2] });
-        waveformDisplay.loadURL(juce::URL{ trackFiles[buttonId / 2] });
-    }
-    else if (buttonId % 2 == 1) {  // odd ID: load to player 2
-        player2->loadURL(juce::URL{ trackFiles[buttonId / 2] });
-        waveformDisplay2.loadURL(juce::URL{ trackFiles[buttonId / 2] });
-    }
-}
-
-/**
-*   R1B: Component enables the user to control the playback of a deck somehow.
-*   Set the relative position for waveform so the play head can move in a real time.
-*   The user can trigger a waveform by clicking on a LOAD1/LOAD2 button which calls this function.
-*/
-
-void PlaylistComponent::timerCallback()
-{
-    waveformDisplay.setPositionRelative(player1->getPositionRelative());
-    waveformDisplay2.setPositionRelative(player2->getPositionRelative());
-}
-
-/**
-*   R2A: Component allows the user to add files to their library.
-*   R2D: Component allows the user to load files from the library into a deck.
-*   Perform operations depending on which button is clicked.
-*   @param button the reference of the button.
-*/
-
-void PlaylistComponent::buttonClicked(juce::Button* button)
-{
-    // ADD button is clicked: add music to the library as well as save it to Tracks folder
-    if (button == &addButton) {
-        addFileToLibrary();
-    }
-
-    // LOAD1 or LOAD2 button is clicked: load files from the library    
-    else {
-        int buttonId = std::stoi(button->getComponentID().toStdString());
-        loadFromLibrary(buttonId);
-    }
-}
-
-/**
-*   R2A: Component allows the user to add files to their library.
-*/
-
-void PlaylistComponent::addFileToLibrary()
-{
-    // reset the library first because the vector value maybe changed by search operation
-    resetAll();
-    restoreLibrary();
-
-    juce::FileChooser chooser{ "Select a file..." };
-
-    if (chooser.browseForFileToOpen()) {
-
-        // create Tracks folder if not exist
-        juce::String MyFolderPath(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks");
-        juce::File myFolder(MyFolderPath);
-        if (myFolder.isDirectory() == false)
-        {
-            myFolder.createDirectory();
-        }
-
-        // get the title of the selected file and make a space for the file in Tracks folder
-        juce::String title = chooser.getResult().getFileName();
-        juce::File audioFileCopy(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks/" + title);
-
-        // add if title is not in the library
-        if (!(std::find(trackTitles.begin(), trackTitles.end(), title) != trackTitles.end())) {
-            if (chooser.getResult().copyFileTo(audioFileCopy)) {
-                push_backMetadata(audioFileCopy, title);
-            }
-        }
-        // update the library 
-        tableComponent.updateContent();
-        tableComponent.repaint();
-        return;
-    }
-}
-
-/**
-*   R2B: Component parses and displays metadata such as file name and song length.
-*   Implementation of the pure virtual function of TableListBoxModel class to satisfy this requirement.
-*   Display the file name and the song length by painting the cell.
-*   @param g the graphics to be painted
-*   @param rowNumber the number of the row
-*   @param columnId the id number of the column
-*   @param width the number of width of the cell
-*   @param height the number of height of the cell
-*   @param rowIsSelected true if the row is selected and false otherwise
-*/
-void PlaylistComponent::paintCell(juce::Graphics& g,
-                            int rowNumber, 
-                            int columnId,
-                            int width, 
-                            int height, 
-                            bool rowIsSelected)
-{
-    // display track titles (file names)
-    if (columnId == 0) {
-        g.drawText(trackTitles[rowNumber], 2, 0, width - 4, height,
-            juce::Justification::centredLeft, true);
-    }
-    // display track lengths
-    else if (columnId == 3) {
-        g.drawText(trackLengths[rowNumber], 2, 0, width - 4, height,
-            juce::Justification::centredLeft, true);
-    }
-}
-
-/**
-*   R2B: Component parses and displays metadata such as file name and song length.
-*   Parse the track file's metadata and push it back to vectors to be displayed by paintCell().
-*   @param trackFile the track file in which the metadata to be pushed back
-*/
-
-void PlaylistComponent::push_backMetadata(juce::File trackFile, juce::String title)
-{
-    trackFiles.push_back(trackFile);
-    trackTitles.push_back(title);
-    trackLengths.push_back(getTrackLength(trackFile));
-}
-
-/**
-*   R2B: Component parses and displays metadata such as file name and song length.
-*   Create the reader for the track file, calculate the song length, and convert it to time.
-*   @param trackFile the track file to be read
-*   @return the string of time
-*/
-
-juce::String PlaylistComponent::getTrackLength(juce::File trackFile)
-{
-    juce::AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();   // add basic music file formats
-
-    // create a format reader and calculate the song length
-    juce::AudioFormatReader* formatReader = formatManager.createReaderFor(trackFile);
-    int totalLength = formatReader->lengthInSamples / formatReader->sampleRate;
-
-    // convert the length to time
-    return std::to_string(totalLength / 60) + ":" + std::to_string(totalLength % 60);
-}
-
-/**
-*   R2C: Component allows user to search for files.
-*   Implementation of pure virtual function of TextEditor class to satisfy this requirement.
-*   Display the matched files in the library when return key is pressed after user inputs the keyword.
-*   @param the reference of the text editor value
-*/
-
-void PlaylistComponent::textEditorReturnKeyPressed(juce::TextEditor&)
-{
-    // empty titles and files
-    resetAll();
-
-    juce::String titleKeyword = searchBox.getText();
-    juce::String MyFolderPath(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks");
-    juce::File myFolder(MyFolderPath);
-
-    // go through Tracks folder and display only if the title contains the keyword
-    if (myFolder.isDirectory())
-    {
-        juce::DirectoryIterator iter(juce::File(MyFolderPath), true);
-
-        while (iter.next()) // iterate over the Tracks folder
-        {
-            juce::File theFileItFound(iter.getFile());
-            juce::String title = theFileItFound.getFileName();
-
-            if (title.contains(titleKeyword)) {
-                push_backMetadata(theFileItFound, title);
-            }
-        }
-        // update the library 
-        tableComponent.updateContent();
-        tableComponent.repaint();
-    }
-}
-
-/**
-*   R2D: Component allows the user to load files from the library into a deck.
-*   Refresh component for cell creating the LOAD1 and LOAD2 buttons for each file.
-*   To distinguish the two buttons, even number is assigned to LOAD1 and odd number for LOAD2.  
-*
-*   @param rowNumber the number of the row
-*   @param columnId the id number of the column
-*   @param rowIsSelected true if the row is selected and false otherwise
-*   @param existingComponentToUpdate the component to be updated
-*   @return the updated existing Component
-*/
-
-juce::Component* PlaylistComponent::refreshComponentForCell(
-                            int rowNumber, 
-                            int columnId,
-                            bool rowIsSelected,
-                            Component* existingComponentToUpdate )
-{
-    // create a LOAD1 button
-    if (columnId == 1) {
-        if (existingComponentToUpdate == nullptr) {
-            juce::TextButton* btn = new juce::TextButton("LOAD1");
-            juce::String id{std::to_string(rowNumber * 2)};  // even number of ID
-            btn->setComponentID(id);
-            
-            btn->addListener(this);
-            existingComponentToUpdate = btn;
-
-            btn->setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
-            btn->setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
-        }
-    }
-    // create a LOAD2 button
-    else if (columnId == 2) {
-        if (existingComponentToUpdate == nullptr) {
-            juce::TextButton* btn = new juce::TextButton("LOAD2");
-            juce::String id{ std::to_string(rowNumber * 2 + 1) }; // odd number of ID
-            btn->setComponentID(id);
-
-            btn->addListener(this);
-            existingComponentToUpdate = btn;
-
-            btn->setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
-            btn->setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
-        }
-    }
-    return existingComponentToUpdate;
-}
-
-/**
-*   R2E: The music library persists so that it is restored
-*   when the user exits then restarts the application.
-*   If there is any stored music (Tracks folder exists), restore it to library.
-*/
-
-void PlaylistComponent::restoreLibrary()
-{    
-    juce::String sMyFolderPath(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks");
-    juce::File myFolder(sMyFolderPath);
-    if (myFolder.isDirectory()) // Tracks folder exists
-    {
-        juce::DirectoryIterator iter(juce::File(sMyFolderPath), true);
-
-        while (iter.next()) // iterate over the Tracks folder 
-        {
-            juce::File theFileItFound(iter.getFile());
-            juce::String title = theFileItFound.getFileName();
-            push_backMetadata(theFileItFound, title);
-        }
-        // update the library 
-        tableComponent.updateContent();
-        tableComponent.repaint();
-    }
-}
-
-/** 
-*   Helper: Reset all vectors (trackFiles, trackNames, trackLengths). 
-*/
-
-void PlaylistComponent::resetAll()
-{
-    trackTitles.clear();
-    trackFiles.clear();
-    trackLengths.clear();
-}
+/*
+  ==============================================================================
+
+    PlaylistComponent.cpp
+    Created: 26 Aug 2020 5:25:27am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PlaylistComponent.h"
+#include <algorithm>
+#include <numeric>
+
+//==============================================================================
+class PlaylistComponent::LibraryLoader  : public juce::Thread
+{
+public:
+    LibraryLoader(PlaylistComponent& _owner)
+        : juce::Thread("Library loader"), owner(_owner), index(LibraryIndex::getDefaultIndexFile())
+    {
+    }
+
+    void run() override
+    {
+        index.load();
+
+        // the same walk as restoreLibrary(), reading the song lengths off the message thread
+        juce::File myFolder(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks");
+        if (myFolder.isDirectory()) {
+            juce::DirectoryIterator iter(myFolder, true);
+            while (iter.next()) {
+                if (threadShouldExit())
+                    return;
+
+                // the length is read from the file only the first time it is seen
+                auto trackFile = iter.getFile();
+                auto length = index.getLength(trackFile);
+                if (!index.hasLength(trackFile)) {
+                    TrackTags tags;
+                    length = owner.readTrackMetadata(trackFile, tags);
+                    if (length >= 0.0) {
+                        index.setLength(trackFile, length);
+                        index.setTags(trackFile, tags);
+                    }
+                }
+                trackFiles.push_back(trackFile);
+                trackLengths.push_back(length);
+            }
+        }
+
+        juce::Component::SafePointer<PlaylistComponent> safeOwner(&owner);
+        juce::MessageManager::callAsync([safeOwner] {
+            if (safeOwner != nullptr)
+                safeOwner->finishLibraryLoad();
+        });
+    }
+
+    PlaylistComponent& owner;
+    LibraryIndex index;
+    std::vector<juce::File> trackFiles;
+    std::vector<double> trackLengths;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryLoader)
+};
+
+//==============================================================================
+PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1, DJAudioPlayer* _player2, DeckMixer* mixer,
+                            juce::AudioFormatManager& formatManagerToUse, 
+                            juce::AudioThumbnailCache& cacheToUse,
+                            juce::AudioFormatManager& formatManagerToUse2, 
+                            juce::AudioThumbnailCache& cacheToUse2 )
+                            : player1{ _player1 }, player2{ _player2 }, 
+                            waveformDisplay(formatManagerToUse, cacheToUse), 
+                            waveformDisplay2(formatManagerToUse2, cacheToUse2),
+                            automix(mixer, _player1, _player2)
+    
+{
+    // R2E: the library is restored by loadLibraryAsync() once the window is up
+
+    // create columns for the library, the header uses id 0 for no column so the titles are 6
+    tableComponent.getHeader().addColumn("Track Title", 6, 200);    
+    tableComponent.getHeader().addColumn("Length", 3, 100);
+    tableComponent.getHeader().addColumn("BPM", 4, 70);
+    tableComponent.getHeader().addColumn("Key", 5, 80);
+    // the load buttons stay in the window's 800 pixels, the tags are scrolled to
+    tableComponent.getHeader().addColumn("Load to Deck1", 1, 150, 30, -1, juce::TableHeaderComponent::notSortable);
+    tableComponent.getHeader().addColumn("Load to Deck2", 2, 150, 30, -1, juce::TableHeaderComponent::notSortable);
+    tableComponent.getHeader().addColumn("Artist", 7, 150);
+    tableComponent.getHeader().addColumn("Album", 8, 150);
+    tableComponent.getHeader().addColumn("Genre", 9, 100);
+    tableComponent.getHeader().addColumn("Bitrate", 10, 80);
+    tableComponent.getHeader().addColumn("Format", 11, 110);
+    
+    // add table component 
+    tableComponent.setModel(this);
+    tableComponent.setMultipleSelectionEnabled(true);
+    addAndMakeVisible(tableComponent);
+
+    // add ADD button 
+    addAndMakeVisible(addButton);
+    addButton.addListener(this); 
+
+    // add AUTOMIX button, automix loads its tracks the same way as the LOAD buttons
+    automixButton.setClickingTogglesState(true);
+    addAndMakeVisible(automixButton);
+    automixButton.addListener(this);
+    automix.onLoadTrack = [this](DJAudioPlayer* player, const juce::File& trackFile) {
+        loadTrack(player, trackFile);
+    };
+
+    // add searchBox text editor
+    addAndMakeVisible(searchBox);
+    searchBox.addListener(this);
+
+    // add key filter for harmonic mixing
+    keyFilterBox.addItem("All keys", 1);
+    keyFilterBox.addItem("Keys for Deck1", 2);
+    keyFilterBox.addItem("Keys for Deck2", 3);
+    keyFilterBox.setSelectedId(1, juce::dontSendNotification);
+    addAndMakeVisible(keyFilterBox);
+    keyFilterBox.addListener(this);
+
+    // add crate box, the crates are listed once the library is loaded
+    updateCrateBox();
+    addAndMakeVisible(crateBox);
+    crateBox.addListener(this);
+
+    // add waveforms
+    addAndMakeVisible(waveformDisplay);
+    addAndMakeVisible(waveformDisplay2);
+    startTimer(500);
+
+    // hot cues set on the decks are stored with the tracks
+    player1->addChangeListener(this);
+    player2->addChangeListener(this);
+}
+
+PlaylistComponent::~PlaylistComponent()
+{
+    if (libraryLoader != nullptr)
+        libraryLoader->stopThread(2000);
+
+    player1->removeChangeListener(this);
+    player2->removeChangeListener(this);
+
+    if (library.needsSaving())
+        library.save();
+}
+
+/**
+*   Set the location (counds) for the add button, the search box, and the table component.
+*/
+void PlaylistComponent::resized()
+{
+    double rowH = getHeight() / 8;
+
+    // set bounds for widgets
+    waveformDisplay.setBounds(0, 0, getWidth() / 2, rowH * 2.5);
+    waveformDisplay2.setBounds(getWidth() / 2, 0, getWidth() / 2, rowH * 2.5);
+    addButton.setBounds(0, rowH * 2.5, getWidth() / 5, rowH * 0.7);
+    automixButton.setBounds(getWidth() / 5, rowH * 2.5, getWidth() / 5, rowH * 0.7);
+    crateBox.setBounds(getWidth() / 5 * 2, rowH * 2.5, getWidth() / 5, rowH * 0.7);
+    searchBox.setBounds(getWidth() / 5 * 3, rowH * 2.5, getWidth() / 5, rowH * 0.7);
+    keyFilterBox.setBounds(getWidth() / 5 * 4, rowH * 2.5, getWidth() / 5, rowH * 0.7);
+    tableComponent.setBounds(0, rowH * 3.2, getWidth(), rowH * 4.8);
+    
+}
+
+/**
+*   Get the number of rows in the table component.
+*   @return the number of rows.
+*/
+int PlaylistComponent::getNumRows()
+{
+    return trackTitles.size();
+}
+
+/**
+*   Paint the row background. 
+*   @param g the graphics to be painted
+*   @param rowNumber the number of the row
+*   @param width the number of width of the row
+*   @param height the number of height of the row
+*   @param rowIsSelected true if the row is selected and false otherwise
+*/
+void PlaylistComponent::paintRowBackground(juce::Graphics& g, 
+                            int rowNumber, 
+                            int width, 
+                            int height, 
+                            bool rowIsSelected )
+{
+    if (rowIsSelected) {
+        g.fillAll(juce::Colour(115, 181, 221)); // use same color with waveform
+    }
+    else {
+        g.fillAll(juce::Colours::white);
+    }
+}
+
+/**
+*   R1A: Component has custom graphics implemented in a paint function.
+*   Set the custom styles and colors for widgets.
+*   @param g the graphics to be painted
+*/
+
+void PlaylistComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));   // clear the background
+
+    g.setColour(juce::Colours::grey);
+    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
+
+    g.setColour(juce::Colours::black);
+    g.setFont(14.0f);
+    g.drawText("PlaylistComponent", getLocalBounds(),
+        juce::Justification::centred, true);   // draw some placeholder text
+
+    // set color for the add button and its text
+    addButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 53, 90));
+    addButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+
+    // the automix button lights up while automix runs
+    automixButton.setColour(juce::TextButton::buttonColourId, juce::Colour(34, 53, 70));
+    automixButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(255, 53, 90));
+    automixButton.setColour(juce::TextButton::textColourOffId, juce::Colour(255, 53, 90));
+    automixButton.setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+
+    // set default text to show on a search box as well as set color
+    searchBox.setTextToShowWhenEmpty("Search...", juce::Colours::darkgrey);
+    searchBox.setColour(juce::TextEditor::backgroundColourId, juce::Colour(255, 255, 255));
+    searchBox.setColour(juce::TextEditor::textColourId, juce::Colours::darkgrey);
+}
+
+/**
+*   R1B: Component enables the user to control the playback of a deck somehow.
+*   R2D: Component allows the user to load files from the library into a deck.
+*   If LOAD1 or LOAD2 button is clicked, load a track to a subjected deck and to a waveform.
+*   @param buttonId the button id number
+*/
+
+void PlaylistComponent::loadFromLibrary(int buttonId)
+{
+    if (buttonId % 2 == 0) {  // even ID: load to player 1
+        loadTrack(player1, trackFiles[buttonId / 2]);
+    }
+    else if (buttonId % 2 == 1) {  // odd ID: load to player 2
+        loadTrack(player2, trackFiles[buttonId / 2]);
+    }
+}
+
+/**
+*   Load a track to a deck and to its waveform, with the track's analysis and hot cues.
+*   @param player the deck to load the track to
+*   @param trackFile the track file to be loaded
+*/
+
+void PlaylistComponent::loadTrack(DJAudioPlayer* player, juce::File trackFile)
+{
+    auto& waveform = player == player1 ? waveformDisplay : waveformDisplay2;
+    player->loadURL(juce::URL{ trackFile });
+    waveform.loadURL(juce::URL{ trackFile });
+    loadTrackAnalysis(player, trackFile);
+    player->setHotCues(library.getHotCues(trackFile));
+}
+
+/**
+*   Start automix with the selected tracks, or with every listed track if none is selected.
+*/
+
+void PlaylistComponent::startAutomix()
+{
+    juce::Array<juce::File> queue;
+    auto selected = tableComponent.getSelectedRows();
+    if (selected.size() > 0) {
+        for (int i = 0; i < selected.size(); ++i)
+            if (selected[i] < (int) trackFiles.size())
+                queue.add(trackFiles[selected[i]]);
+    }
+    else {
+        for (auto& trackFile : trackFiles)
+            queue.add(trackFile);
+    }
+    automix.start(queue);
+}
+
+/**
+*   R1B: Component enables the user to control the playback of a deck somehow.
+*   Set the relative position for waveform so the play head can move in a real time.
+*   The user can trigger a waveform by clicking on a LOAD1/LOAD2 button which calls this function.
+*/
+
+void PlaylistComponent::timerCallback()
+{
+    waveformDisplay.setPositionRelative(player1->getPositionRelative());
+    waveformDisplay2.setPositionRelative(player2->getPositionRelative());
+    collectAnalysisResults();
+
+    // automix stops by itself at the end of its queue
+    automixButton.setToggleState(automix.isRunning(), juce::dontSendNotification);
+}
+
+/**
+*   R2A: Component allows the user to add files to their library.
+*   R2D: Component allows the user to load files from the library into a deck.
+*   Perform operations depending on which button is clicked.
+*   @param button the reference of the button.
+*/
+
+void PlaylistComponent::buttonClicked(juce::Button* button)
+{
+    // ADD button is clicked: add music to the library as well as save it to Tracks folder
+    if (button == &addButton) {
+        addFileToLibrary();
+    }
+
+    // AUTOMIX button is clicked: play the library unattended, or stop doing so
+    else if (button == &automixButton) {
+        if (automixButton.getToggleState())
+            startAutomix();
+        else
+            automix.stop();
+        automixButton.setToggleState(automix.isRunning(), juce::dontSendNotification);
+    }
+
+    // LOAD1 or LOAD2 button is clicked: load files from the library    
+    else {
+        int buttonId = std::stoi(button->getComponentID().toStdString());
+        loadFromLibrary(buttonId);
+    }
+}
+
+/**
+*   R2A: Component allows the user to add files to their library.
+*/
+
+void PlaylistComponent::addFileToLibrary()
+{
+    // reset the library first because the vector value maybe changed by search operation
+    resetAll();
+    restoreLibrary();
+
+    juce::FileChooser chooser{ "Select a file..." };
+
+    if (chooser.browseForFileToOpen()) {
+        copyFileToLibrary(chooser.getResult());
+
+        // update the library, keeping the sort order
+        tableComponent.getHeader().reSortTable();
+        tableComponent.updateContent();
+        tableComponent.repaint();
+        return;
+    }
+}
+
+/**
+*   R2A: Component allows the user to add files to their library.
+*   Copy a track file to the Tracks folder and list it, unless a track with its title is listed.
+*   @param sourceFile the track file to be added
+*   @return true if the track was added
+*/
+
+bool PlaylistComponent::copyFileToLibrary(juce::File sourceFile)
+{
+    // create Tracks folder if not exist
+    juce::String MyFolderPath(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks");
+    juce::File myFolder(MyFolderPath);
+    if (myFolder.isDirectory() == false)
+    {
+        myFolder.createDirectory();
+    }
+
+    // get the title of the selected file and make a space for the file in Tracks folder
+    juce::String title = sourceFile.getFileName();
+    juce::File audioFileCopy(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks/" + title);
+
+    // add if title is not in the library
+    if (!(std::find(trackTitles.begin(), trackTitles.end(), title) != trackTitles.end())) {
+        if (sourceFile.copyFileTo(audioFileCopy)) {
+            push_backMetadata(audioFileCopy, title);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+*   R2B: Component parses and displays metadata such as file name and song length.
+*   Implementation of the pure virtual function of TableListBoxModel class to satisfy this requirement.
+*   Display the file name and the song length by painting the cell.
+*   @param g the graphics to be painted
+*   @param rowNumber the number of the row
+*   @param columnId the id number of the column
+*   @param width the number of width of the cell
+*   @param height the number of height of the cell
+*   @param rowIsSelected true if the row is selected and false otherwise
+*/
+void PlaylistComponent::paintCell(juce::Graphics& g,
+                            int rowNumber, 
+                            int columnId,
+                            int width, 
+                            int height, 
+                            bool rowIsSelected)
+{
+    // display track titles (file names)
+    if (columnId == 6) {
+        g.drawText(trackTitles[rowNumber], 2, 0, width - 4, height,
+            juce::Justification::centredLeft, true);
+    }
+    // display track lengths
+    else if (columnId == 3) {
+        g.drawText(trackLengths[rowNumber], 2, 0, width - 4, height,
+            juce::Justification::centredLeft, true);
+    }
+    // display tempos, once analysed
+    else if (columnId == 4) {
+        juce::String bpm = "...";
+        if (library.isAnalysed(trackFiles[rowNumber])) {
+            auto analysis = library.getAnalysis(trackFiles[rowNumber]);
+            bpm = analysis.bpm > 0 ? juce::String(analysis.bpm, 1) : "-";
+        }
+        g.drawText(bpm, 2, 0, width - 4, height,
+            juce::Justification::centredLeft, true);
+    }
+    // display keys with their Camelot notation, once analysed
+    else if (columnId == 5) {
+        juce::String key = "...";
+        if (library.isAnalysed(trackFiles[rowNumber])) {
+            auto analysis = library.getAnalysis(trackFiles[rowNumber]);
+            key = analysis.key >= 0 ? KeyAnalyser::getKeyName(analysis.key) + " (" + KeyAnalyser::getCamelotName(analysis.key) + ")" : "-";
+        }
+        g.drawText(key, 2, 0, width - 4, height,
+            juce::Justification::centredLeft, true);
+    }
+    // display the tags and the format, read with the length
+    else if (columnId >= 7 && columnId <= 11) {
+        auto tags = library.getTags(trackFiles[rowNumber]);
+        juce::String text;
+        if (columnId == 7)
+            text = tags.artist;
+        else if (columnId == 8)
+            text = tags.album;
+        else if (columnId == 9)
+            text = tags.genre;
+        else if (columnId == 10 && tags.bitrate > 0)
+            text = juce::String(tags.bitrate) + " kbps";
+        else if (columnId == 11 && tags.sampleRate > 0.0) {
+            juce::String channels = tags.numChannels == 1 ? "mono" : tags.numChannels == 2 ? "stereo" : juce::String(tags.numChannels) + " ch";
+            text = juce::String(tags.sampleRate / 1000.0, 1) + " kHz " + channels;
+        }
+        g.drawText(text, 2, 0, width - 4, height,
+            juce::Justification::centredLeft, true);
+    }
+}
+
+/**
+*   R2B: Component parses and displays metadata such as file name and song length.
+*   Parse the track file's metadata and push it back to vectors to be displayed by paintCell().
+*   @param trackFile the track file in which the metadata to be pushed back
+*/
+
+void PlaylistComponent::push_backMetadata(juce::File trackFile, juce::String title)
+{
+    // the length and the tags are read from the file only if the library index has none for it
+    if (library.hasLength(trackFile)) {
+        push_backMetadata(trackFile, title, library.getLength(trackFile));
+        return;
+    }
+
+    TrackTags tags;
+    auto length = readTrackMetadata(trackFile, tags);
+    if (length >= 0.0) {
+        library.setLength(trackFile, length);
+        library.setTags(trackFile, tags);
+    }
+    push_backMetadata(trackFile, title, length);
+}
+
+/**
+*   R2B: Component parses and displays metadata such as file name and song length.
+*   Push back the metadata of a track file whose length has been read already.
+*   @param trackFile the track file in which the metadata to be pushed back
+*   @param title the title to be displayed
+*   @param lengthInSeconds the song length returned by getTrackLengthInSeconds()
+*/
+
+void PlaylistComponent::push_backMetadata(juce::File trackFile, juce::String title, double lengthInSeconds)
+{
+    trackFiles.push_back(trackFile);
+    trackTitles.push_back(title);
+    trackLengths.push_back(formatTrackLength(lengthInSeconds));
+    libraryTracks[library.getTrackId(trackFile)] = trackFile;
+
+    // analyse the tempo in the background if the index has no up to date result;
+    // hasLength() has just checked the entry against the file, here or on the loader
+    if (!library.isAnalysed(trackFile) && !analyser.isAnalysing(trackFile))
+        analyser.analyse(trackFile);
+}
+
+/**
+*   R2B: Component parses and displays metadata such as file name and song length.
+*   Create the reader for the track file, calculate the song length, and convert it to time.
+*   @param trackFile the track file to be read
+*   @return the string of time
+*/
+
+juce::String PlaylistComponent::getTrackLength(juce::File trackFile)
+{
+    return formatTrackLength(getTrackLengthInSeconds(trackFile));
+}
+
+/**
+*   R2B: Component parses and displays metadata such as file name and song length.
+*   Create the reader for the track file and calculate the song length.
+*   @param trackFile the track file to be read
+*   @return the song length in seconds, -1 if the file could not be read
+*/
+
+double PlaylistComponent::getTrackLengthInSeconds(juce::File trackFile)
+{
+    TrackTags tags;
+    return readTrackMetadata(trackFile, tags);
+}
+
+/**
+*   R2B: Component parses and displays metadata such as file name and song length.
+*   Create the reader for the track file, calculate the song length and read the tags and the format,
+*   so a track is only opened once.
+*   @param trackFile the track file to be read
+*   @param tags filled in with the artist, album, genre, sample rate, channels and bitrate
+*   @return the song length in seconds, -1 if the file could not be read
+*/
+
+double PlaylistComponent::readTrackMetadata(juce::File trackFile, TrackTags& tags)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();   // add basic music file formats
+
+    // create a format reader and calculate the song length, the reader closes the file when deleted
+    std::unique_ptr<juce::AudioFormatReader> formatReader(formatManager.createReaderFor(trackFile));
+    if (formatReader == nullptr || formatReader->sampleRate <= 0.0) {
+        std::cout << "PlaylistComponent::getTrackLength could not read " << trackFile.getFullPathName() << std::endl;
+        return -1.0;
+    }
+    double length = formatReader->lengthInSamples / formatReader->sampleRate;
+
+    // each format names its tags differently: RIFF INFO in WAV, Vorbis comments in Ogg,
+    // ID3 frames and plain names from the platform readers; the keys are not case sensitive
+    auto& metadata = formatReader->metadataValues;
+    auto findTag = [&metadata](std::initializer_list<const char*> keys) {
+        for (auto* key : keys)
+            if (metadata.getValue(key, {}).trim().isNotEmpty())
+                return metadata.getValue(key, {}).trim();
+        return juce::String();
+    };
+    tags.artist = findTag({ "IART", "id3artist", "artist", "TPE1" });
+    tags.album = findTag({ "IPRD", "id3album", "album", "TALB" });
+    tags.genre = findTag({ "IGNR", "GENR", "id3genre", "genre", "TCON" });
+
+    // the format, with the bitrate averaged over the whole file so compressed files get theirs too
+    tags.sampleRate = formatReader->sampleRate;
+    tags.numChannels = (int) formatReader->numChannels;
+    if (formatReader->input != nullptr && length > 0.0)
+        tags.bitrate = juce::roundToInt(formatReader->input->getTotalLength() * 8.0 / length / 1000.0);
+
+    return length;
+}
+
+/**
+*   Convert a song length to the time shown in the Length column.
+*   @param lengthInSeconds the song length, negative if it is not known
+*   @return the string of time, "-" if the length is not known
+*/
+
+juce::String PlaylistComponent::formatTrackLength(double lengthInSeconds)
+{
+    if (lengthInSeconds < 0.0)
+        return "-";
+
+    // convert the length to time, 64 bit so long recordings don't overflow
+    auto totalLength = (juce::int64) lengthInSeconds;
+    return juce::String(totalLength / 60) + ":" + juce::String(totalLength % 60).paddedLeft('0', 2);
+}
+
+/**
+*   R2C: Component allows user to search for files.
+*   Implementation of pure virtual function of TextEditor class to satisfy this requirement.
+*   Display the matched files in the library when return key is pressed after user inputs the keyword.
+*   @param the reference of the text editor value
+*/
+
+void PlaylistComponent::textEditorReturnKeyPressed(juce::TextEditor&)
+{
+    searchLibrary(searchBox.getText());
+}
+
+/**
+*   R2C: Component allows user to search for files.
+*   List only the tracks of the shown crate whose title or tags contain the keyword and which pass the key filter.
+*   The list is built from the library index, without reading the Tracks folder again.
+*   @param titleKeyword the keyword, an empty one matches every track
+*/
+
+void PlaylistComponent::searchLibrary(juce::String titleKeyword)
+{
+    // empty titles and files
+    resetAll();
+
+    // the tracks of the crate in its order, or every track in the library
+    juce::Array<int> trackIds;
+    if (currentCrate >= 0) {
+        trackIds = library.getCrateTracks(currentCrate);
+    }
+    else {
+        for (auto& track : libraryTracks)
+            trackIds.add(track.first);
+    }
+
+    // display only if the title or a tag contains the keyword, the lengths and tags are in the index already
+    for (auto trackId : trackIds) {
+        auto track = libraryTracks.find(trackId);
+        if (track == libraryTracks.end())   // in a crate, but no longer in the Tracks folder
+            continue;
+
+        juce::String title = library.getTitle(trackId);
+        auto tags = library.getTags(trackId);
+        bool matchesKeyword = title.containsIgnoreCase(titleKeyword) || tags.artist.containsIgnoreCase(titleKeyword)
+                              || tags.album.containsIgnoreCase(titleKeyword) || tags.genre.containsIgnoreCase(titleKeyword);
+
+        if (matchesKeyword && matchesKeyFilter(track->second)) {
+            trackFiles.push_back(track->second);
+            trackTitles.push_back(title);
+            trackLengths.push_back(formatTrackLength(library.getLength(trackId)));
+        }
+    }
+
+    // update the library, keeping the sort order
+    tableComponent.getHeader().reSortTable();
+    tableComponent.updateContent();
+    tableComponent.repaint();
+}
+
+/**
+*   Show the tracks of a crate, in its order, or every track in the library.
+*   @param crateIndex the crate in the library index, -1 for every track
+*/
+
+void PlaylistComponent::showCrate(int crateIndex)
+{
+    currentCrate = juce::isPositiveAndBelow(crateIndex, library.getNumCrates()) ? crateIndex : -1;
+    updateCrateBox();
+
+    // a crate is shown in its own order until a column is clicked
+    tableComponent.getHeader().setSortColumnId(0, true);
+    tableComponent.deselectAllRows();
+    searchLibrary(searchBox.getText());
+}
+
+/**
+*   Harmonic mixing: apply the key filter when another deck is chosen to match.
+*   @param comboBox the reference of the combo box
+*/
+
+void PlaylistComponent::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    // another crate: item ids are 1 for every track and 10 + index for the crates
+    if (comboBox == &crateBox) {
+        showCrate(crateBox.getSelectedId() == 1 ? -1 : crateBox.getSelectedId() - 10);
+        return;
+    }
+
+    // the filter is applied together with the keyword search
+    textEditorReturnKeyPressed(searchBox);
+}
+
+/**
+*   Check a track against the key filter.
+*   @param trackFile the track file to be checked
+*   @return true if the filter is off, or the track's key mixes with the chosen deck's key
+*/
+
+bool PlaylistComponent::matchesKeyFilter(juce::File trackFile)
+{
+    if (keyFilterBox.getSelectedId() <= 1)
+        return true;
+
+    auto* player = keyFilterBox.getSelectedId() == 2 ? player1 : player2;
+    auto deckKey = library.getAnalysis(player->getLoadedURL().getLocalFile()).key;
+
+    // nothing to match against until the deck's track is loaded and analysed
+    if (deckKey < 0)
+        return true;
+
+    return KeyAnalyser::areCompatible(deckKey, library.getAnalysis(trackFile).key);
+}
+
+/**
+*   R2D: Component allows the user to load files from the library into a deck.
+*   Refresh component for cell creating the LOAD1 and LOAD2 buttons for each file.
+*   To distinguish the two buttons, even number is assigned to LOAD1 and odd number for LOAD2.  
+*
+*   @param rowNumber the number of the row
+*   @param columnId the id number of the column
+*   @param rowIsSelected true if the row is selected and false otherwise
+*   @param existingComponentToUpdate the component to be updated
+*   @return the updated existing Component
+*/
+
+juce::Component* PlaylistComponent::refreshComponentForCell(
+                            int rowNumber, 
+                            int columnId,
+                            bool rowIsSelected,
+                            Component* existingComponentToUpdate )
+{
+    // create a LOAD1 button
+    if (columnId == 1) {
+        if (existingComponentToUpdate == nullptr) {
+            juce::TextButton* btn = new juce::TextButton("LOAD1");
+            btn->addListener(this);
+            existingComponentToUpdate = btn;
+
+            btn->setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+            btn->setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+        }
+    }
+    // create a LOAD2 button
+    else if (columnId == 2) {
+        if (existingComponentToUpdate == nullptr) {
+            juce::TextButton* btn = new juce::TextButton("LOAD2");
+            btn->addListener(this);
+            existingComponentToUpdate = btn;
+
+            btn->setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+            btn->setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+        }
+    }
+
+    // the buttons are reused for other rows when the table scrolls or is sorted, so the IDs follow the row
+    if (columnId == 1 && existingComponentToUpdate != nullptr) {
+        existingComponentToUpdate->setComponentID(juce::String(rowNumber * 2));  // even number of ID
+    }
+    else if (columnId == 2 && existingComponentToUpdate != nullptr) {
+        existingComponentToUpdate->setComponentID(juce::String(rowNumber * 2 + 1)); // odd number of ID
+    }
+    return existingComponentToUpdate;
+}
+
+/**
+*   R2E: The music library persists so that it is restored
+*   when the user exits then restarts the application.
+*   If there is any stored music (Tracks folder exists), restore it to library.
+*/
+
+void PlaylistComponent::restoreLibrary()
+{    
+    // every track is listed again, so the crate box goes back to all of them
+    libraryTracks.clear();
+    currentCrate = -1;
+    updateCrateBox();
+
+    juce::String sMyFolderPath(juce::File::getCurrentWorkingDirectory().getFullPathName() + "/Tracks");
+    juce::File myFolder(sMyFolderPath);
+    if (myFolder.isDirectory()) // Tracks folder exists
+    {
+        juce::DirectoryIterator iter(juce::File(sMyFolderPath), true);
+
+        while (iter.next()) // iterate over the Tracks folder 
+        {
+            juce::File theFileItFound(iter.getFile());
+            juce::String title = theFileItFound.getFileName();
+            push_backMetadata(theFileItFound, title);
+        }
+        // update the library, keeping the sort order
+        tableComponent.getHeader().reSortTable();
+        tableComponent.updateContent();
+        tableComponent.repaint();
+    }
+}
+
+/**
+*   R2E: Restore the library on a background thread: the index, the Tracks folder and the song lengths.
+*   The tracks are listed and queued for analysis on the message thread once it is done,
+*   and the controls which change the list are disabled until then.
+*/
+
+void PlaylistComponent::loadLibraryAsync()
+{
+    if (libraryLoader != nullptr)
+        return;
+
+    setLibraryControlsEnabled(false);
+    libraryLoader = std::make_unique<LibraryLoader>(*this);
+    libraryLoader->startThread(3);
+}
+
+/**
+*   List the tracks found by the loader and take over the index it loaded.
+*/
+
+void PlaylistComponent::finishLibraryLoad()
+{
+    // the loader posted this as the last thing it did
+    libraryLoader->waitForThreadToExit(-1);
+    library.swapWith(libraryLoader->index);
+
+    resetAll();
+    libraryTracks.clear();
+    currentCrate = -1;
+    for (size_t i = 0; i < libraryLoader->trackFiles.size(); ++i) {
+        auto& trackFile = libraryLoader->trackFiles[i];
+        push_backMetadata(trackFile, trackFile.getFileName(), libraryLoader->trackLengths[i]);
+    }
+    libraryLoader.reset();
+    updateCrateBox();
+
+    // tracks loaded onto the decks meanwhile, e.g. by a restored session
+    for (auto* player : { player1, player2 }) {
+        auto trackFile = player->getLoadedURL().getLocalFile();
+        if (trackFile.existsAsFile())
+            loadTrackAnalysis(player, trackFile);
+    }
+
+    // update the library, keeping the sort order
+    tableComponent.getHeader().reSortTable();
+    tableComponent.updateContent();
+    tableComponent.repaint();
+    setLibraryControlsEnabled(true);
+
+    if (onLibraryLoaded)
+        onLibraryLoaded();
+}
+
+/**
+*   Enable or disable the controls which change the listed tracks.
+*   @param shouldBeEnabled false while the library is loading
+*/
+
+void PlaylistComponent::setLibraryControlsEnabled(bool shouldBeEnabled)
+{
+    addButton.setEnabled(shouldBeEnabled);
+    automixButton.setEnabled(shouldBeEnabled);
+    searchBox.setEnabled(shouldBeEnabled);
+    keyFilterBox.setEnabled(shouldBeEnabled);
+    crateBox.setEnabled(shouldBeEnabled);
+}
+
+/**
+*   Sort the listed tracks when a column header is clicked, and again whenever the list is rebuilt.
+*   @param newSortColumnId the id of the column to sort by, 0 for none
+*   @param isForwards true for ascending order
+*/
+
+void PlaylistComponent::sortOrderChanged(int newSortColumnId, bool isForwards)
+{
+    if (newSortColumnId == 0)
+        return;
+
+    // one key per row, worked out before sorting so the comparisons don't look anything up
+    std::vector<double> keys(trackFiles.size());
+    std::vector<juce::String> textKeys(newSortColumnId >= 7 && newSortColumnId <= 9 ? trackFiles.size() : 0);
+    for (size_t i = 0; i < trackFiles.size(); ++i) {
+        if (newSortColumnId == 3) {
+            keys[i] = library.getLength(trackFiles[i]);
+        }
+        else if (newSortColumnId >= 7 && newSortColumnId <= 11) {
+            auto tags = library.getTags(trackFiles[i]);
+            if (newSortColumnId == 7)
+                textKeys[i] = tags.artist;
+            else if (newSortColumnId == 8)
+                textKeys[i] = tags.album;
+            else if (newSortColumnId == 9)
+                textKeys[i] = tags.genre;
+            else if (newSortColumnId == 10)
+                keys[i] = tags.bitrate;
+            else   // by sample rate, then by channels
+                keys[i] = tags.sampleRate * 100.0 + tags.numChannels;
+        }
+        else if (newSortColumnId == 4 || newSortColumnId == 5) {
+            // tracks which are not analysed yet go first
+            keys[i] = -1.0;
+            if (library.isAnalysed(trackFiles[i])) {
+                auto analysis = library.getAnalysis(trackFiles[i]);
+                if (newSortColumnId == 4)
+                    keys[i] = analysis.bpm;
+                else if (analysis.key >= 0)   // around the Camelot wheel, minor before major
+                    keys[i] = KeyAnalyser::getCamelotName(analysis.key).getIntValue() * 2 + (analysis.key >= 12 ? 0 : 1);
+            }
+        }
+    }
+
+    std::vector<size_t> order(trackFiles.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (!isForwards)
+            std::swap(a, b);
+        if (newSortColumnId == 6)
+            return trackTitles[a].compareNatural(trackTitles[b]) < 0;
+        if (!textKeys.empty())
+            return textKeys[a].compareNatural(textKeys[b]) < 0;
+        return keys[a] < keys[b];
+    });
+
+    // move the rows into the new order
+    std::vector<juce::String> sortedTitles, sortedLengths;
+    std::vector<juce::File> sortedFiles;
+    sortedTitles.reserve(order.size());
+    sortedFiles.reserve(order.size());
+    sortedLengths.reserve(order.size());
+    for (auto i : order) {
+        sortedTitles.push_back(trackTitles[i]);
+        sortedFiles.push_back(trackFiles[i]);
+        sortedLengths.push_back(trackLengths[i]);
+    }
+    trackTitles.swap(sortedTitles);
+    trackFiles.swap(sortedFiles);
+    trackLengths.swap(sortedLengths);
+
+    tableComponent.updateContent();
+    tableComponent.repaint();
+}
+
+/** 
+*   Helper: Reset all vectors (trackFiles, trackNames, trackLengths). 
+*/
+
+void PlaylistComponent::resetAll()
+{
+    trackTitles.clear();
+    trackFiles.clear();
+    trackLengths.clear();
+}
+
+
+/**
+*   Store the analysis results finished since the last call in the library index,
+*   and write the index once the analyser has nothing left to do.
+*/
+
+void PlaylistComponent::collectAnalysisResults()
+{
+    std::vector<TrackAnalyser::Result> results;
+    analyser.collectResults(results);
+
+    for (auto& result : results) {
+        library.setAnalysis(result.trackFile, result.analysis);
+
+        // a deck may be waiting for this track's analysis
+        for (auto* player : { player1, player2 })
+            if (player->getLoadedURL().getLocalFile() == result.trackFile)
+                applyTrackAnalysis(player, result.analysis);
+    }
+
+    if (!results.empty())
+        tableComponent.repaint();
+
+    if (library.needsSaving() && !analyser.isBusy())
+        library.save();
+}
+
+/**
+*   Give a deck the analysis of the track loaded into it, analysing the track first if needed.
+*   @param player the deck the track is loaded into
+*   @param trackFile the loaded track file
+*/
+
+void PlaylistComponent::loadTrackAnalysis(DJAudioPlayer* player, juce::File trackFile)
+{
+    // the index is not in yet, finishLibraryLoad() comes back to the decks
+    if (libraryLoader != nullptr)
+        return;
+
+    if (library.hasAnalysis(trackFile)) {
+        applyTrackAnalysis(player, library.getAnalysis(trackFile));
+    }
+    else {
+        // the deck is waiting for it, so it goes ahead of any import backlog
+        analyser.analyse(trackFile, true);
+    }
+}
+
+/**
+*   Hand the beatgrid, the loudness and the auto-cue points of a track to a deck and its waveform.
+*   @param player the deck the track is loaded into
+*   @param analysis the analysis of the track
+*/
+
+void PlaylistComponent::applyTrackAnalysis(DJAudioPlayer* player, const TrackAnalysis& analysis)
+{
+    player->setBeatgrid(analysis.bpm, analysis.downbeatOffset);
+    player->setLoudness(analysis.loudness, analysis.truePeak);
+    player->setAutoCuePoints(analysis.autoCue, analysis.autoEnd);
+
+    auto& waveform = player == player1 ? waveformDisplay : waveformDisplay2;
+    waveform.setAutoCuePoints(analysis.autoCue, analysis.autoEnd);
+}
+
+/**
+*   Store the hot cues of a deck's track in the library when the user changes them.
+*   The index is written by the timer, together with the analysis results.
+*   @param source the deck whose hot cues changed
+*/
+
+void PlaylistComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    for (auto* player : { player1, player2 }) {
+        auto trackFile = player->getLoadedURL().getLocalFile();
+        if (source == player && trackFile.existsAsFile())
+            library.setHotCues(trackFile, player->getHotCues());
+    }
+}
+
+/**
+*   List the crates of the library index in the crate box, keeping the shown one selected.
+*/
+
+void PlaylistComponent::updateCrateBox()
+{
+    // item ids: 1 for every track, 10 + index for the crates
+    crateBox.clear(juce::dontSendNotification);
+    crateBox.addItem("All tracks", 1);
+    for (int i = 0; i < library.getNumCrates(); ++i) {
+        auto crate = library.getCrate(i);
+        crateBox.addItem(crate.smart ? crate.name + " (smart)" : crate.name, 10 + i);
+    }
+    crateBox.setSelectedId(currentCrate >= 0 ? 10 + currentCrate : 1, juce::dontSendNotification);
+}
+
+/**
+*   Show the crate menu for the selected tracks when a row is right-clicked.
+*   @param rowNumber the number of the row
+*   @param columnId the id number of the column
+*   @param e the mouse event
+*/
+
+void PlaylistComponent::cellClicked(int rowNumber, int columnId, const juce::MouseEvent& e)
+{
+    if (!e.mods.isPopupMenu())
+        return;
+
+    // the clicked row joins the selection unless it is part of it already
+    if (!tableComponent.isRowSelected(rowNumber))
+        tableComponent.selectRow(rowNumber);
+    showCrateMenu();
+}
+
+/**
+*   Show the crate menu when the empty part of the table is right-clicked.
+*   @param e the mouse event
+*/
+
+void PlaylistComponent::backgroundClicked(const juce::MouseEvent& e)
+{
+    if (e.mods.isPopupMenu()) {
+        tableComponent.deselectAllRows();
+        showCrateMenu();
+    }
+}
+
+/**
+*   Show the menu to add the selected tracks to a crate, or to make, edit or delete one.
+*/
+
+void PlaylistComponent::showCrateMenu()
+{
+    if (!crateBox.isEnabled())
+        return;
+
+    auto trackIds = getSelectedTrackIds();
+    auto crate = library.getCrate(currentCrate);
+
+    // item ids: 100 + index to add the selected tracks to a crate
+    juce::PopupMenu menu;
+    juce::PopupMenu addMenu;
+    for (int i = 0; i < library.getNumCrates(); ++i)
+        if (!library.getCrate(i).smart)
+            addMenu.addItem(100 + i, library.getCrate(i).name);
+    addMenu.addSeparator();
+    addMenu.addItem(1, "New crate...");
+    menu.addSubMenu("Add to crate", addMenu, !trackIds.isEmpty());
+
+    if (currentCrate >= 0 && !crate.smart)
+        menu.addItem(2, "Remove from crate", !trackIds.isEmpty());
+
+    menu.addSeparator();
+    menu.addItem(3, "New smart crate...");
+    if (currentCrate >= 0 && crate.smart)
+        menu.addItem(4, "Edit smart crate...");
+    if (currentCrate >= 0)
+        menu.addItem(5, "Delete crate \"" + crate.name + "\"");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&tableComponent), [this, trackIds](int result) {
+        if (result == 1) {
+            editCrate(-1, false, trackIds);
+        }
+        else if (result == 2) {
+            library.removeFromCrate(currentCrate, trackIds);
+            showCrate(currentCrate);
+        }
+        else if (result == 3) {
+            editCrate(-1, true, {});
+        }
+        else if (result == 4) {
+            editCrate(currentCrate, true, {});
+        }
+        else if (result == 5) {
+            library.removeCrate(currentCrate);
+            showCrate(-1);
+        }
+        else if (result >= 100) {
+            library.addToCrate(result - 100, trackIds);
+            if (currentCrate == result - 100)
+                showCrate(currentCrate);
+        }
+    });
+}
+
+/**
+*   Ask for a crate's name, and for a smart crate its filter, then store it in the library index.
+*   @param crateIndex the crate to edit, -1 for a new one
+*   @param smart true for a smart crate
+*   @param trackIds the tracks to put in a new crate which is not smart
+*/
+
+void PlaylistComponent::editCrate(int crateIndex, bool smart, juce::Array<int> trackIds)
+{
+    auto crate = library.getCrate(crateIndex);
+    crate.smart = smart;
+
+    // the limits are shown empty when there are none, the lengths in minutes
+    auto limit = [](double value) { return value > 0.0 ? juce::String(value) : juce::String(); };
+
+    crateDialog = std::make_unique<juce::AlertWindow>(crateIndex < 0 ? (smart ? "New smart crate" : "New crate") : "Edit smart crate",
+                                                      smart ? "Tracks matching every field are listed, empty fields match any track." : "",
+                                                      juce::AlertWindow::NoIcon);
+    crateDialog->addTextEditor("name", crate.name.isEmpty() ? juce::String("Crate ") + juce::String(library.getNumCrates() + 1) : crate.name, "Name");
+    if (smart) {
+        crateDialog->addTextEditor("keyword", crate.keyword, "Title or tags contain");
+        crateDialog->addTextEditor("minBpm", limit(crate.minBpm), "BPM from");
+        crateDialog->addTextEditor("maxBpm", limit(crate.maxBpm), "BPM to");
+        crateDialog->addTextEditor("minLength", limit(crate.minLength / 60.0), "Length from (minutes)");
+        crateDialog->addTextEditor("maxLength", limit(crate.maxLength / 60.0), "Length to (minutes)");
+    }
+    crateDialog->addButton("OK", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    crateDialog->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    juce::Component::SafePointer<PlaylistComponent> safeThis(this);
+    crateDialog->enterModalState(true, juce::ModalCallbackFunction::create([safeThis, crateIndex, crate, trackIds](int result) mutable {
+        if (safeThis == nullptr || result != 1)
+            return;
+
+        auto& dialog = *safeThis->crateDialog;
+        crate.name = dialog.getTextEditorContents("name").trim();
+        if (crate.name.isEmpty()) {
+            std::cout << "PlaylistComponent::editCrate name should not be empty" << std::endl;
+            return;
+        }
+
+        if (crate.smart) {
+            crate.keyword = dialog.getTextEditorContents("keyword").trim();
+            crate.minBpm = juce::jmax(0.0, dialog.getTextEditorContents("minBpm").getDoubleValue());
+            crate.maxBpm = juce::jmax(0.0, dialog.getTextEditorContents("maxBpm").getDoubleValue());
+            crate.minLength = juce::jmax(0.0, dialog.getTextEditorContents("minLength").getDoubleValue() * 60.0);
+            crate.maxLength = juce::jmax(0.0, dialog.getTextEditorContents("maxLength").getDoubleValue() * 60.0);
+        }
+        else if (crateIndex < 0) {
+            crate.trackIds = trackIds;
+        }
+
+        if (crateIndex < 0) {
+            crateIndex = safeThis->library.addCrate(crate);
+        }
+        else {
+            safeThis->library.setCrate(crateIndex, crate);
+        }
+
+        // a new crate which is not smart stays in the background, the tracks were picked from the shown list
+        safeThis->showCrate(crate.smart ? crateIndex : safeThis->currentCrate);
+    }), false);
+}
+
+/**
+*   Get the library index ids of the selected tracks.
+*   @return the track ids, in the order of the rows
+*/
+
+juce::Array<int> PlaylistComponent::getSelectedTrackIds()
+{
+    juce::Array<int> trackIds;
+    auto selected = tableComponent.getSelectedRows();
+    for (int i = 0; i < selected.size(); ++i)
+        if (selected[i] < (int) trackFiles.size())
+            trackIds.add(library.getTrackId(trackFiles[selected[i]]));
+    return trackIds;
+}
+
+/**
+*   Let the selected rows be dragged, only while a crate is shown in its own order.
+*   @param currentlySelectedRows the rows to be dragged
+*   @return the description of the drag, empty if the rows can't be dragged
+*/
+
+juce::var PlaylistComponent::getDragSourceDescription(const juce::SparseSet<int>& currentlySelectedRows)
+{
+    // a search, the key filter or a sorted column hide the crate's order
+    if (currentCrate < 0 || library.getCrate(currentCrate).smart || searchBox.getText().isNotEmpty()
+        || keyFilterBox.getSelectedId() > 1 || tableComponent.getHeader().getSortColumnId() != 0)
+        return {};
+
+    return currentlySelectedRows.isEmpty() ? juce::var() : juce::var("crateRows");
+}
+
+/**
+*   Accept only the rows dragged out of this playlist's table.
+*   @param dragSourceDetails the dragged item
+*   @return true if the rows can be dropped here
+*/
+
+bool PlaylistComponent::isInterestedInDragSource(const SourceDetails& dragSourceDetails)
+{
+    return dragSourceDetails.description == juce::var("crateRows")
+        && tableComponent.isParentOf(dragSourceDetails.sourceComponent.get());
+}
+
+/**
+*   Move the dragged rows of the shown crate to where they were dropped.
+*   @param dragSourceDetails the dragged item
+*/
+
+void PlaylistComponent::itemDropped(const SourceDetails& dragSourceDetails)
+{
+    auto position = tableComponent.getLocalPoint(this, dragSourceDetails.localPosition);
+    auto insertRow = tableComponent.getInsertionIndexForPosition(position.x, position.y);
+
+    // rows are positions in the crate, except for tracks which are no longer in the Tracks folder
+    auto crateTracks = library.getCrateTracks(currentCrate);
+    juce::SparseSet<int> positions;
+    for (auto trackId : getSelectedTrackIds())
+        positions.addRange({ crateTracks.indexOf(trackId), crateTracks.indexOf(trackId) + 1 });
+
+    auto insertPosition = crateTracks.size();
+    if (juce::isPositiveAndBelow(insertRow, (int) trackFiles.size()))
+        insertPosition = crateTracks.indexOf(library.getTrackId(trackFiles[(size_t) insertRow]));
+
+    library.moveInCrate(currentCrate, positions, insertPosition);
+    showCrate(currentCrate);
+}
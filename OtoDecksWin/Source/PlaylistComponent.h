@@ -1,187 +1,442 @@
-/*
-  ==============================================================================
-
-    PlaylistComponent.h
-    Created: 26 Aug 2020 5:25:27am
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include <vector>
-#include <string>
-#include "DJAudioPlayer.h"
-#include "DeckGUI.h"
-#include "WaveformDisplay.h"
-
-//==============================================================================
-/*
-*/
-class PlaylistComponent  : public juce::Component,
-                           public juce::TableListBoxModel,
-                           public juce::Button::Listener,
-                           public juce::TextEditor::Listener,
-                           public juce::Timer
-    
-{
-public:
-    PlaylistComponent(DJAudioPlayer* player1, DJAudioPlayer* player2,
-                            juce::AudioFormatManager& formatManagerToUse, 
-                            juce::AudioThumbnailCache& cacheToUse,
-                            juce::AudioFormatManager& formatManagerToUse2, 
-                            juce::AudioThumbnailCache& cacheToUse2 );                        
-
-    ~PlaylistComponent() override;
-    
-    void resized() override;
-
-    int getNumRows() override;
-
-    void paintRowBackground(juce::Graphics&, 
-                            int rowNumber, 
-                            int width, 
-                            int height, 
-                            bool rowIsSelected )override;
-
-    /**
-    *   R1A: Component has custom graphics implemented in a paint function.
-    *   Set the custom styles and colors for widgets.
-    *   @param g the graphics to be painted
-    */
-
-    void paint(juce::Graphics&) override;
-
-    /**
-    *   R1B: Component enables the user to control the playback of a deck somehow.
-    *   R2D: Component allows the user to load files from the library into a deck.
-    *   If LOAD1 or LOAD2 button is clicked, load a track to a subjected deck and to a waveform.
-    *   @param buttonId the button id number
-    */
-
-    void loadFromLibrary(int ID);
-
-    /**
-    *   R1B: Component enables the user to control the playback of a deck somehow.
-    *   Set the relative position for waveform so the play head can move in a real time.
-    *   The user can trigger a waveform by clicking on a LOAD1/LOAD2 button which calls this function.
-    */
-
-    void timerCallback() override;
-
-    /**
-    *   R2A: Component allows the user to add files to their library.
-    *   R2D: Component allows the user to load files from the library into a deck.
-    *   Perform operations depending on which button is clicked.
-    *   @param button the reference of the button.
-    */
-
-    void buttonClicked(juce::Button* button)override;
-    
-    /**
-    *   R2A: Component allows the user to add files to their library.
-    */
-
-    void addFileToLibrary();    
-
-    /**
-    *   R2B: Component parses and displays metadata such as file name and song length.
-    *   Implementation of the pure virtual function of TableListBoxModel class to satisfy this requirement.
-    *   Display the file name and the song length by painting the cell.
-    *   @param g the graphics to be painted
-    *   @param rowNumber the number of the row
-    *   @param columnId the id number of the column
-    *   @param width the number of width of the cell
-    *   @param height the number of height of the cell
-    *   @param rowIsSelected true if the row is selected and false otherwise
-    */
-
-    void paintCell(juce::Graphics&, 
-                            int rowNumber, 
-                            int columnId,
-                            int width, 
-                            int height,
-                            bool rowIsSelected )override;
-
-    /**
-    *   R2B: Component parses and displays metadata such as file name and song length.
-    *   Parse the track file's metadata and push it back to vectors to be displayed by paintCell().
-    *   @param trackFile the track file in which the metadata to be pushed back
-    */
-
-    void push_backMetadata(juce::File trackFile, juce::String title);
-
-    /**
-    *   R2B: Component parses and displays metadata such as file name and song length.
-    *   Create the reader for the track file, calculate the song length, and convert it to time.
-    *   @param trackFile the track file to be read
-    *   @return the string of time
-    */
-
-    juce::String getTrackLength(juce::File trackFile); 
-
-    /**
-    *   R2C: Component allows user to search for files.
-    *   Implementation of pure virtual function of TextEditor class to satisfy this requirement.
-    *   Display the matched files in the library when return key is pressed after user inputs the keyword.
-    *   @param the reference of the text editor value
-    */
-
-    void textEditorReturnKeyPressed(juce::TextEditor&)override;
-
-    /**
-    *   R2D: Component allows the user to load files from the library into a deck.
-    *   Refresh component for cell creating the LOAD1 and LOAD2 buttons for each file.
-    *   To distinguish the two buttons, even number is assigned to LOAD1 and odd number for LOAD2.
-    *
-    *   @param rowNumber the number of the row
-    *   @param columnId the id number of the column
-    *   @param rowIsSelected true if the row is selected and false otherwise
-    *   @param existingComponentToUpdate the component to be updated
-    *   @return the updated existing Component
-    */
-
-    Component* refreshComponentForCell(
-                            int rowNumber, 
-                            int columnId,
-                            bool isRowSelected,
-                            Component* existingComponentToUpdate )override;
-
-    /**
-    *   R2E: The music library persists so that it is restored
-    *   when the user exits then restarts the application.
-    *   If there is any stored music (Tracks folder exists), restore it to library.
-    */
-
-    void restoreLibrary();    
-
-    /**
-    *   Helper: Reset all vectors (trackFiles, trackNames, trackLengths).
-    */
-
-    void resetAll();
-
-
-private:   
-
-    WaveformDisplay waveformDisplay;
-    WaveformDisplay waveformDisplay2;
-    
-    juce::TextButton addButton{ "ADD" };
-
-    juce::TableListBox tableComponent;
-    std::vector<juce::String> trackTitles;
-    std::vector<juce::File> trackFiles;
-    std::vector<juce::String> trackLengths;
-
-    // R2D: to load a track from the library
-    DJAudioPlayer* player1;
-    DJAudioPlayer* player2;
-
-    // R2C: to search for files by keyword 
-    juce::TextEditor searchBox;    
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
-};
+/*
+  ==============================================================================
+
+    PlaylistComponent.h
+    Created: 26 Aug 2020 5:25:27am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <string>
+#include <map>
+#include "DJAudioPlayer.h"
+#include "DeckGUI.h"
+#include "WaveformDisplay.h"
+#include "LibraryIndex.h"
+#include "TrackAnalyser.h"
+#include "KeyAnalyser.h"
+#include "DeckMixer.h"
+#include "Automix.h"
+
+//==============================================================================
+/*
+*/
+class PlaylistComponent  : public juce::Component,
+                           public juce::TableListBoxModel,
+                           public juce::Button::Listener,
+                           public juce::TextEditor::Listener,
+                           public juce::ComboBox::Listener,
+                           public juce::ChangeListener,
+                           public juce::Timer,
+                           public juce::DragAndDropContainer,
+                           public juce::DragAndDropTarget
+    
+{
+public:
+    PlaylistComponent(DJAudioPlayer* player1, DJAudioPlayer* player2, DeckMixer* mixer,
+                            juce::AudioFormatManager& formatManagerToUse, 
+                            juce::AudioThumbnailCache& cacheToUse,
+                            juce::AudioFormatManager& formatManagerToUse2, 
+                            juce::AudioThumbnailCache& cacheToUse2 );                        
+
+    ~PlaylistComponent() override;
+    
+    void resized() override;
+
+    int getNumRows() override;
+
+    void paintRowBackground(juce::Graphics&, 
+                            int rowNumber, 
+                            int width, 
+                            int height, 
+                            bool rowIsSelected )override;
+
+    /**
+    *   R1A: Component has custom graphics implemented in a paint function.
+    *   Set the custom styles and colors for widgets.
+    *   @param g the graphics to be painted
+    */
+
+    void paint(juce::Graphics&) override;
+
+    /**
+    *   R1B: Component enables the user to control the playback of a deck somehow.
+    *   R2D: Component allows the user to load files from the library into a deck.
+    *   If LOAD1 or LOAD2 button is clicked, load a track to a subjected deck and to a waveform.
+    *   @param buttonId the button id number
+    */
+
+    void loadFromLibrary(int ID);
+
+    /**
+    *   Load a track to a deck and to its waveform, with the track's analysis and hot cues.
+    *   @param player the deck to load the track to
+    *   @param trackFile the track file to be loaded
+    */
+
+    void loadTrack(DJAudioPlayer* player, juce::File trackFile);
+
+    /**
+    *   Start automix with the selected tracks, or with every listed track if none is selected.
+    */
+
+    void startAutomix();
+
+    /**
+    *   R1B: Component enables the user to control the playback of a deck somehow.
+    *   Set the relative position for waveform so the play head can move in a real time.
+    *   The user can trigger a waveform by clicking on a LOAD1/LOAD2 button which calls this function.
+    */
+
+    void timerCallback() override;
+
+    /**
+    *   R2A: Component allows the user to add files to their library.
+    *   R2D: Component allows the user to load files from the library into a deck.
+    *   Perform operations depending on which button is clicked.
+    *   @param button the reference of the button.
+    */
+
+    void buttonClicked(juce::Button* button)override;
+    
+    /**
+    *   R2A: Component allows the user to add files to their library.
+    */
+
+    void addFileToLibrary();    
+
+    /**
+    *   R2A: Component allows the user to add files to their library.
+    *   Copy a track file to the Tracks folder and list it, unless a track with its title is listed.
+    *   @param sourceFile the track file to be added
+    *   @return true if the track was added
+    */
+
+    bool copyFileToLibrary(juce::File sourceFile);
+
+    /**
+    *   R2B: Component parses and displays metadata such as file name and song length.
+    *   Implementation of the pure virtual function of TableListBoxModel class to satisfy this requirement.
+    *   Display the file name and the song length by painting the cell.
+    *   @param g the graphics to be painted
+    *   @param rowNumber the number of the row
+    *   @param columnId the id number of the column
+    *   @param width the number of width of the cell
+    *   @param height the number of height of the cell
+    *   @param rowIsSelected true if the row is selected and false otherwise
+    */
+
+    void paintCell(juce::Graphics&, 
+                            int rowNumber, 
+                            int columnId,
+                            int width, 
+                            int height,
+                            bool rowIsSelected )override;
+
+    /**
+    *   R2B: Component parses and displays metadata such as file name and song length.
+    *   Parse the track file's metadata and push it back to vectors to be displayed by paintCell().
+    *   @param trackFile the track file in which the metadata to be pushed back
+    */
+
+    void push_backMetadata(juce::File trackFile, juce::String title);
+
+    /**
+    *   R2B: Component parses and displays metadata such as file name and song length.
+    *   Push back the metadata of a track file whose length has been read already.
+    *   @param trackFile the track file in which the metadata to be pushed back
+    *   @param title the title to be displayed
+    *   @param lengthInSeconds the song length returned by getTrackLengthInSeconds()
+    */
+
+    void push_backMetadata(juce::File trackFile, juce::String title, double lengthInSeconds);
+
+    /**
+    *   R2B: Component parses and displays metadata such as file name and song length.
+    *   Create the reader for the track file, calculate the song length, and convert it to time.
+    *   @param trackFile the track file to be read
+    *   @return the string of time
+    */
+
+    juce::String getTrackLength(juce::File trackFile); 
+
+    /**
+    *   R2B: Component parses and displays metadata such as file name and song length.
+    *   Create the reader for the track file and calculate the song length.
+    *   @param trackFile the track file to be read
+    *   @return the song length in seconds, -1 if the file could not be read
+    */
+
+    double getTrackLengthInSeconds(juce::File trackFile);
+
+    /**
+    *   R2B: Component parses and displays metadata such as file name and song length.
+    *   Create the reader for the track file, calculate the song length and read the tags and the format,
+    *   so a track is only opened once.
+    *   @param trackFile the track file to be read
+    *   @param tags filled in with the artist, album, genre, sample rate, channels and bitrate
+    *   @return the song length in seconds, -1 if the file could not be read
+    */
+
+    double readTrackMetadata(juce::File trackFile, TrackTags& tags);
+
+    /**
+    *   Convert a song length to the time shown in the Length column.
+    *   @param lengthInSeconds the song length, negative if it is not known
+    *   @return the string of time, "-" if the length is not known
+    */
+
+    static juce::String formatTrackLength(double lengthInSeconds);
+
+    /**
+    *   R2C: Component allows user to search for files.
+    *   Implementation of pure virtual function of TextEditor class to satisfy this requirement.
+    *   Display the matched files in the library when return key is pressed after user inputs the keyword.
+    *   @param the reference of the text editor value
+    */
+
+    void textEditorReturnKeyPressed(juce::TextEditor&)override;
+
+    /**
+    *   R2C: Component allows user to search for files.
+    *   List only the tracks of the shown crate whose title or tags contain the keyword and which pass the key filter.
+    *   The list is built from the library index, without reading the Tracks folder again.
+    *   @param titleKeyword the keyword, an empty one matches every track
+    */
+
+    void searchLibrary(juce::String titleKeyword);
+
+    /**
+    *   Show the tracks of a crate, in its order, or every track in the library.
+    *   @param crateIndex the crate in the library index, -1 for every track
+    */
+
+    void showCrate(int crateIndex);
+
+    /**
+    *   Show the crate menu for the selected tracks when a row is right-clicked.
+    *   @param rowNumber the number of the row
+    *   @param columnId the id number of the column
+    *   @param e the mouse event
+    */
+
+    void cellClicked(int rowNumber, int columnId, const juce::MouseEvent& e) override;
+
+    /**
+    *   Show the crate menu when the empty part of the table is right-clicked.
+    *   @param e the mouse event
+    */
+
+    void backgroundClicked(const juce::MouseEvent& e) override;
+
+    /**
+    *   Let the selected rows be dragged, only while a crate is shown in its own order.
+    *   @param currentlySelectedRows the rows to be dragged
+    *   @return the description of the drag, empty if the rows can't be dragged
+    */
+
+    juce::var getDragSourceDescription(const juce::SparseSet<int>& currentlySelectedRows) override;
+
+    /**
+    *   Accept only the rows dragged out of this playlist's table.
+    *   @param dragSourceDetails the dragged item
+    *   @return true if the rows can be dropped here
+    */
+
+    bool isInterestedInDragSource(const SourceDetails& dragSourceDetails) override;
+
+    /**
+    *   Move the dragged rows of the shown crate to where they were dropped.
+    *   @param dragSourceDetails the dragged item
+    */
+
+    void itemDropped(const SourceDetails& dragSourceDetails) override;
+
+    /**
+    *   Sort the listed tracks when a column header is clicked, and again whenever the list is rebuilt.
+    *   @param newSortColumnId the id of the column to sort by, 0 for none
+    *   @param isForwards true for ascending order
+    */
+
+    void sortOrderChanged(int newSortColumnId, bool isForwards) override;
+
+    /**
+    *   Harmonic mixing: apply the key filter when another deck is chosen to match.
+    *   Show another crate when one is chosen in the crate box.
+    *   @param comboBox the reference of the combo box
+    */
+
+    void comboBoxChanged(juce::ComboBox* comboBox)override;
+
+    /**
+    *   Store the hot cues of a deck's track in the library when the user changes them.
+    *   @param source the deck whose hot cues changed
+    */
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    /**
+    *   Check a track against the key filter.
+    *   @param trackFile the track file to be checked
+    *   @return true if the filter is off, or the track's key mixes with the chosen deck's key
+    */
+
+    bool matchesKeyFilter(juce::File trackFile);
+
+    /**
+    *   R2D: Component allows the user to load files from the library into a deck.
+    *   Refresh component for cell creating the LOAD1 and LOAD2 buttons for each file.
+    *   To distinguish the two buttons, even number is assigned to LOAD1 and odd number for LOAD2.
+    *
+    *   @param rowNumber the number of the row
+    *   @param columnId the id number of the column
+    *   @param rowIsSelected true if the row is selected and false otherwise
+    *   @param existingComponentToUpdate the component to be updated
+    *   @return the updated existing Component
+    */
+
+    Component* refreshComponentForCell(
+                            int rowNumber, 
+                            int columnId,
+                            bool isRowSelected,
+                            Component* existingComponentToUpdate )override;
+
+    /**
+    *   R2E: The music library persists so that it is restored
+    *   when the user exits then restarts the application.
+    *   If there is any stored music (Tracks folder exists), restore it to library.
+    */
+
+    void restoreLibrary();    
+
+    /**
+    *   R2E: Restore the library on a background thread: the index, the Tracks folder and the song lengths.
+    *   The tracks are listed and queued for analysis on the message thread once it is done,
+    *   and the controls which change the list are disabled until then.
+    */
+
+    void loadLibraryAsync();
+
+    /** called on the message thread once loadLibraryAsync() has listed the library */
+    std::function<void()> onLibraryLoaded;
+
+    /**
+    *   Helper: Reset all vectors (trackFiles, trackNames, trackLengths).
+    */
+
+    void resetAll();
+
+    /**
+    *   Store the analysis results finished since the last call in the library index,
+    *   and write the index once the analyser has nothing left to do.
+    */
+
+    void collectAnalysisResults();
+
+    /**
+    *   Give a deck the analysis of the track loaded into it, analysing the track first if needed.
+    *   @param player the deck the track is loaded into
+    *   @param trackFile the loaded track file
+    */
+
+    void loadTrackAnalysis(DJAudioPlayer* player, juce::File trackFile);
+
+    /**
+    *   Hand the beatgrid, the loudness and the auto-cue points of a track to a deck and its waveform.
+    *   @param player the deck the track is loaded into
+    *   @param analysis the analysis of the track
+    */
+
+    void applyTrackAnalysis(DJAudioPlayer* player, const TrackAnalysis& analysis);
+
+
+private:   
+    class LibraryLoader;
+
+    /**
+    *   List the tracks found by the loader and take over the index it loaded.
+    */
+
+    void finishLibraryLoad();
+
+    /**
+    *   Enable or disable the controls which change the listed tracks.
+    *   @param shouldBeEnabled false while the library is loading
+    */
+
+    void setLibraryControlsEnabled(bool shouldBeEnabled);
+
+    /**
+    *   List the crates of the library index in the crate box, keeping the shown one selected.
+    */
+
+    void updateCrateBox();
+
+    /**
+    *   Show the menu to add the selected tracks to a crate, or to make, edit or delete one.
+    */
+
+    void showCrateMenu();
+
+    /**
+    *   Ask for a crate's name, and for a smart crate its filter, then store it in the library index.
+    *   @param crateIndex the crate to edit, -1 for a new one
+    *   @param smart true for a smart crate
+    *   @param trackIds the tracks to put in a new crate which is not smart
+    */
+
+    void editCrate(int crateIndex, bool smart, juce::Array<int> trackIds);
+
+    /**
+    *   Get the library index ids of the selected tracks.
+    *   @return the track ids, in the order of the rows
+    */
+
+    juce::Array<int> getSelectedTrackIds();
+
+    WaveformDisplay waveformDisplay;
+    WaveformDisplay waveformDisplay2;
+    
+    juce::TextButton addButton{ "ADD" };
+    juce::TextButton automixButton{ "AUTOMIX" };
+
+    juce::TableListBox tableComponent;
+    std::vector<juce::String> trackTitles;
+    std::vector<juce::File> trackFiles;
+    std::vector<juce::String> trackLengths;
+
+    // every track in the Tracks folder by its id in the library index, the crates are shown from it
+    std::map<int, juce::File> libraryTracks;
+
+    // R2D: to load a track from the library
+    DJAudioPlayer* player1;
+    DJAudioPlayer* player2;
+
+    // R2C: to search for files by keyword 
+    juce::TextEditor searchBox;    
+
+    // to show only tracks in a key compatible with a deck
+    juce::ComboBox keyFilterBox;
+
+    // to switch between every track and the user's crates, and the dialog to name or edit one
+    juce::ComboBox crateBox;
+    int currentCrate = -1;
+    std::unique_ptr<juce::AlertWindow> crateDialog;
+
+    // tempo, beatgrid and loudness of the tracks, analysed in the background
+    LibraryIndex library{ LibraryIndex::getDefaultIndexFile() };
+    TrackAnalyser analyser;
+
+    // plays the library on both decks with crossfades
+    Automix automix;
+
+    // restores the library after the window is shown, only exists while it runs
+    std::unique_ptr<LibraryLoader> libraryLoader;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
+};
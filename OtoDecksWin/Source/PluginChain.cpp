@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    PluginChain.cpp
+    Created: 19 Oct 2026 3:40:18pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "PluginChain.h"
+
+namespace
+{
+    // the formats are registered once for every chain
+    struct PluginFormats
+    {
+        PluginFormats()
+        {
+           #if JUCE_PLUGINHOST_VST3
+            formatManager.addFormat(new juce::VST3PluginFormat());
+           #endif
+           #if JUCE_PLUGINHOST_LV2
+            formatManager.addFormat(new juce::LV2PluginFormat());
+           #endif
+        }
+
+        juce::AudioPluginFormatManager formatManager;
+    };
+
+    // plugins are stereo in, stereo out; wider buses are fed silence
+    const int maxPluginChannels = 8;
+}
+
+PluginChain::PluginChain()
+{
+}
+
+PluginChain::~PluginChain()
+{
+    releaseResources();
+}
+
+bool PluginChain::addPlugin(const juce::File& file, juce::String& error)
+{
+    if (sampleRate <= 0.0 || blockSize <= 0) {
+        error = "the audio device is not running";
+        return false;
+    }
+
+    juce::SharedResourcePointer<PluginFormats> formats;
+    juce::OwnedArray<juce::PluginDescription> types;
+    for (auto* format : formats->formatManager.getFormats())
+        if (format->fileMightContainThisPluginType(file.getFullPathName()))
+            format->findAllTypesForFile(types, file.getFullPathName());
+
+    if (types.isEmpty()) {
+        error = file.getFileName() + " is not a plugin this build can host";
+        return false;
+    }
+
+    auto instance = formats->formatManager.createPluginInstance(*types[0], sampleRate, blockSize, error);
+    if (instance == nullptr)
+        return false;
+
+    // stereo in and out where the plugin allows it
+    auto layout = instance->getBusesLayout();
+    if (layout.inputBuses.size() > 0)
+        layout.inputBuses.getReference(0) = juce::AudioChannelSet::stereo();
+    if (layout.outputBuses.size() > 0)
+        layout.outputBuses.getReference(0) = juce::AudioChannelSet::stereo();
+    instance->setBusesLayout(layout);
+
+    auto channels = juce::jmax(instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels());
+    if (channels > maxPluginChannels) {
+        error = types[0]->name + " has more than " + juce::String(maxPluginChannels) + " channels";
+        return false;
+    }
+
+    instance->setNonRealtime(false);
+    instance->prepareToPlay(sampleRate, blockSize);
+
+    const juce::SpinLock::ScopedLockType sl(chainLock);
+    plugins.push_back(std::move(instance));
+    numPlugins = (int) plugins.size();
+    return true;
+}
+
+void PluginChain::removePlugin(int index)
+{
+    std::unique_ptr<juce::AudioPluginInstance> removed;
+    {
+        const juce::SpinLock::ScopedLockType sl(chainLock);
+        if (index < 0 || index >= (int) plugins.size()) {
+            std::cout << "PluginChain::removePlugin index should be between 0 and " << (int) plugins.size() - 1 << std::endl;
+            return;
+        }
+        removed = std::move(plugins[index]);
+        plugins.erase(plugins.begin() + index);
+        numPlugins = (int) plugins.size();
+    }
+    // deleted here, now that the audio thread can't reach it
+    removed->releaseResources();
+}
+
+int PluginChain::getNumPlugins() const
+{
+    return numPlugins;
+}
+
+juce::AudioPluginInstance* PluginChain::getPlugin(int index) const
+{
+    return index >= 0 && index < (int) plugins.size() ? plugins[index].get() : nullptr;
+}
+
+void PluginChain::prepareToPlay(double newSampleRate, int samplesPerBlockExpected)
+{
+    const juce::SpinLock::ScopedLockType sl(chainLock);
+    sampleRate = newSampleRate;
+    blockSize = samplesPerBlockExpected;
+
+    chainBuffer.setSize(maxPluginChannels, juce::jmax(1, samplesPerBlockExpected));
+    midiBuffer.ensureSize(256);
+    for (auto& plugin : plugins)
+        plugin->prepareToPlay(newSampleRate, samplesPerBlockExpected);
+}
+
+void PluginChain::releaseResources()
+{
+    const juce::SpinLock::ScopedLockType sl(chainLock);
+    for (auto& plugin : plugins)
+        plugin->releaseResources();
+}
+
+void PluginChain::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (numPlugins == 0)
+        return;
+
+    // a plugin is being added or removed: pass this block through
+    const juce::SpinLock::ScopedTryLockType sl(chainLock);
+    if (!sl.isLocked() || numSamples > chainBuffer.getNumSamples())
+        return;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    auto numChannels = juce::jmin(2, buffer.getNumChannels());
+
+    for (int channel = 0; channel < chainBuffer.getNumChannels(); ++channel) {
+        if (channel < 2)
+            chainBuffer.copyFrom(channel, 0, buffer, juce::jmin(channel, numChannels - 1), startSample, numSamples);
+        else
+            chainBuffer.clear(channel, 0, numSamples);
+    }
+
+    int latency = 0;
+    for (auto& plugin : plugins) {
+        // a view of just the samples and channels this plugin uses, which does not allocate
+        auto channels = juce::jmax(plugin->getTotalNumInputChannels(), plugin->getTotalNumOutputChannels());
+        juce::AudioBuffer<float> view(chainBuffer.getArrayOfWritePointers(), juce::jmax(1, channels), numSamples);
+
+        midiBuffer.clear();
+        if (!plugin->isSuspended())
+            plugin->processBlock(view, midiBuffer);
+        latency += plugin->getLatencySamples();
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        buffer.copyFrom(channel, startSample, chainBuffer, channel, 0, numSamples);
+
+    latencySamples = latency;
+    auto cost = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    averageCost = averageCost + 0.05 * (cost - averageCost);
+}
+
+int PluginChain::getLatencySamples() const
+{
+    return numPlugins > 0 ? latencySamples.load() : 0;
+}
+
+double PluginChain::getAverageCost() const
+{
+    return numPlugins > 0 ? averageCost.load() : 0.0;
+}
+
+juce::String PluginChain::getPluginFileTypes()
+{
+    juce::StringArray patterns;
+   #if JUCE_PLUGINHOST_VST3
+    patterns.add("*.vst3");
+   #endif
+   #if JUCE_PLUGINHOST_LV2
+    patterns.add("*.lv2");
+   #endif
+    return patterns.joinIntoString(";");
+}
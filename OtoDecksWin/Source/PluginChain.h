@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    PluginChain.h
+    Created: 19 Oct 2026 3:40:18pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/*
+    An insert chain of hosted effect plugins, for a deck or the master bus.
+
+    Plugins are loaded and prepared on the message thread with the block size
+    and sample rate the chain was prepared with, then swapped in under a spin
+    lock which the audio thread only tries; while a plugin is being added or
+    removed, the chain passes the audio through for that block.
+
+    The chain reports its total latency and the time it takes to run, which
+    DeckMixer uses to line the decks up and to decide what to run in parallel.
+*/
+class PluginChain
+{
+public:
+    PluginChain();
+    ~PluginChain();
+
+    /**
+    *   Load an effect plugin and append it to the chain.
+    *   @param file the VST3 file, or the LV2 bundle where LV2 hosting is built in
+    *   @param error set to the reason if the plugin could not be loaded
+    *   @return true if the plugin was added
+    */
+    bool addPlugin(const juce::File& file, juce::String& error);
+
+    /**
+    *   Remove a plugin from the chain and delete it.
+    *   @param index the position in the chain
+    */
+    void removePlugin(int index);
+
+    /** get the number of plugins in the chain */
+    int getNumPlugins() const;
+
+    /** get a plugin, to show its editor; message thread only */
+    juce::AudioPluginInstance* getPlugin(int index) const;
+
+    /** prepare every plugin for the device, and any plugin added later */
+    void prepareToPlay(double sampleRate, int samplesPerBlockExpected);
+
+    void releaseResources();
+
+    /**
+    *   Run the chain over a block. Audio thread, or a mixer worker thread.
+    *   @param buffer the audio, whose first two channels are processed
+    *   @param startSample the first sample of the block
+    *   @param numSamples the length of the block, up to the prepared block size
+    */
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** get the latency of the whole chain in samples, as of the last block */
+    int getLatencySamples() const;
+
+    /** get the moving average of the time a block takes, in milliseconds */
+    double getAverageCost() const;
+
+    /** the plugin formats this build can host, e.g. for a file chooser */
+    static juce::String getPluginFileTypes();
+
+private:
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> plugins;
+    std::atomic<int> numPlugins{ 0 };
+
+    // the message thread changes the chain under it, the audio thread only tries it
+    juce::SpinLock chainLock;
+
+    std::atomic<double> sampleRate{ 0.0 };
+    std::atomic<int> blockSize{ 0 };
+
+    // big enough for the channels of every plugin, so none needs to allocate
+    juce::AudioBuffer<float> chainBuffer;
+    juce::MidiBuffer midiBuffer;
+
+    std::atomic<int> latencySamples{ 0 };
+    std::atomic<double> averageCost{ 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginChain)
+};
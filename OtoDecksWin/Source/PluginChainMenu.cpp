@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    PluginChainMenu.cpp
+    Created: 19 Oct 2026 4:12:45pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "PluginChainMenu.h"
+
+class PluginChainMenu::EditorWindow  : public juce::DocumentWindow
+{
+public:
+    EditorWindow(PluginChainMenu& _owner, juce::AudioPluginInstance& _plugin)
+        : juce::DocumentWindow(_plugin.getName(), juce::Colours::lightblue, juce::DocumentWindow::closeButton),
+          owner(_owner), plugin(_plugin)
+    {
+        // plugins without a GUI of their own get sliders for their parameters
+        auto* editor = plugin.hasEditor() ? plugin.createEditorIfNeeded() : nullptr;
+        if (editor == nullptr)
+            editor = new juce::GenericAudioProcessorEditor(plugin);
+
+        setContentOwned(editor, true);
+        setUsingNativeTitleBar(true);
+        setResizable(editor->isResizable(), false);
+        centreWithSize(getWidth(), getHeight());
+        setVisible(true);
+    }
+
+    ~EditorWindow() override
+    {
+        // the editor goes before the plugin it edits
+        clearContentComponent();
+    }
+
+    void closeButtonPressed() override
+    {
+        owner.closeEditor(this);
+    }
+
+    PluginChainMenu& owner;
+    juce::AudioPluginInstance& plugin;
+};
+
+PluginChainMenu::PluginChainMenu(PluginChain* _chain) : chain{ _chain }
+{
+}
+
+PluginChainMenu::~PluginChainMenu()
+{
+    editors.clear();
+}
+
+void PluginChainMenu::show(juce::Component& target)
+{
+    if (chain == nullptr)
+        return;
+
+    juce::PopupMenu menu;
+    menu.addItem(1, "Add plugin...");
+
+    // item ids: 100 + index to open the editor, 200 + index to remove
+    for (int i = 0; i < chain->getNumPlugins(); ++i) {
+        juce::PopupMenu pluginMenu;
+        pluginMenu.addItem(100 + i, "Edit");
+        pluginMenu.addItem(200 + i, "Remove");
+        menu.addSubMenu(juce::String(i + 1) + ". " + chain->getPlugin(i)->getName(), pluginMenu);
+    }
+
+    if (chain->getNumPlugins() > 0) {
+        menu.addSeparator();
+        menu.addItem(2, juce::String::formatted("Latency %d samples, %.2f ms per block",
+                                                chain->getLatencySamples(), chain->getAverageCost()), false);
+    }
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&target), [this](int result) {
+        if (result == 1)
+            addPlugin();
+        else if (result >= 200)
+            removePlugin(result - 200);
+        else if (result >= 100)
+            showEditor(result - 100);
+    });
+}
+
+void PluginChainMenu::addPlugin()
+{
+    auto patterns = PluginChain::getPluginFileTypes();
+    if (patterns.isEmpty()) {
+        std::cout << "PluginChainMenu::addPlugin this build hosts no plugin formats" << std::endl;
+        return;
+    }
+
+    // VST3 and LV2 plugins are bundles, which are folders on some platforms
+    chooser = std::make_unique<juce::FileChooser>("Select a plugin...", juce::File(), patterns);
+    auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles
+                 | juce::FileBrowserComponent::canSelectDirectories;
+
+    chooser->launchAsync(flags, [this](const juce::FileChooser& fc) {
+        auto file = fc.getResult();
+        if (file == juce::File())
+            return;
+
+        juce::String error;
+        if (!chain->addPlugin(file, error))
+            std::cout << "PluginChainMenu::addPlugin could not load " << file.getFullPathName()
+                      << ": " << error << std::endl;
+    });
+}
+
+void PluginChainMenu::showEditor(int index)
+{
+    auto* plugin = chain->getPlugin(index);
+    if (plugin == nullptr)
+        return;
+
+    for (auto* window : editors) {
+        if (&window->plugin == plugin) {
+            window->toFront(true);
+            return;
+        }
+    }
+    editors.add(new EditorWindow(*this, *plugin));
+}
+
+void PluginChainMenu::removePlugin(int index)
+{
+    auto* plugin = chain->getPlugin(index);
+    for (int i = editors.size(); --i >= 0;)
+        if (&editors[i]->plugin == plugin)
+            editors.remove(i);
+
+    chain->removePlugin(index);
+}
+
+void PluginChainMenu::closeEditor(EditorWindow* window)
+{
+    editors.removeObject(window);
+}
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    PluginChainMenu.h
+    Created: 19 Oct 2026 4:12:45pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginChain.h"
+
+//==============================================================================
+/*
+    The FX menu of a deck or the master: adds plugins to a PluginChain, opens
+    their editors and removes them. Owns the editor windows, which are closed
+    before their plugin is removed.
+*/
+class PluginChainMenu
+{
+public:
+    /**
+    *   @param chain the chain to edit, which must outlive the menu
+    */
+    PluginChainMenu(PluginChain* chain);
+    ~PluginChainMenu();
+
+    /**
+    *   Show the menu.
+    *   @param target the button the menu drops down from
+    */
+    void show(juce::Component& target);
+
+private:
+    class EditorWindow;
+
+    /** choose a plugin file and add it to the end of the chain */
+    void addPlugin();
+
+    /** open the editor of a plugin, or bring it to the front */
+    void showEditor(int index);
+
+    /** close any editor of a plugin, then remove it from the chain */
+    void removePlugin(int index);
+
+    /** delete an editor window, called when its close button is pressed */
+    void closeEditor(EditorWindow* window);
+
+    PluginChain* chain;
+    std::unique_ptr<juce::FileChooser> chooser;
+    juce::OwnedArray<EditorWindow> editors;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginChainMenu)
+};
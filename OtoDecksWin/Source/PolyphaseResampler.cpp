@@ -0,0 +1,324 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.cpp
+    Created: 19 Oct 2026 3:52:18am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "PolyphaseResampler.h"
+#include <cmath>
+
+namespace
+{
+    // filter phases per input sample, the coefficients are interpolated in between
+    const int numPhases = 256;
+
+    // the banks narrow the passband for ratios up to these; faster ratios use the last one
+    const double stretches[] = { 1.0, 1.1, 1.2, 1.35, 1.5, 1.75, 2.0, 2.5, 3.0, 4.0 };
+    const int numStretches = (int) (sizeof(stretches) / sizeof(stretches[0]));
+
+    // taps at a ratio of 1, Kaiser window shape, and the cutoff as a fraction of Nyquist
+    const int qualityTaps[] = { 8, 16, 48 };
+    const double qualityBeta[] = { 4.0, 6.0, 8.5 };
+    const double qualityRolloff[] = { 0.8, 0.86, 0.92 };
+
+    /** the zeroth order modified Bessel function, for the Kaiser window */
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50 && term > 1.0e-12 * sum; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+//==============================================================================
+struct PolyphaseResampler::FilterBanks
+{
+    struct Bank
+    {
+        int numTaps = 0;
+        juce::HeapBlock<float> storage;
+        float* coefficients = nullptr;  // numPhases + 1 rows of numTaps, aligned for the SIMD registers
+
+        const float* getRow(int phase) const { return coefficients + (size_t) phase * (size_t) numTaps; }
+    };
+
+    FilterBanks()
+    {
+        for (int q = 0; q < numQualities; ++q)
+            for (int s = 0; s < numStretches; ++s)
+                makeBank(banks[q][s], qualityTaps[q], qualityBeta[q], qualityRolloff[q], stretches[s]);
+    }
+
+    const Bank& getBank(int quality, double ratio) const
+    {
+        for (int s = 0; s < numStretches - 1; ++s)
+            if (ratio <= stretches[s])
+                return banks[quality][s];
+        return banks[quality][numStretches - 1];
+    }
+
+    static int getMaxTaps()
+    {
+        return getNumTaps(qualityTaps[numQualities - 1], stretches[numStretches - 1]);
+    }
+
+    static int getNumTaps(int taps, double stretch)
+    {
+        // even, so the filter is centred between the two frames around the position, and a
+        // whole number of registers, so the rows stay aligned and are interpolated a register at a time
+        auto multiple = juce::jmax(2, (int) Vec::size());
+        return multiple * (int) std::ceil(taps * stretch / multiple);
+    }
+
+    static void makeBank(Bank& bank, int taps, double beta, double rolloff, double stretch)
+    {
+        bank.numTaps = getNumTaps(taps, stretch);
+        bank.storage.calloc((size_t) (numPhases + 1) * (size_t) bank.numTaps + Vec::size());
+        bank.coefficients = juce::snapPointerToAlignment(bank.storage.get(), Vec::SIMDRegisterSize);
+
+        auto halfLength = bank.numTaps / 2.0;
+        auto cutoff = rolloff / stretch;  // relative to the input Nyquist
+        auto windowScale = 1.0 / besselI0(beta);
+
+        for (int phase = 0; phase <= numPhases; ++phase) {
+            auto fraction = (double) phase / numPhases;
+            auto* row = bank.coefficients + (size_t) phase * (size_t) bank.numTaps;
+            double sum = 0.0;
+
+            for (int tap = 0; tap < bank.numTaps; ++tap) {
+                // tap 0 is the frame halfLength - 1 before the one at or before the position
+                auto x = tap - (halfLength - 1.0) - fraction;
+                auto r = x / halfLength;
+                auto window = std::abs(r) < 1.0 ? besselI0(beta * std::sqrt(1.0 - r * r)) * windowScale : 0.0;
+                auto arg = juce::MathConstants<double>::pi * cutoff * x;
+                auto sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+                row[tap] = (float) (sinc * window);
+                sum += sinc * window;
+            }
+
+            // unity gain at DC for every phase
+            for (int tap = 0; tap < bank.numTaps; ++tap)
+                row[tap] = (float) (row[tap] / sum);
+        }
+    }
+
+    Bank banks[numQualities][numStretches];
+};
+
+//==============================================================================
+PolyphaseResampler::PolyphaseResampler(juce::AudioSource* _input, int _numChannels)
+    : input(_input),
+      numChannels(juce::jmax(1, _numChannels)),
+      numGroups((numChannels + (int) Vec::size() - 1) / (int) Vec::size()),
+      lanes((int) Vec::size())
+{
+    maxHalfTaps = FilterBanks::getMaxTaps() / 2;
+
+    // the frames the widest filter reaches on both sides, plus a chunk of input
+    historyCapacity = 2 * maxHalfTaps + inputChunkSize;
+    historyStorage.calloc((size_t) (numGroups * historyCapacity * lanes + lanes));
+    history = juce::snapPointerToAlignment(historyStorage.get(), Vec::SIMDRegisterSize);
+
+    inputBuffer.setSize(numChannels, inputChunkSize);
+    coefficientStorage.calloc((size_t) (FilterBanks::getMaxTaps() + lanes));
+    coefficients = juce::snapPointerToAlignment(coefficientStorage.get(), Vec::SIMDRegisterSize);
+    outputs.resize((size_t) numChannels);
+}
+
+PolyphaseResampler::~PolyphaseResampler()
+{
+}
+
+void PolyphaseResampler::setResamplingRatio(double samplesInPerOutputSample)
+{
+    ratio = juce::jmax(0.0, samplesInPerOutputSample);
+}
+
+double PolyphaseResampler::getResamplingRatio() const
+{
+    return ratio;
+}
+
+void PolyphaseResampler::setQuality(Quality newQuality)
+{
+    quality = juce::jlimit((int) lowQuality, (int) highQuality, (int) newQuality);
+}
+
+PolyphaseResampler::Quality PolyphaseResampler::getQuality() const
+{
+    return (Quality) quality.load();
+}
+
+void PolyphaseResampler::flushBuffers()
+{
+    flushPending = true;
+}
+
+double PolyphaseResampler::getLatencyInInputSamples() const
+{
+    return latency;
+}
+
+void PolyphaseResampler::prepareToPlay(int /*samplesPerBlockExpected*/, double /*sampleRate*/)
+{
+    flushBuffers();
+}
+
+void PolyphaseResampler::releaseResources()
+{
+}
+
+void PolyphaseResampler::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (flushPending.exchange(false)) {
+        // silence before the first frame, which lands exactly on the next output sample
+        juce::FloatVectorOperations::clear(history, numGroups * historyCapacity * lanes);
+        numAvailable = maxHalfTaps;
+        position = maxHalfTaps;
+    }
+
+    auto& buffer = *bufferToFill.buffer;
+    auto currentRatio = ratio.load();
+    if (currentRatio <= 0.0) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    auto& bank = banks->getBank(quality, currentRatio);
+    auto halfTaps = bank.numTaps / 2;
+    auto numOutputs = juce::jmin(numChannels, buffer.getNumChannels());
+    for (int channel = 0; channel < numOutputs; ++channel)
+        outputs[(size_t) channel] = buffer.getWritePointer(channel, bufferToFill.startSample);
+
+    // at a ratio of exactly 1 from a whole frame, e.g. a track at the device rate and no pitch
+    // change, every output sample is an input frame, which is copied instead of filtered
+    auto passThrough = currentRatio == 1.0 && position == std::floor(position);
+
+    // the coefficients are only worked out again when the phase moves, which it doesn't at a ratio of 1
+    int lastRow = -1;
+    float lastT = 0.0f;
+
+    for (int i = 0; i < bufferToFill.numSamples; ++i) {
+        if ((int) position + halfTaps >= numAvailable)
+            fillHistory(bufferToFill.numSamples - i, currentRatio, halfTaps);
+
+        auto whole = (int) position;
+
+        if (passThrough) {
+            for (int group = 0; group < numGroups; ++group) {
+                auto* frame = history + ((size_t) group * (size_t) historyCapacity + (size_t) whole) * (size_t) lanes;
+                for (int lane = 0; lane < lanes; ++lane) {
+                    auto channel = group * lanes + lane;
+                    if (channel < numOutputs)
+                        outputs[(size_t) channel][i] = frame[lane];
+                }
+            }
+            position += 1.0;
+            continue;
+        }
+
+        auto phase = (position - whole) * numPhases;
+        auto row = juce::jmin((int) phase, numPhases - 1);
+        auto t = (float) (phase - row);
+
+        // the filter for this exact position, between the two nearest phases, a register at a time
+        if (row != lastRow || t != lastT) {
+            auto* row0 = bank.getRow(row);
+            auto* row1 = bank.getRow(row + 1);
+            for (int tap = 0; tap < bank.numTaps; tap += lanes) {
+                auto c0 = Vec::fromRawArray(row0 + tap);
+                auto c1 = Vec::fromRawArray(row1 + tap);
+                (c0 + (c1 - c0) * t).copyToRawArray(coefficients + tap);
+            }
+            lastRow = row;
+            lastT = t;
+        }
+
+        auto first = whole - halfTaps + 1;
+        for (int group = 0; group < numGroups; ++group) {
+            auto* frames = history + ((size_t) group * (size_t) historyCapacity + (size_t) first) * (size_t) lanes;
+
+            auto sum = Vec::expand(0.0f);
+            for (int tap = 0; tap < bank.numTaps; ++tap)
+                sum += Vec::fromRawArray(frames + tap * lanes) * coefficients[tap];
+
+            for (int lane = 0; lane < lanes; ++lane) {
+                auto channel = group * lanes + lane;
+                if (channel < numOutputs)
+                    outputs[(size_t) channel][i] = sum.get((size_t) lane);
+            }
+        }
+        position += currentRatio;
+    }
+
+    for (int channel = numOutputs; channel < buffer.getNumChannels(); ++channel)
+        buffer.clear(channel, bufferToFill.startSample, bufferToFill.numSamples);
+
+    latency = numAvailable - position;
+}
+
+void PolyphaseResampler::fillHistory(int numRemaining, double currentRatio, int halfTaps)
+{
+    // drop the frames behind the widest filter
+    auto keepFrom = (juce::int64) position - maxHalfTaps + 1;
+    if (keepFrom > 0) {
+        auto numDropped = (int) juce::jmin<juce::int64>(keepFrom, numAvailable);
+        for (int group = 0; group < numGroups && numDropped < numAvailable; ++group) {
+            auto* base = history + (size_t) group * (size_t) historyCapacity * (size_t) lanes;
+            std::memmove(base, base + (size_t) numDropped * (size_t) lanes,
+                         sizeof(float) * (size_t) (numAvailable - numDropped) * (size_t) lanes);
+        }
+        numAvailable -= numDropped;
+        position -= numDropped;
+
+        // a ratio so fast it jumps past the whole history skips input as well
+        auto numSkipped = keepFrom - numDropped;
+        while (numSkipped > 0) {
+            auto num = (int) juce::jmin<juce::int64>(numSkipped, inputChunkSize);
+            readInput(-1, num);
+            numSkipped -= num;
+            position -= num;
+        }
+    }
+
+    // read what the rest of the block reaches, as far as it fits
+    auto lastPosition = position + (numRemaining - 1) * currentRatio;
+    auto wanted = (juce::int64) lastPosition + halfTaps + 1;
+    auto numToRead = (int) juce::jmin<juce::int64>(wanted, historyCapacity) - numAvailable;
+
+    while (numToRead > 0) {
+        auto num = juce::jmin(numToRead, inputChunkSize);
+        readInput(numAvailable, num);
+        numAvailable += num;
+        numToRead -= num;
+    }
+}
+
+void PolyphaseResampler::readInput(int dest, int numFrames)
+{
+    juce::AudioSourceChannelInfo info(&inputBuffer, 0, numFrames);
+    input->getNextAudioBlock(info);
+
+    if (dest < 0)
+        return;
+
+    for (int group = 0; group < numGroups; ++group) {
+        auto* frames = history + ((size_t) group * (size_t) historyCapacity + (size_t) dest) * (size_t) lanes;
+        for (int lane = 0; lane < lanes; ++lane) {
+            auto channel = group * lanes + lane;
+            if (channel >= numChannels)
+                break;
+
+            auto* source = inputBuffer.getReadPointer(channel);
+            for (int i = 0; i < numFrames; ++i)
+                frames[i * lanes + lane] = source[i];
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.h
+    Created: 19 Oct 2026 3:52:18am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/*
+    Changes the rate of an audio source in a single pass. It replaces the two
+    interpolating stages the decks used to have: the sample-rate conversion
+    inside AudioTransportSource and the speed change in ResamplingAudioSource.
+    Feed it the source at its own rate and set the ratio to speed times the
+    source rate over the device rate.
+
+    Every output sample is a windowed-sinc FIR over the input. The filter is
+    taken from a polyphase bank and interpolated between adjacent phases.
+    When the ratio is above 1 the passband of the bank is narrowed to the
+    output Nyquist, so playing faster does not alias. The banks for every
+    quality and a set of ratios are built once and shared by all instances.
+    At a ratio of exactly 1 the input is copied through unfiltered.
+
+    The filter runs on juce::dsp::SIMDRegister, one channel per lane, so
+    stereo costs the same as mono. Any number of channels is handled, in
+    groups of the SIMD width. Nothing is allocated after construction.
+*/
+class PolyphaseResampler  : public juce::AudioSource
+{
+public:
+    enum Quality
+    {
+        lowQuality = 0,     // 8 taps, for slow machines
+        mediumQuality,      // 16 taps, the default
+        highQuality,        // 48 taps
+        numQualities
+    };
+
+    /**
+    *   @param input the source to resample, which is not owned; its owner prepares it
+    *   @param numChannels the number of channels to process
+    */
+    PolyphaseResampler(juce::AudioSource* input, int numChannels);
+    ~PolyphaseResampler() override;
+
+    /**
+    *   Set the ratio, may be called from any thread.
+    *   @param samplesInPerOutputSample input samples consumed per output sample, 0 for silence
+    */
+    void setResamplingRatio(double samplesInPerOutputSample);
+
+    /** get the ratio */
+    double getResamplingRatio() const;
+
+    /** choose the filter length, may be called from any thread */
+    void setQuality(Quality quality);
+
+    /** get the filter length */
+    Quality getQuality() const;
+
+    /** forget the input read so far, the next block starts afresh from the input's current position */
+    void flushBuffers();
+
+    /**
+    *   Get how far the input has been read ahead of the sample that will be heard next,
+    *   exact for the block just rendered. Subtract it from the input's position to get
+    *   the position of the output.
+    *   @return the latency in input samples
+    */
+    double getLatencyInInputSamples() const;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    struct FilterBanks;
+
+    /**
+    *   Make sure the history holds the frames the rest of the block needs, as far
+    *   as they fit: drop what is behind the filter, then read from the input.
+    *   @param numRemaining the output samples left in the block
+    *   @param ratio the ratio of the block
+    *   @param halfTaps half the taps of the filter in use
+    */
+    void fillHistory(int numRemaining, double ratio, int halfTaps);
+
+    /** read frames from the input into the history, or throw them away if dest is negative */
+    void readInput(int dest, int numFrames);
+
+    static constexpr int inputChunkSize = 512;
+
+    juce::AudioSource* input;
+    const int numChannels;
+    const int numGroups;
+    const int lanes;
+
+    juce::SharedResourcePointer<FilterBanks> banks;
+    int maxHalfTaps = 0;
+
+    // the input since the oldest frame the filter can reach, interleaved one channel per lane
+    juce::HeapBlock<float> historyStorage;
+    float* history = nullptr;
+    int historyCapacity = 0;
+    int numAvailable = 0;
+    double position = 0.0;  // of the next output sample, in frames of the history
+
+    juce::AudioBuffer<float> inputBuffer;
+    juce::HeapBlock<float> coefficientStorage;
+    float* coefficients = nullptr;
+    std::vector<float*> outputs;
+
+    std::atomic<double> ratio{ 1.0 };
+    std::atomic<int> quality{ mediumQuality };
+    std::atomic<bool> flushPending{ true };
+    std::atomic<double> latency{ 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
@@ -0,0 +1,385 @@
+/*
+  ==============================================================================
+
+    PrefetchingReaderSource.cpp
+    Created: 18 Oct 2026 10:12:40am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "PrefetchingReaderSource.h"
+
+namespace
+{
+    // how often the background thread checks on an idle deck, and how long it
+    // keeps polling after a wake in case the deck starts moving
+    const int suspendedInterval = 100;
+    const juce::uint32 wakeHoldTime = 1000;
+
+    void copyChannels(juce::AudioBuffer<float>& dest, int destStart,
+                      const juce::AudioBuffer<float>& source, int sourceStart, int numSamples)
+    {
+        // a mono source fills every channel
+        for (int channel = 0; channel < dest.getNumChannels(); ++channel)
+            dest.copyFrom(channel, destStart, source,
+                          juce::jmin(channel, source.getNumChannels() - 1), sourceStart, numSamples);
+    }
+}
+
+PrefetchingReaderSource::PrefetchingReaderSource(juce::AudioFormatReader* _playbackReader,
+                                                 juce::AudioFormatReader* _prefetchReader,
+                                                 juce::TimeSliceThread& _thread)
+    : playbackReader(_playbackReader),
+      prefetchReader(_prefetchReader),
+      thread(_thread)
+{
+    jassert(playbackReader != nullptr);
+
+    if (prefetchReader != nullptr) {
+        // allocate every window up front so decoding never allocates
+        for (auto& window : windows)
+            window.buffer.reset(new juce::AudioBuffer<float>(2, windowSize));
+        scratch.reset(new juce::AudioBuffer<float>(2, windowSize));
+
+        thread.addTimeSliceClient(this);
+    }
+}
+
+PrefetchingReaderSource::~PrefetchingReaderSource()
+{
+    thread.removeTimeSliceClient(this);
+}
+
+void PrefetchingReaderSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+}
+
+void PrefetchingReaderSource::releaseResources()
+{
+}
+
+void PrefetchingReaderSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto& buffer = *bufferToFill.buffer;
+    auto position = nextReadPos.load();
+    auto total = getTotalLength();
+    auto start = loopStart.load(), end = loopEnd.load();
+    bool loopActive = start >= 0 && end > start;
+
+    auto readPos = position;
+    int done = 0;
+
+    while (done < bufferToFill.numSamples) {
+        auto remaining = bufferToFill.numSamples - done;
+
+        if (looping && total > 0)
+            readPos %= total;
+
+        // wrap at the exact sample the loop ends
+        if (loopActive && readPos >= end)
+            readPos = start + (readPos - end) % (end - start);
+
+        // before the start: silence up to sample 0
+        if (readPos < 0) {
+            auto num = (int) juce::jmin<juce::int64>(remaining, -readPos);
+            buffer.clear(bufferToFill.startSample + done, num);
+            readPos += num;
+            done += num;
+            continue;
+        }
+        // past the end: silence for the rest of the block
+        if (readPos >= total) {
+            buffer.clear(bufferToFill.startSample + done, remaining);
+            readPos += remaining;
+            break;
+        }
+
+        auto limit = (loopActive && readPos < end) ? juce::jmin(end, total) : total;
+        auto num = (int) juce::jmin<juce::int64>(remaining, limit - readPos);
+        auto copied = readSegment(buffer, bufferToFill.startSample + done, readPos, num);
+        readPos += copied;
+        done += copied;
+    }
+
+    // a seek from the message thread wins over advancing the old position
+    nextReadPos.compare_exchange_strong(position, readPos);
+}
+
+void PrefetchingReaderSource::readSamples(juce::AudioBuffer<float>& dest, int destStart,
+                                          juce::int64 position, int numSamples)
+{
+    auto total = getTotalLength();
+    int done = 0;
+
+    while (done < numSamples) {
+        auto readPos = position + done;
+        auto remaining = numSamples - done;
+
+        if (readPos < 0 || readPos >= total) {
+            // silence up to sample 0, or for the rest past the end
+            auto num = readPos < 0 ? (int) juce::jmin<juce::int64>(remaining, -readPos) : remaining;
+            dest.clear(destStart + done, num);
+            done += num;
+            continue;
+        }
+
+        auto num = (int) juce::jmin<juce::int64>(remaining, total - readPos);
+        done += readSegment(dest, destStart + done, readPos, num);
+    }
+}
+
+void PrefetchingReaderSource::setNextReadPosition(juce::int64 newPosition)
+{
+    // the background thread picks the new position up on its next time slice
+    nextReadPos = newPosition;
+}
+
+juce::int64 PrefetchingReaderSource::getNextReadPosition() const
+{
+    auto position = nextReadPos.load();
+    auto total = getTotalLength();
+    return (looping && total > 0) ? position % total : position;
+}
+
+juce::int64 PrefetchingReaderSource::getTotalLength() const
+{
+    return playbackReader->lengthInSamples;
+}
+
+bool PrefetchingReaderSource::isLooping() const
+{
+    return looping;
+}
+
+void PrefetchingReaderSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+}
+
+void PrefetchingReaderSource::setPrefetchHints(const juce::Array<juce::int64>& positions)
+{
+    const juce::ScopedLock sl(hintLock);
+    hints = positions;
+}
+
+void PrefetchingReaderSource::setLoopRegion(juce::int64 start, juce::int64 end)
+{
+    end = juce::jmin(end, getTotalLength());
+    if (start < 0 || end <= start) {
+        clearLoopRegion();
+        return;
+    }
+
+    // the end is cleared first, so the audio thread never sees a new start with an old end
+    loopEnd = -1;
+    loopStart = start;
+    loopEnd = end;
+}
+
+void PrefetchingReaderSource::clearLoopRegion()
+{
+    loopEnd = -1;
+    loopStart = -1;
+}
+
+bool PrefetchingReaderSource::isLoopRegionActive() const
+{
+    return loopStart.load() >= 0 && loopEnd.load() > loopStart.load();
+}
+
+void PrefetchingReaderSource::setIdle(bool isIdle)
+{
+    idle = isIdle;
+}
+
+void PrefetchingReaderSource::wake()
+{
+    lastWake = juce::Time::getMillisecondCounter();
+    thread.moveToFrontOfQueue(this);
+}
+
+void PrefetchingReaderSource::requestWake()
+{
+    // the next check sees a fresh wake and keeps polling
+    lastWake = juce::Time::getMillisecondCounter();
+}
+
+int PrefetchingReaderSource::useTimeSlice()
+{
+    auto total = prefetchReader->lengthInSamples;
+    if (total <= 0)
+        return 500;
+
+    // wanted windows in order of priority: the playhead, the one after it and
+    // the one before it for reverse play, the start of the track, then the hints
+    auto playhead = getWindowStart(juce::jlimit<juce::int64>(0, total - 1, getNextReadPosition()));
+    juce::Array<juce::int64> wanted;
+    wanted.add(playhead);
+    if (playhead + windowSize < total)
+        wanted.add(playhead + windowSize);
+    if (playhead >= windowSize)
+        wanted.add(playhead - windowSize);
+    wanted.addIfNotAlreadyThere(0);
+    {
+        const juce::ScopedLock sl(hintLock);
+        for (auto hint : hints) {
+            if (wanted.size() >= numWindows - 1)
+                break;
+            if (hint >= 0 && hint < total)
+                wanted.addIfNotAlreadyThere(getWindowStart(hint));
+        }
+    }
+
+    // the playhead comes first, then the loop region, then the rest
+    if (!isResident(playhead)) {
+        decodeWindow(playhead, wanted);
+        return 1;  // come back quickly, the playhead may have moved on
+    }
+    if (updateLoopBuffer())
+        return 1;
+
+    for (auto start : wanted) {
+        if (!isResident(start)) {
+            decodeWindow(start, wanted);
+            return 1;
+        }
+    }
+
+    // all decoded: a stopped deck only moves when it is woken, so check in rarely
+    if (idle && juce::Time::getMillisecondCounter() - lastWake.load() > wakeHoldTime)
+        return suspendedInterval;
+    return 10;
+}
+
+int PrefetchingReaderSource::readSegment(juce::AudioBuffer<float>& dest, int destStart,
+                                         juce::int64 position, int numSamples)
+{
+    auto copied = readFromLoop(dest, destStart, position, numSamples);
+
+    if (copied == 0)
+        copied = readFromWindows(dest, destStart, position, numSamples);
+
+    if (copied == 0) {
+        // not prefetched yet: decode straight from the playback reader
+        playbackReader->read(&dest, destStart, numSamples, position, true, true);
+        copied = numSamples;
+    }
+    return copied;
+}
+
+int PrefetchingReaderSource::readFromWindows(juce::AudioBuffer<float>& dest, int destStart,
+                                             juce::int64 position, int numSamples)
+{
+    for (auto& window : windows) {
+        auto start = window.start.load();
+        if (start < 0 || position < start || position >= start + windowSize)
+            continue;
+
+        // never wait for the background thread: fall back to the decoder instead
+        const juce::SpinLock::ScopedTryLockType sl(window.lock);
+        if (!sl.isLocked() || window.start.load() != start)
+            return 0;
+
+        auto offset = (int) (position - start);
+        auto num = juce::jmin(numSamples, window.numValid - offset);
+        if (num <= 0)
+            return 0;
+
+        copyChannels(dest, destStart, *window.buffer, offset, num);
+        return num;
+    }
+    return 0;
+}
+
+int PrefetchingReaderSource::readFromLoop(juce::AudioBuffer<float>& dest, int destStart,
+                                          juce::int64 position, int numSamples)
+{
+    const juce::SpinLock::ScopedTryLockType sl(loopLock);
+    if (!sl.isLocked() || loopBuffer == nullptr || position < loopBufferStart || position >= loopBufferEnd)
+        return 0;
+
+    auto num = (int) juce::jmin<juce::int64>(numSamples, loopBufferEnd - position);
+    copyChannels(dest, destStart, *loopBuffer, (int) (position - loopBufferStart), num);
+    return num;
+}
+
+bool PrefetchingReaderSource::updateLoopBuffer()
+{
+    auto start = loopStart.load();
+    auto end = juce::jmin(loopEnd.load(), prefetchReader->lengthInSamples);
+    bool wanted = start >= 0 && end > start && end - start <= maxLoopLength;
+
+    // only this thread writes the loop buffer, so it may look at it without the lock
+    if (wanted && loopBufferStart == start && loopBufferEnd == end)
+        return false;
+    if (!wanted && loopBuffer == nullptr)
+        return false;
+
+    std::unique_ptr<juce::AudioBuffer<float>> newBuffer;
+    if (wanted) {
+        newBuffer.reset(new juce::AudioBuffer<float>(2, (int) (end - start)));
+        prefetchReader->read(newBuffer.get(), 0, (int) (end - start), start, true, true);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType sl(loopLock);
+        std::swap(loopBuffer, newBuffer);
+        loopBufferStart = wanted ? start : -1;
+        loopBufferEnd = wanted ? end : -1;
+    }
+    // the old buffer is freed here, away from the audio thread
+    return true;
+}
+
+bool PrefetchingReaderSource::isResident(juce::int64 windowStart) const
+{
+    for (auto& window : windows)
+        if (window.start.load() == windowStart)
+            return true;
+    return false;
+}
+
+void PrefetchingReaderSource::decodeWindow(juce::int64 windowStart, const juce::Array<juce::int64>& wanted)
+{
+    auto length = (int) juce::jmin<juce::int64>(windowSize, prefetchReader->lengthInSamples - windowStart);
+    if (length <= 0)
+        return;
+
+    // decode without holding any lock, then swap the result in
+    prefetchReader->read(scratch.get(), 0, length, windowStart, true, true);
+
+    // replace an empty window, or else the unwanted one furthest from the playhead
+    auto playhead = nextReadPos.load();
+    int victim = -1;
+    juce::int64 furthest = -1;
+
+    for (int i = 0; i < numWindows; ++i) {
+        auto start = windows[i].start.load();
+        if (start < 0) {
+            victim = i;
+            break;
+        }
+        if (wanted.contains(start))
+            continue;
+
+        auto distance = std::abs(start - playhead);
+        if (distance > furthest) {
+            furthest = distance;
+            victim = i;
+        }
+    }
+    if (victim < 0)
+        return;
+
+    auto& window = windows[victim];
+    const juce::SpinLock::ScopedLockType sl(window.lock);
+    std::swap(window.buffer, scratch);
+    window.numValid = length;
+    window.start = windowStart;
+}
+
+juce::int64 PrefetchingReaderSource::getWindowStart(juce::int64 position) const
+{
+    return (position / windowSize) * windowSize;
+}
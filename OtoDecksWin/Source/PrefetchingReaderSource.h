@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    PrefetchingReaderSource.h
+    Created: 18 Oct 2026 10:12:40am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    A replacement for juce::AudioFormatReaderSource that keeps a handful of
+    decoded windows around the likely seek targets (both sides of the playhead,
+    the start of the track and any hint positions such as hot cues).
+
+    Windows are decoded on a background TimeSliceThread using a second reader,
+    so the playback reader only has to seek when a jump lands somewhere that
+    has not been prefetched yet. A burst of seeks from the position slider
+    collapses into the latest one, because the background thread only ever
+    looks at the current read position when it decides what to decode next.
+
+    An active loop region wraps at the exact sample. The whole region is
+    decoded into memory in the background, so the wrap never waits on the
+    decoder.
+*/
+class PrefetchingReaderSource  : public juce::PositionableAudioSource,
+                                 private juce::TimeSliceClient
+{
+public:
+    /**
+    *   Both readers must read the same file. The source takes ownership of them.
+    *   @param playbackReader the reader used on the audio thread
+    *   @param prefetchReader the reader used on the background thread, may be nullptr
+    *   @param thread the thread that decodes the prefetch windows
+    */
+    PrefetchingReaderSource(juce::AudioFormatReader* playbackReader,
+                            juce::AudioFormatReader* prefetchReader,
+                            juce::TimeSliceThread& thread);
+
+    ~PrefetchingReaderSource() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+    /**
+    *   Set extra positions worth keeping decoded, e.g. hot cue points.
+    *   @param positions the positions in source samples
+    */
+    void setPrefetchHints(const juce::Array<juce::int64>& positions);
+
+    /**
+    *   Loop a region until it is cleared. Playback wraps from the end back to
+    *   the start once it reaches the end. Safe to call from the audio thread.
+    *   @param start the first sample of the loop
+    *   @param end the sample after the last one of the loop
+    */
+    void setLoopRegion(juce::int64 start, juce::int64 end);
+
+    /** stop looping the region, playback carries on past its end. Safe to call from the audio thread. */
+    void clearLoopRegion();
+
+    /** true if a loop region is set */
+    bool isLoopRegionActive() const;
+
+    /**
+    *   Random access read for scratching and reverse playback, from the decoded
+    *   windows where possible. Does not move the read position or wrap loops.
+    *   Positions outside the track read as silence.
+    *   @param dest the buffer to fill
+    *   @param destStart the first sample to fill in dest
+    *   @param position the first source sample to read
+    *   @param numSamples the number of samples to read
+    */
+    void readSamples(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples);
+
+    /**
+    *   Tell the background thread whether the deck is idle. While it is, the
+    *   thread only checks in occasionally once everything wanted is decoded.
+    *   Safe to call from the audio thread.
+    *   @param isIdle true while the deck is stopped
+    */
+    void setIdle(bool isIdle);
+
+    /** have the background thread look at the read position now; takes a lock, so never from the audio thread */
+    void wake();
+
+    /**
+    *   Have the background thread look at the read position on its next check,
+    *   within a tenth of a second of an idle deck. Lock free, for the audio thread.
+    */
+    void requestWake();
+
+    /** get the reader used for playback */
+    juce::AudioFormatReader* getAudioFormatReader() const noexcept { return playbackReader.get(); }
+
+private:
+    struct Window
+    {
+        juce::SpinLock lock;
+        std::unique_ptr<juce::AudioBuffer<float>> buffer;
+        std::atomic<juce::int64> start{ -1 };
+        int numValid = 0;
+    };
+
+    int useTimeSlice() override;
+
+    /** read part of the track from memory or the decoder, returns the number of samples read */
+    int readSegment(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples);
+
+    /** copy from a decoded window if one covers the position, returns the number of samples copied */
+    int readFromWindows(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples);
+
+    /** copy from the decoded loop region if it covers the position, returns the number of samples copied */
+    int readFromLoop(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples);
+
+    /** decode the loop region, or free it once the loop is cleared, returns true if it did any work */
+    bool updateLoopBuffer();
+
+    bool isResident(juce::int64 windowStart) const;
+    void decodeWindow(juce::int64 windowStart, const juce::Array<juce::int64>& wanted);
+    juce::int64 getWindowStart(juce::int64 position) const;
+
+    static constexpr int numWindows = 16;
+    static constexpr int windowSize = 32768;
+
+    // longer loops are played from the windows instead of being held in memory
+    static constexpr int maxLoopLength = 1 << 22;
+
+    std::unique_ptr<juce::AudioFormatReader> playbackReader;
+    std::unique_ptr<juce::AudioFormatReader> prefetchReader;
+    juce::TimeSliceThread& thread;
+
+    Window windows[numWindows];
+    std::unique_ptr<juce::AudioBuffer<float>> scratch;
+
+    juce::CriticalSection hintLock;
+    juce::Array<juce::int64> hints;
+
+    std::atomic<juce::int64> loopStart{ -1 };
+    std::atomic<juce::int64> loopEnd{ -1 };
+
+    // the decoded loop region, swapped in by the background thread
+    juce::SpinLock loopLock;
+    std::unique_ptr<juce::AudioBuffer<float>> loopBuffer;
+    juce::int64 loopBufferStart = -1;
+    juce::int64 loopBufferEnd = -1;
+
+    std::atomic<juce::int64> nextReadPos{ 0 };
+    std::atomic<bool> looping{ false };
+
+    // an idle deck lets the background thread sleep, a wake keeps it polling for a while
+    std::atomic<bool> idle{ false };
+    std::atomic<juce::uint32> lastWake{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PrefetchingReaderSource)
+};
@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+    SamplePadBank.cpp
+    Created: 19 Oct 2026 10:05:21am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "SamplePadBank.h"
+
+namespace
+{
+    // a stolen or released voice fades out over this many samples
+    const int fadeLength = 256;
+
+    // longer files are tracks, not samples
+    const double maxSampleSeconds = 60.0;
+}
+
+SamplePadBank::SamplePadBank()
+{
+    for (int pad = 0; pad < numPads; ++pad) {
+        generations[pad] = 0;
+        playingVoices[pad] = 0;
+    }
+}
+
+SamplePadBank::~SamplePadBank()
+{
+}
+
+bool SamplePadBank::loadSample(int pad, const juce::File& file, juce::AudioFormatManager& formatManager, bool looped)
+{
+    if (pad < 0 || pad >= numPads) {
+        std::cout << "SamplePadBank::loadSample pad should be between 0 and " << numPads - 1 << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0) {
+        std::cout << "SamplePadBank::loadSample could not read " << file.getFullPathName() << std::endl;
+        return false;
+    }
+    if (reader->lengthInSamples > maxSampleSeconds * reader->sampleRate) {
+        std::cout << "SamplePadBank::loadSample samples should be shorter than " << maxSampleSeconds << " seconds" << std::endl;
+        return false;
+    }
+
+    // the whole sample goes into memory, mono samples on both channels
+    Sample::Ptr sample = new Sample();
+    sample->original.setSize(2, (int) reader->lengthInSamples);
+    reader->read(&sample->original, 0, (int) reader->lengthInSamples, 0, true, true);
+    sample->originalRate = reader->sampleRate;
+    sample->looped = looped;
+    sample->name = file.getFileNameWithoutExtension();
+
+    auto sampleRate = deviceSampleRate.load();
+    convert(*sample, sampleRate);
+    {
+        const juce::SpinLock::ScopedLockType sl(sampleLock);
+        // the device changed its rate while the sample was being converted
+        if (sample->rate != deviceSampleRate)
+            convert(*sample, deviceSampleRate);
+        std::swap(samples[pad], sample);
+        ++generations[pad];
+    }
+    // the voices playing the old sample stop with the new generation
+    retire(sample);
+    return true;
+}
+
+void SamplePadBank::clearSample(int pad)
+{
+    if (pad < 0 || pad >= numPads)
+        return;
+
+    Sample::Ptr old;
+    {
+        const juce::SpinLock::ScopedLockType sl(sampleLock);
+        std::swap(samples[pad], old);
+        ++generations[pad];
+    }
+    retire(old);
+}
+
+void SamplePadBank::retire(Sample::Ptr sample)
+{
+    if (sample != nullptr)
+        retiredSamples.add(sample);
+
+    // a sample only this array refers to is no longer being played
+    for (int i = retiredSamples.size(); --i >= 0;)
+        if (retiredSamples.getObjectPointerUnchecked(i)->getReferenceCount() == 1)
+            retiredSamples.remove(i);
+}
+
+bool SamplePadBank::hasSample(int pad) const
+{
+    return pad >= 0 && pad < numPads && samples[pad] != nullptr;
+}
+
+bool SamplePadBank::isLooped(int pad) const
+{
+    return hasSample(pad) && samples[pad]->looped;
+}
+
+juce::String SamplePadBank::getSampleName(int pad) const
+{
+    return hasSample(pad) ? samples[pad]->name : juce::String();
+}
+
+bool SamplePadBank::isPadPlaying(int pad) const
+{
+    return pad >= 0 && pad < numPads && playingVoices[pad] > 0;
+}
+
+void SamplePadBank::trigger(int pad, juce::int64 time, TriggerSource source)
+{
+    if (pad < 0 || pad >= numPads) {
+        std::cout << "SamplePadBank::trigger pad should be between 0 and " << numPads - 1 << std::endl;
+        return;
+    }
+    push({ time, pad, Trigger::fire }, source);
+}
+
+void SamplePadBank::release(int pad, juce::int64 time, TriggerSource source)
+{
+    if (pad < 0 || pad >= numPads) {
+        std::cout << "SamplePadBank::release pad should be between 0 and " << numPads - 1 << std::endl;
+        return;
+    }
+    push({ time, pad, Trigger::stop }, source);
+}
+
+void SamplePadBank::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    padBuffer.setSize(2, juce::jmax(1, samplesPerBlockExpected));
+
+    const juce::SpinLock::ScopedLockType sl(sampleLock);
+    deviceSampleRate = sampleRate;
+    for (auto& sample : samples)
+        if (sample != nullptr && sample->rate != sampleRate)
+            convert(*sample, sampleRate);
+
+    // positions in the old rate mean nothing now
+    for (auto& voice : voices)
+        voice = Voice();
+}
+
+void SamplePadBank::convert(Sample& sample, double sampleRate)
+{
+    auto ratio = sample.originalRate / sampleRate;
+    auto numIn = sample.original.getNumSamples();
+    auto numOut = juce::jmax(1, (int) (numIn / ratio));
+
+    sample.audio.setSize(2, numOut);
+    for (int channel = 0; channel < 2; ++channel) {
+        if (ratio == 1.0) {
+            sample.audio.copyFrom(channel, 0, sample.original, channel, 0, numOut);
+        }
+        else {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, sample.original.getReadPointer(channel), sample.audio.getWritePointer(channel), numOut, numIn, 0);
+        }
+    }
+    sample.rate = sampleRate;
+}
+
+void SamplePadBank::push(const Trigger& trigger, TriggerSource source)
+{
+    auto& queue = triggerQueues[source];
+
+    int start1, size1, start2, size2;
+    queue.fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1) {
+        std::cout << "SamplePadBank::push the trigger queue is full" << std::endl;
+        return;
+    }
+    queue.triggers[size1 > 0 ? start1 : start2] = trigger;
+    queue.fifo.finishedWrite(1);
+}
+
+void SamplePadBank::collectTriggers()
+{
+    for (auto& queue : triggerQueues) {
+        int start1, size1, start2, size2;
+        queue.fifo.prepareToRead(queue.fifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1 + size2; ++i) {
+            auto& trigger = queue.triggers[i < size1 ? start1 + i : start2 + i - size1];
+
+            if (numPending == triggerQueueSize)
+                break;
+
+            // insert sorted, triggers due at the same time keep their order
+            auto index = numPending;
+            while (index > 0 && pending[index - 1].time > trigger.time) {
+                pending[index] = pending[index - 1];
+                --index;
+            }
+            pending[index] = trigger;
+            ++numPending;
+        }
+        queue.fifo.finishedRead(size1 + size2);
+    }
+}
+
+void SamplePadBank::renderNextBlock(juce::AudioBuffer<float>& output, int startSample, int numSamples, juce::int64 clock)
+{
+    if (numSamples > padBuffer.getNumSamples())
+        return;
+
+    // a sample is being swapped: the pads play on from the samples of the last block;
+    // a sample only leaves activeSamples here, and retiredSamples still holds it then
+    {
+        const juce::SpinLock::ScopedTryLockType sl(sampleLock);
+        if (sl.isLocked()) {
+            for (int pad = 0; pad < numPads; ++pad) {
+                activeSamples[pad] = samples[pad];
+                activeGenerations[pad] = generations[pad];
+            }
+        }
+    }
+
+    collectTriggers();
+    padBuffer.clear(0, numSamples);
+
+    int done = 0;
+    while (done < numSamples) {
+        int numDue = 0;
+        while (numDue < numPending && pending[numDue].time <= clock + done) {
+            perform(pending[numDue], clock + done);
+            ++numDue;
+        }
+        if (numDue > 0) {
+            numPending -= numDue;
+            for (int i = 0; i < numPending; ++i)
+                pending[i] = pending[i + numDue];
+        }
+
+        // render up to the next trigger, or the end of the block
+        auto end = numSamples;
+        if (numPending > 0)
+            end = (int) juce::jmin<juce::int64>(end, pending[0].time - clock);
+
+        renderVoices(done, end - done);
+        done = end;
+    }
+
+    int counts[numPads] = {};
+    for (auto& voice : voices)
+        if (voice.main.pad >= 0)
+            ++counts[voice.main.pad];
+    for (int pad = 0; pad < numPads; ++pad)
+        playingVoices[pad] = counts[pad];
+
+    // every pad reaches the master bus in this one pass
+    for (int channel = 0; channel < juce::jmin(2, output.getNumChannels()); ++channel)
+        output.addFrom(channel, startSample, padBuffer, channel, 0, numSamples);
+}
+
+void SamplePadBank::perform(const Trigger& trigger, juce::int64 time)
+{
+    auto* sample = activeSamples[trigger.pad].get();
+
+    if (trigger.type == Trigger::stop || (sample != nullptr && sample->looped && playingVoices[trigger.pad] > 0)) {
+        for (auto& voice : voices)
+            if (voice.main.pad == trigger.pad)
+                fadeOut(voice);
+        playingVoices[trigger.pad] = 0;
+        return;
+    }
+    if (sample == nullptr)
+        return;
+
+    // a silent voice, then one whose fade has the least left to run, which it
+    // carries on; only when every voice is playing is the oldest stolen
+    Voice* chosen = nullptr;
+    for (auto& voice : voices) {
+        if (voice.main.pad >= 0)
+            continue;
+        if (chosen == nullptr || voice.tailRemaining < chosen->tailRemaining)
+            chosen = &voice;
+        if (chosen->tailRemaining == 0)
+            break;
+    }
+    if (chosen == nullptr) {
+        for (auto& voice : voices)
+            if (chosen == nullptr || voice.startedAt < chosen->startedAt)
+                chosen = &voice;
+        fadeOut(*chosen);
+    }
+
+    chosen->main = { trigger.pad, activeGenerations[trigger.pad], 0 };
+    chosen->startedAt = time;
+    ++playingVoices[trigger.pad];
+}
+
+void SamplePadBank::fadeOut(Voice& voice)
+{
+    // a silent voice keeps the fade it may still be running
+    if (voice.main.pad < 0)
+        return;
+
+    voice.tail = voice.main;
+    voice.tailRemaining = fadeLength;
+    voice.main.pad = -1;
+}
+
+void SamplePadBank::renderVoices(int offset, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    for (auto& voice : voices) {
+        if (voice.tailRemaining > 0) {
+            if (renderPlayhead(voice.tail, offset, numSamples, voice.tailRemaining))
+                voice.tailRemaining = juce::jmax(0, voice.tailRemaining - numSamples);
+            else
+                voice.tailRemaining = 0;
+        }
+        if (voice.main.pad >= 0 && !renderPlayhead(voice.main, offset, numSamples, 0))
+            voice.main.pad = -1;
+    }
+}
+
+bool SamplePadBank::renderPlayhead(Playhead& playhead, int offset, int numSamples, int fadeRemaining)
+{
+    // the pad was loaded with another sample, or cleared, since this started
+    auto* sample = activeSamples[playhead.pad].get();
+    if (sample == nullptr || playhead.generation != activeGenerations[playhead.pad])
+        return false;
+
+    auto length = (juce::int64) sample->audio.getNumSamples();
+    if (fadeRemaining > 0)
+        numSamples = juce::jmin(numSamples, fadeRemaining);
+
+    int done = 0;
+    while (done < numSamples) {
+        auto num = (int) juce::jmin<juce::int64>(numSamples - done, length - playhead.position);
+
+        for (int channel = 0; channel < 2; ++channel) {
+            auto* source = sample->audio.getReadPointer(channel, (int) playhead.position);
+            auto* destination = padBuffer.getWritePointer(channel, offset + done);
+
+            if (fadeRemaining > 0) {
+                // linear fade from where the fade has got to
+                auto gain = (float) (fadeRemaining - done) / fadeLength;
+                auto step = 1.0f / fadeLength;
+                for (int i = 0; i < num; ++i)
+                    destination[i] += source[i] * (gain - step * i);
+            }
+            else {
+                juce::FloatVectorOperations::add(destination, source, num);
+            }
+        }
+        done += num;
+        playhead.position += num;
+
+        if (playhead.position >= length) {
+            if (!sample->looped)
+                return false;
+            playhead.position = 0;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    SamplePadBank.h
+    Created: 19 Oct 2026 10:05:21am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/*
+    Sample pads for one-shots and loops: air horns, drops, sirens.
+
+    Each pad's sample is read into memory in full when it is loaded, and
+    converted to the device sample rate, so playing it never touches the disk.
+    The voices are a fixed pool made up front; when all of them are busy the
+    oldest one is stolen and faded out over a few milliseconds while the new
+    sound starts in its place.
+
+    Triggers are queued lock-free, one queue per thread that fires pads, and
+    carried out at the exact sample of the master clock they are due. All
+    voices are summed into one pad buffer which is added to the master bus in
+    a single pass.
+*/
+class SamplePadBank
+{
+public:
+    /** the threads that fire pads, each has its own queue */
+    enum TriggerSource
+    {
+        messageThread = 0,
+        midiThread,
+        numTriggerSources
+    };
+
+    static constexpr int numPads = 8;
+    static constexpr int maxVoices = 16;
+
+    SamplePadBank();
+    ~SamplePadBank();
+
+    /**
+    *   Read a sample into a pad, replacing the one it held.
+    *   @param pad the pad, 0 to numPads - 1
+    *   @param file the audio file
+    *   @param formatManager the formats the file can be read with
+    *   @param looped true to loop the sample until the pad is fired again
+    *   @return true if the sample was loaded
+    */
+    bool loadSample(int pad, const juce::File& file, juce::AudioFormatManager& formatManager, bool looped);
+
+    /** remove the sample of a pad, which silences it */
+    void clearSample(int pad);
+
+    /** true if the pad holds a sample */
+    bool hasSample(int pad) const;
+
+    /** true if the pad's sample loops */
+    bool isLooped(int pad) const;
+
+    /** get the file name of the pad's sample, empty if none */
+    juce::String getSampleName(int pad) const;
+
+    /** true while the pad has a voice playing, as of the last block */
+    bool isPadPlaying(int pad) const;
+
+    /**
+    *   Fire a pad at a sample of the master clock. A one-shot starts another voice,
+    *   a looped pad that is playing stops instead.
+    *   @param pad the pad
+    *   @param time the master clock time, a time that has passed fires it in the next block
+    *   @param source the thread calling, only one thread may use each source
+    */
+    void trigger(int pad, juce::int64 time = 0, TriggerSource source = messageThread);
+
+    /**
+    *   Fade out every voice of a pad at a sample of the master clock.
+    *   @param pad the pad
+    *   @param time the master clock time, a time that has passed releases it in the next block
+    *   @param source the thread calling, only one thread may use each source
+    */
+    void release(int pad, juce::int64 time = 0, TriggerSource source = messageThread);
+
+    /** convert the samples to the device sample rate and size the pad buffer */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /**
+    *   Render the pads for a block and add them to the master bus. Audio thread only.
+    *   @param output the master bus, its first two channels are used
+    *   @param startSample the first sample of the block in output
+    *   @param numSamples the length of the block
+    *   @param clock the master clock time of the block's first sample
+    */
+    void renderNextBlock(juce::AudioBuffer<float>& output, int startSample, int numSamples, juce::int64 clock);
+
+private:
+    // shared by the message thread and the audio thread, which keeps the ones
+    // it plays while a swap holds the lock; only the message thread deletes them
+    struct Sample  : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<Sample>;
+
+        juce::AudioBuffer<float> original;
+        double originalRate = 44100.0;
+
+        // two channels at the device sample rate
+        juce::AudioBuffer<float> audio;
+        double rate = 0.0;
+
+        bool looped = false;
+        juce::String name;
+    };
+
+    struct Trigger
+    {
+        enum Type { fire, stop };
+
+        juce::int64 time = 0;
+        int pad = 0;
+        Type type = fire;
+    };
+
+    // a position in a pad's sample
+    struct Playhead
+    {
+        int pad = -1;  // -1 when silent
+        juce::uint32 generation = 0;
+        juce::int64 position = 0;
+    };
+
+    struct Voice
+    {
+        Playhead main;
+
+        // the sound the voice played before it was stolen or released, fading out
+        Playhead tail;
+        int tailRemaining = 0;
+
+        juce::int64 startedAt = 0;
+    };
+
+    /** convert a sample to the device sample rate */
+    static void convert(Sample& sample, double sampleRate);
+
+    /** queue a trigger for the audio thread */
+    void push(const Trigger& trigger, TriggerSource source);
+
+    /** move the queued triggers into the pending list, sorted by time */
+    void collectTriggers();
+
+    /** carry out a trigger at its time */
+    void perform(const Trigger& trigger, juce::int64 time);
+
+    /** render all voices into part of the pad buffer */
+    void renderVoices(int offset, int numSamples);
+
+    /**
+    *   Add a playhead's sound to the pad buffer and move it on.
+    *   @param fadeRemaining for a tail, the samples left of its fade, otherwise 0
+    *   @return false once the sound has ended
+    */
+    bool renderPlayhead(Playhead& playhead, int offset, int numSamples, int fadeRemaining);
+
+    /** move a voice's sound to its tail, so it fades out; a stolen voice's running fade is cut */
+    void fadeOut(Voice& voice);
+
+    /** put a replaced sample aside until the audio thread lets go of it, and delete the ones it has */
+    void retire(Sample::Ptr sample);
+
+    Sample::Ptr samples[numPads];
+    std::atomic<juce::uint32> generations[numPads];
+    std::atomic<int> playingVoices[numPads];
+
+    // the message thread swaps samples under it, the audio thread only tries it
+    juce::SpinLock sampleLock;
+
+    // the samples as of the audio thread's last successful try, played from while a swap holds the lock
+    Sample::Ptr activeSamples[numPads];
+    juce::uint32 activeGenerations[numPads] = {};
+
+    // replaced samples the audio thread may still hold, message thread only
+    juce::ReferenceCountedArray<Sample> retiredSamples;
+
+    std::atomic<double> deviceSampleRate{ 44100.0 };
+    juce::AudioBuffer<float> padBuffer;
+    Voice voices[maxVoices];
+
+    // single producer, single consumer: one queue per source
+    static constexpr int triggerQueueSize = 128;
+    struct TriggerQueue
+    {
+        juce::AbstractFifo fifo{ triggerQueueSize };
+        Trigger triggers[triggerQueueSize];
+    };
+    TriggerQueue triggerQueues[numTriggerSources];
+
+    // triggers waiting for their time, audio thread only
+    Trigger pending[triggerQueueSize];
+    int numPending = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplePadBank)
+};
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    SamplePadGUI.cpp
+    Created: 19 Oct 2026 10:48:02am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SamplePadGUI.h"
+
+//==============================================================================
+SamplePadGUI::SamplePadGUI(SamplePadBank* _pads, juce::AudioFormatManager& formatManagerToUse)
+    : pads{ _pads }, formatManager(formatManagerToUse)
+{
+    for (int i = 0; i < SamplePadBank::numPads; ++i) {
+        padButtons[i].setButtonText("PAD " + juce::String(i + 1));
+        addAndMakeVisible(padButtons[i]);
+        padButtons[i].addListener(this);
+    }
+    addAndMakeVisible(loopButton);
+    loopButton.setClickingTogglesState(true);
+
+    startTimer(50);
+}
+
+SamplePadGUI::~SamplePadGUI()
+{
+}
+
+void SamplePadGUI::resized()
+{
+    // two columns of pads, the LOOP button along the bottom
+    double rowH = getHeight() / (SamplePadBank::numPads / 2 + 1);
+    double columnW = getWidth() / 2;
+    for (int i = 0; i < SamplePadBank::numPads; ++i)
+        padButtons[i].setBounds(columnW * (i % 2), rowH * (i / 2), columnW, rowH);
+    loopButton.setBounds(0, rowH * (SamplePadBank::numPads / 2), getWidth(), rowH);
+}
+
+/**
+*   Set the custom styles and colors for the pads.
+*   @param g the graphics to be painted
+*/
+
+void SamplePadGUI::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::navy);
+
+    g.setColour(juce::Colours::grey);
+    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
+
+    // set color for the pads, lit while playing
+    for (auto& button : padButtons) {
+        button.setColour(juce::TextButton::buttonColourId, juce::Colour(34, 53, 70));
+        button.setColour(juce::TextButton::buttonOnColourId, juce::Colour(255, 53, 90));
+        button.setColour(juce::TextButton::textColourOffId, juce::Colours::lightyellow);
+        button.setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+    }
+    loopButton.setColour(juce::TextButton::buttonColourId, juce::Colour(255, 219, 255));
+    loopButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(115, 181, 221));
+    loopButton.setColour(juce::TextButton::textColourOffId, juce::Colour(34, 53, 70));
+    loopButton.setColour(juce::TextButton::textColourOnId, juce::Colour(34, 53, 70));
+}
+
+/**
+*   Click an empty pad to load a sample, click a loaded pad to fire it,
+*   shift-click to clear it.
+*   @param button the button to be processed
+*/
+
+void SamplePadGUI::buttonClicked(juce::Button* button)
+{
+    for (int i = 0; i < SamplePadBank::numPads; ++i) {
+        if (button != &padButtons[i])
+            continue;
+
+        if (juce::ModifierKeys::currentModifiers.isShiftDown()) {
+            pads->clearSample(i);
+            padButtons[i].setButtonText("PAD " + juce::String(i + 1));
+        }
+        else if (pads->hasSample(i)) {
+            pads->trigger(i);
+        }
+        else {
+            juce::FileChooser chooser{ "Select a sample..." };
+            if (chooser.browseForFileToOpen()
+                && pads->loadSample(i, chooser.getResult(), formatManager, loopButton.getToggleState()))
+                padButtons[i].setButtonText(pads->getSampleName(i));
+        }
+    }
+}
+
+/**
+*   Light up the pads which are playing.
+*/
+
+void SamplePadGUI::timerCallback()
+{
+    for (int i = 0; i < SamplePadBank::numPads; ++i)
+        padButtons[i].setToggleState(pads->isPadPlaying(i), juce::dontSendNotification);
+}
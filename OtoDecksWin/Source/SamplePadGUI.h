@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    SamplePadGUI.h
+    Created: 19 Oct 2026 10:48:02am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SamplePadBank.h"
+
+//==============================================================================
+/*
+*/
+class SamplePadGUI  : public juce::Component,
+                      public juce::Button::Listener,
+                      public juce::Timer
+{
+public:
+    SamplePadGUI(SamplePadBank* _pads, juce::AudioFormatManager& formatManagerToUse);
+
+    ~SamplePadGUI() override;
+
+    void resized() override;
+
+    /**
+    *   Set the custom styles and colors for the pads.
+    *   @param g the graphics to be painted
+    */
+
+    void paint(juce::Graphics& g) override;
+
+    /**
+    *   Click an empty pad to load a sample, click a loaded pad to fire it,
+    *   shift-click to clear it.
+    *   @param button the button to be processed
+    */
+
+    void buttonClicked(juce::Button* button) override;
+
+    /**
+    *   Light up the pads which are playing.
+    */
+
+    void timerCallback() override;
+
+
+private:
+    juce::TextButton padButtons[SamplePadBank::numPads];
+
+    // samples loaded while this is on loop until their pad is fired again
+    juce::TextButton loopButton{ "LOOP" };
+
+    SamplePadBank* pads;
+    juce::AudioFormatManager& formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplePadGUI)
+};
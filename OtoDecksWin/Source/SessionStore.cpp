@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    SessionStore.cpp
+    Created: 20 Oct 2026 12:18:05am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "SessionStore.h"
+#include "AppData.h"
+
+SessionStore::SessionStore(juce::File _sessionFile)
+    : juce::Thread("Session writer"), sessionFile(_sessionFile)
+{
+    startThread(2);
+}
+
+SessionStore::~SessionStore()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+
+    // the final snapshot, usually taken while the app is closing
+    const juce::ScopedLock sl(lock);
+    if (pending.isNotEmpty())
+        write(pending);
+}
+
+juce::Array<DeckSession> SessionStore::load() const
+{
+    juce::Array<DeckSession> decks;
+    if (!sessionFile.existsAsFile())
+        return decks;
+
+    auto xml = juce::parseXML(sessionFile);
+    if (xml == nullptr || !xml->hasTagName("SESSION")) {
+        std::cout << "SessionStore::load could not parse " << sessionFile.getFullPathName() << std::endl;
+        return decks;
+    }
+
+    for (auto* element : xml->getChildWithTagNameIterator("DECK")) {
+        DeckSession deck;
+        auto path = element->getStringAttribute("track");
+        if (juce::File::isAbsolutePath(path))
+            deck.trackFile = juce::File(path);
+        deck.position = element->getDoubleAttribute("position");
+        deck.speed = element->getDoubleAttribute("speed", 1.0);
+        deck.gain = element->getDoubleAttribute("gain", 1.0);
+        deck.cueEnabled = element->getBoolAttribute("cue");
+        for (auto& cue : juce::StringArray::fromTokens(element->getStringAttribute("hotCues"), false))
+            deck.hotCues.add(cue.getDoubleValue());
+        decks.add(deck);
+    }
+    return decks;
+}
+
+void SessionStore::save(const juce::Array<DeckSession>& decks)
+{
+    juce::XmlElement xml("SESSION");
+
+    for (auto& deck : decks) {
+        auto* element = xml.createNewChildElement("DECK");
+        element->setAttribute("track", deck.trackFile.getFullPathName());
+        element->setAttribute("position", deck.position);
+        element->setAttribute("speed", deck.speed);
+        element->setAttribute("gain", deck.gain);
+        element->setAttribute("cue", deck.cueEnabled);
+
+        juce::StringArray cues;
+        for (auto cue : deck.hotCues)
+            cues.add(juce::String(cue));
+        element->setAttribute("hotCues", cues.joinIntoString(" "));
+    }
+
+    auto text = xml.toString();
+    if (text == lastSaved)
+        return;
+    lastSaved = text;
+
+    {
+        const juce::ScopedLock sl(lock);
+        pending = text;
+    }
+    notify();
+}
+
+juce::File SessionStore::getDefaultSessionFile()
+{
+    // each snapshot replaces the last, the next start restores whichever was written last
+    return AppData::getFile("session.xml");
+}
+
+void SessionStore::run()
+{
+    while (!threadShouldExit()) {
+        wait(-1);
+
+        juce::String text;
+        {
+            const juce::ScopedLock sl(lock);
+            std::swap(text, pending);
+        }
+        if (text.isNotEmpty())
+            write(text);
+    }
+}
+
+void SessionStore::write(const juce::String& text)
+{
+    // written next to the session file, then moved over it in one step
+    juce::TemporaryFile temp(sessionFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk() || !out.writeText(text, false, false, nullptr)) {
+            std::cout << "SessionStore::write could not write " << temp.getFile().getFullPathName() << std::endl;
+            return;
+        }
+
+        // on disk before it replaces the old session
+        out.flush();
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+        std::cout << "SessionStore::write could not replace " << sessionFile.getFullPathName() << std::endl;
+}
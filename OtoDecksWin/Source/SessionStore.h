@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    SessionStore.h
+    Created: 20 Oct 2026 12:18:05am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    What was on one deck, and where, when the session was last saved.
+*/
+struct DeckSession
+{
+    /** the loaded track, a default File if the deck was empty */
+    juce::File trackFile;
+
+    /** position of the playhead in seconds */
+    double position = 0.0;
+
+    /** the speed ratio set on the deck, negative in reverse */
+    double speed = 1.0;
+
+    /** the volume, 0 to 1 */
+    double gain = 1.0;
+
+    /** true if the deck was sent to the headphones */
+    bool cueEnabled = false;
+
+    /** the hot cues in seconds, negative for an empty slot */
+    juce::Array<double> hotCues;
+};
+
+//==============================================================================
+/*
+    Keeps the state of the decks on disk, so a crash or a restart during a set
+    can carry on from where it was.
+
+    Snapshots are taken on the message thread and written on a background
+    thread, into a temporary file which then replaces the session file, so a
+    crash while writing leaves the previous session intact.
+*/
+class SessionStore  : private juce::Thread
+{
+public:
+    SessionStore(juce::File sessionFile);
+
+    /** writes the last snapshot if the background thread has not written it yet */
+    ~SessionStore() override;
+
+    /**
+    *   Read the session saved by a previous run.
+    *   @return one state per deck, empty if there is no session
+    */
+    juce::Array<DeckSession> load() const;
+
+    /**
+    *   Queue a snapshot of the decks to be written in the background.
+    *   Nothing is written if the decks have not changed since the last one.
+    *   @param decks one state per deck
+    */
+    void save(const juce::Array<DeckSession>& decks);
+
+    /** the session file used by the application */
+    static juce::File getDefaultSessionFile();
+
+private:
+    void run() override;
+
+    /** write a snapshot to the session file, replacing it atomically */
+    void write(const juce::String& text);
+
+    juce::File sessionFile;
+
+    juce::CriticalSection lock;
+    juce::String pending;  // guarded by lock, empty once written
+
+    juce::String lastSaved;  // message thread only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionStore)
+};
@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    SetRecorder.cpp
+    Created: 19 Oct 2026 12:26:05am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "SetRecorder.h"
+
+namespace
+{
+    // how often the writer thread wakes up, and how often the WAV header is rewritten
+    const int writeIntervalMs = 50;
+    const juce::int64 headerIntervalMs = 1000;
+
+    const int bitsPerSample = 24;
+
+    // the reserved space is written in pieces of this size
+    const int zeroChunkSize = 64 * 1024;
+    const char zeroChunk[zeroChunkSize] = {};
+}
+
+SetRecorder::SetRecorder() : juce::Thread("Set recorder")
+{
+}
+
+SetRecorder::~SetRecorder()
+{
+    stop();
+}
+
+bool SetRecorder::start(const juce::File& masterFile, Format format, int numStems, double sampleRate)
+{
+    stop();
+
+    if (sampleRate <= 0) {
+        std::cout << "SetRecorder::start the audio device is not running" << std::endl;
+        return false;
+    }
+
+    juce::OwnedArray<Track> newTracks;
+    newTracks.add(createTrack(masterFile, format, sampleRate).release());
+
+    for (int stem = 0; stem < numStems; ++stem) {
+        auto stemFile = masterFile.getSiblingFile(masterFile.getFileNameWithoutExtension()
+                                                  + "_Deck" + juce::String(stem + 1)
+                                                  + masterFile.getFileExtension());
+        newTracks.add(createTrack(stemFile, format, sampleRate).release());
+    }
+
+    if (newTracks.contains(nullptr)) {
+        for (auto* track : newTracks) {
+            if (track != nullptr) {
+                finishTrack(*track);
+                track->file.deleteFile();
+            }
+        }
+        return false;
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(trackLock);
+        tracks.swapWith(newTracks);
+        recording = true;
+    }
+    startThread();
+    return true;
+}
+
+void SetRecorder::stop()
+{
+    if (!recording)
+        return;
+
+    // once the lock is released the audio thread does not touch the tracks any more
+    {
+        const juce::SpinLock::ScopedLockType lock(trackLock);
+        recording = false;
+    }
+
+    // the writer drains the FIFOs before it exits
+    stopThread(10000);
+
+    for (auto* track : tracks)
+        finishTrack(*track);
+}
+
+bool SetRecorder::isRecording() const
+{
+    return recording;
+}
+
+void SetRecorder::pushMaster(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const juce::SpinLock::ScopedTryLockType lock(trackLock);
+    if (!lock.isLocked() || !recording)
+        return;
+
+    push(*tracks[0], buffer, startSample, numSamples);
+}
+
+void SetRecorder::pushStem(int stem, const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const juce::SpinLock::ScopedTryLockType lock(trackLock);
+    if (!lock.isLocked() || !recording || stem + 1 >= tracks.size())
+        return;
+
+    push(*tracks[stem + 1], buffer, startSample, numSamples);
+}
+
+juce::int64 SetRecorder::getRecordedSamples() const
+{
+    return tracks.isEmpty() ? 0 : tracks[0]->written.load();
+}
+
+juce::int64 SetRecorder::getDroppedSamples() const
+{
+    juce::int64 dropped = 0;
+    for (auto* track : tracks)
+        dropped += track->dropped;
+    return dropped;
+}
+
+void SetRecorder::run()
+{
+    auto lastHeader = juce::Time::currentTimeMillis();
+
+    while (!threadShouldExit()) {
+        for (auto* track : tracks)
+            writePending(*track);
+
+        // keep the header up to date, so a crash loses at most this interval
+        auto now = juce::Time::currentTimeMillis();
+        if (now - lastHeader >= headerIntervalMs) {
+            for (auto* track : tracks)
+                track->writer->flush();
+            lastHeader = now;
+        }
+
+        wait(writeIntervalMs);
+    }
+
+    // whatever came in before recording stopped
+    for (auto* track : tracks)
+        writePending(*track);
+}
+
+std::unique_ptr<SetRecorder::Track> SetRecorder::createTrack(const juce::File& file, Format format, double sampleRate)
+{
+    auto track = std::make_unique<Track>();
+    track->file = file.getNonexistentSibling();
+    track->preallocate = format == wavFormat;
+
+    auto stream = std::make_unique<juce::FileOutputStream>(track->file);
+    if (stream->failedToOpen()) {
+        std::cout << "SetRecorder::createTrack can't write " << track->file.getFullPathName() << std::endl;
+        return nullptr;
+    }
+    track->stream = stream.get();
+
+    juce::WavAudioFormat wav;
+    juce::FlacAudioFormat flac;
+    juce::AudioFormat* audioFormat = &wav;
+    if (format == flacFormat)
+        audioFormat = &flac;
+
+    track->writer.reset(audioFormat->createWriterFor(stream.get(), sampleRate, 2, bitsPerSample, {}, 0));
+    if (track->writer == nullptr) {
+        std::cout << "SetRecorder::createTrack can't create a writer for " << track->file.getFullPathName() << std::endl;
+        stream.reset();
+        track->file.deleteFile();
+        return nullptr;
+    }
+    stream.release();
+
+    // the space is reserved by the writer thread before the first batch
+    track->dataEnd = track->stream->getPosition();
+    return track;
+}
+
+void SetRecorder::push(Track& track, const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    int start1, size1, start2, size2;
+    track.fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    auto lastChannel = buffer.getNumChannels() - 1;
+    for (int channel = 0; channel < 2 && lastChannel >= 0; ++channel) {
+        auto sourceChannel = juce::jmin(channel, lastChannel);
+        if (size1 > 0)
+            track.ring.copyFrom(channel, start1, buffer, sourceChannel, startSample, size1);
+        if (size2 > 0)
+            track.ring.copyFrom(channel, start2, buffer, sourceChannel, startSample + size1, size2);
+    }
+    track.fifo.finishedWrite(size1 + size2);
+
+    // the writer fell behind, the rest of the block is lost
+    if (size1 + size2 < numSamples)
+        track.dropped += numSamples - (size1 + size2);
+}
+
+void SetRecorder::writePending(Track& track)
+{
+    int start1, size1, start2, size2;
+    track.fifo.prepareToRead(track.fifo.getNumReady(), start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+        return;
+
+    if (track.preallocate)
+        reserveSpace(track);
+
+    bool ok = true;
+    if (size1 > 0)
+        ok = track.writer->writeFromAudioSampleBuffer(track.ring, start1, size1);
+    if (ok && size2 > 0)
+        ok = track.writer->writeFromAudioSampleBuffer(track.ring, start2, size2);
+    track.fifo.finishedRead(size1 + size2);
+
+    if (!ok) {
+        // a full disk: the samples are gone, count them like an overflow
+        track.dropped += size1 + size2;
+        return;
+    }
+    track.written += size1 + size2;
+    track.dataEnd = track.stream->getPosition();
+}
+
+void SetRecorder::reserveSpace(Track& track)
+{
+    // write zeros a large piece ahead of the data well before it reaches their end, so the
+    // file system allocates the space here in a few big extents instead of every batch;
+    // seeking past the end alone would only make a sparse file with nothing allocated
+    auto position = track.stream->getPosition();
+    if (position + reserveSize / 2 < track.reservedEnd)
+        return;
+
+    auto start = juce::jmax(position, track.reservedEnd);
+    track.reservedEnd = position + reserveSize;
+    if (track.stream->setPosition(start)) {
+        for (auto remaining = track.reservedEnd - start; remaining > 0; remaining -= zeroChunkSize) {
+            if (!track.stream->write(zeroChunk, (size_t) juce::jmin<juce::int64>(remaining, zeroChunkSize)))
+                break;
+        }
+    }
+    track.stream->setPosition(position);
+}
+
+void SetRecorder::finishTrack(Track& track)
+{
+    // deleting the writer writes the final header and closes the file
+    track.writer.reset();
+    track.stream = nullptr;
+
+    if (track.preallocate && track.reservedEnd > track.dataEnd) {
+        juce::FileOutputStream stream(track.file);
+        if (stream.openedOk() && stream.setPosition(track.dataEnd))
+            stream.truncate();
+    }
+}
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    SetRecorder.h
+    Created: 19 Oct 2026 12:26:05am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Records the master bus, and optionally the stem of every deck, to disk.
+
+    The audio thread only copies each block into a lock-free FIFO per file. A
+    background thread drains the FIFOs in batches and does all the file work.
+    A FIFO that overflows because the disk fell behind drops the samples that
+    do not fit, and the dropped samples are counted so it shows.
+
+    WAV files are grown well ahead of the data, and their header is rewritten
+    every second, so a crash leaves a readable file that is at most a second
+    short. FLAC streams are readable after a crash by design.
+*/
+class SetRecorder  : private juce::Thread
+{
+public:
+    enum Format
+    {
+        wavFormat = 0,
+        flacFormat
+    };
+
+    SetRecorder();
+    ~SetRecorder() override;
+
+    /**
+    *   Start recording, message thread only.
+    *   @param masterFile the file for the master bus, the stems go next to it
+    *   @param format the file format
+    *   @param numStems the number of deck stems to record, 0 for the master only
+    *   @param sampleRate the sample rate of the audio device
+    *   @return true if all files could be created
+    */
+    bool start(const juce::File& masterFile, Format format, int numStems, double sampleRate);
+
+    /** stop recording and finish the files, message thread only */
+    void stop();
+
+    /** true while recording */
+    bool isRecording() const;
+
+    /**
+    *   Audio thread: copy a block of the master bus into its FIFO.
+    *   @param buffer the block, one or two channels
+    *   @param startSample the first sample of the block
+    *   @param numSamples the number of samples in the block
+    */
+    void pushMaster(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /**
+    *   Audio thread: copy a block of a deck into its FIFO, ignored if stems are not recorded.
+    *   @param stem the deck index
+    *   @param buffer the block, one or two channels
+    *   @param startSample the first sample of the block
+    *   @param numSamples the number of samples in the block
+    */
+    void pushStem(int stem, const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** get the number of samples of the master bus written so far */
+    juce::int64 getRecordedSamples() const;
+
+    /** get the number of samples dropped because the writer fell behind, over all files */
+    juce::int64 getDroppedSamples() const;
+
+private:
+    // about 6 seconds at 44.1 kHz
+    static constexpr int fifoSize = 1 << 18;
+
+    // WAV files grow by this much at a time
+    static constexpr juce::int64 reserveSize = 64 * 1024 * 1024;
+
+    struct Track
+    {
+        juce::File file;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        juce::FileOutputStream* stream = nullptr;  // owned by the writer
+        bool preallocate = false;
+        juce::int64 reservedEnd = 0;
+        juce::int64 dataEnd = 0;
+
+        juce::AbstractFifo fifo{ fifoSize };
+        juce::AudioBuffer<float> ring{ 2, fifoSize };
+        std::atomic<juce::int64> written{ 0 };
+        std::atomic<juce::int64> dropped{ 0 };
+    };
+
+    void run() override;
+
+    /** create the writer of a track, returns nullptr if the file can't be written */
+    std::unique_ptr<Track> createTrack(const juce::File& file, Format format, double sampleRate);
+
+    /** audio thread: copy into the FIFO of a track */
+    void push(Track& track, const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** writer thread: write everything waiting in a track's FIFO */
+    void writePending(Track& track);
+
+    /** writer thread: write zeros ahead of the data, so its disk space is allocated before it is needed */
+    void reserveSpace(Track& track);
+
+    /** close the writer and cut off the unused reserved space */
+    void finishTrack(Track& track);
+
+    // the master is track 0, the stems follow
+    juce::OwnedArray<Track> tracks;
+    juce::SpinLock trackLock;
+    std::atomic<bool> recording{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SetRecorder)
+};
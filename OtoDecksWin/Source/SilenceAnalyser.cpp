@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    SilenceAnalyser.cpp
+    Created: 19 Oct 2026 8:12:55am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "SilenceAnalyser.h"
+
+namespace
+{
+    // quieter than this is dead air; vinyl rips and dithered silence stay below it
+    const float thresholdDecibels = -60.0f;
+}
+
+SilenceAnalyser::SilenceAnalyser()
+{
+}
+
+SilenceAnalyser::~SilenceAnalyser()
+{
+}
+
+void SilenceAnalyser::prepare(double _sampleRate, int _numChannels)
+{
+    sampleRate = _sampleRate;
+    numChannels = juce::jlimit(1, maxChannels, _numChannels);
+    threshold = juce::Decibels::decibelsToGain(thresholdDecibels);
+
+    position = 0;
+    firstAudible = -1;
+    lastAudible = -1;
+}
+
+void SilenceAnalyser::process(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    auto channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+    for (int start = 0; start < numSamples; start += chunkSize) {
+        auto num = juce::jmin(chunkSize, numSamples - start);
+
+        auto peak = 0.0f;
+        for (int channel = 0; channel < channels; ++channel) {
+            auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(channel, start), num);
+            peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+        }
+        if (peak < threshold)
+            continue;
+
+        if (firstAudible < 0) {
+            auto i = start;
+            while (!isAudible(buffer, i))
+                ++i;
+            firstAudible = position + i;
+        }
+
+        auto i = start + num - 1;
+        while (!isAudible(buffer, i))
+            --i;
+        lastAudible = position + i;
+    }
+    position += numSamples;
+}
+
+bool SilenceAnalyser::isAudible(const juce::AudioBuffer<float>& buffer, int sample) const
+{
+    for (int channel = 0; channel < juce::jmin(numChannels, buffer.getNumChannels()); ++channel)
+        if (std::abs(buffer.getSample(channel, sample)) >= threshold)
+            return true;
+    return false;
+}
+
+void SilenceAnalyser::finish(TrackAnalysis& analysis)
+{
+    // a silent track plays from start to end
+    if (firstAudible < 0) {
+        analysis.autoCue = 0.0;
+        analysis.autoEnd = 0.0;
+        return;
+    }
+    analysis.autoCue = firstAudible / sampleRate;
+    analysis.autoEnd = (lastAudible + 1) / sampleRate;
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    SilenceAnalyser.h
+    Created: 19 Oct 2026 8:12:55am
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Finds the first and the last audible sample of a track, which become its
+    auto-cue and auto-end points.
+
+    Blocks are scanned in chunks with the vectorised min/max search, so the
+    silent stretches cost only that; the sample itself is looked for in the
+    chunks where the level crosses the threshold.
+*/
+class SilenceAnalyser
+{
+public:
+    SilenceAnalyser();
+    ~SilenceAnalyser();
+
+    /**
+    *   Reset the analyser for a new track.
+    *   @param sampleRate the sample rate of the track
+    *   @param numChannels 1 for mono tracks, otherwise the first two channels are scanned
+    */
+    void prepare(double sampleRate, int numChannels);
+
+    /**
+    *   Feed the next block of the track.
+    *   @param buffer the decoded audio, with at least numChannels channels
+    *   @param numSamples the number of samples to use from the buffer
+    */
+    void process(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    /**
+    *   Store the auto-cue and auto-end points of everything fed so far.
+    *   @param analysis the analysis to fill in
+    */
+    void finish(TrackAnalysis& analysis);
+
+private:
+    static constexpr int chunkSize = 256;
+    static constexpr int maxChannels = 2;
+
+    /** true if a sample of any channel reaches the threshold */
+    bool isAudible(const juce::AudioBuffer<float>& buffer, int sample) const;
+
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+    float threshold = 0.0f;
+
+    juce::int64 position = 0;
+    juce::int64 firstAudible = -1;
+    juce::int64 lastAudible = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SilenceAnalyser)
+};
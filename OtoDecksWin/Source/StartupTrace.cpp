@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    StartupTrace.cpp
+    Created: 19 Oct 2026 11:06:40pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "StartupTrace.h"
+#include "AppData.h"
+
+StartupTrace::StartupTrace()
+{
+    startTime = lastTime = juce::Time::getMillisecondCounterHiRes();
+}
+
+StartupTrace::~StartupTrace()
+{
+}
+
+void StartupTrace::mark(const juce::String& phase)
+{
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    phases.add({ phase, now - lastTime, now - startTime });
+    lastTime = now;
+}
+
+void StartupTrace::markInteractive()
+{
+    if (isInteractive())
+        return;
+
+    mark("first paint");
+    interactiveTime = phases.getLast().elapsed;
+}
+
+bool StartupTrace::isInteractive() const
+{
+    return interactiveTime >= 0.0;
+}
+
+void StartupTrace::writeLog(const juce::File& logFile) const
+{
+    juce::String log;
+    log << "OtoDecks startup " << juce::Time::getCurrentTime().toString(true, true) << "\n";
+
+    for (auto& phase : phases)
+        log << phase.name.paddedRight(' ', 24) << juce::String(phase.duration, 1).paddedLeft(' ', 10) << " ms"
+            << juce::String(phase.elapsed, 1).paddedLeft(' ', 10) << " ms\n";
+
+    if (isInteractive())
+        log << "interactive after " << juce::String(interactiveTime, 1) << " ms, target "
+            << juce::String(interactiveTarget, 0) << " ms" << (interactiveTime > interactiveTarget ? " MISSED" : "") << "\n";
+
+    if (!logFile.replaceWithText(log))
+        std::cout << "StartupTrace::writeLog could not write " << logFile.getFullPathName() << std::endl;
+}
+
+juce::File StartupTrace::getDefaultLogFile()
+{
+    // overwritten by every start, only the last one is of interest
+    return AppData::getFile("startup.log");
+}
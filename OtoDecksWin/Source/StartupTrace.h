@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    StartupTrace.h
+    Created: 19 Oct 2026 11:06:40pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Times the phases of the application startup and writes them to a log, so
+    slow starts can be traced to the phase which caused them.
+
+    Each phase is timed from the end of the one before, and the total from the
+    construction of the trace. Only used from the message thread.
+*/
+class StartupTrace
+{
+public:
+    StartupTrace();
+    ~StartupTrace();
+
+    /**
+    *   Record that a phase has finished.
+    *   @param phase the name of the phase
+    */
+    void mark(const juce::String& phase);
+
+    /** record that the window can be used, which is what the target is measured against */
+    void markInteractive();
+
+    /** true once markInteractive() has been called */
+    bool isInteractive() const;
+
+    /**
+    *   Write the phases to a log file, replacing the log of the previous start.
+    *   @param logFile the file to write
+    */
+    void writeLog(const juce::File& logFile) const;
+
+    /** the log file used by the application */
+    static juce::File getDefaultLogFile();
+
+    /** time from the start to an interactive window we aim for, in milliseconds */
+    static constexpr double interactiveTarget = 500.0;
+
+private:
+    struct Phase
+    {
+        juce::String name;
+        double duration = 0.0;
+        double elapsed = 0.0;
+    };
+
+    double startTime = 0.0;
+    double lastTime = 0.0;
+    double interactiveTime = -1.0;
+    juce::Array<Phase> phases;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StartupTrace)
+};
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    TrackAnalyser.cpp
+    Created: 18 Oct 2026 2:02:18pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include "TrackAnalyser.h"
+#include "BeatAnalyser.h"
+#include "LoudnessAnalyser.h"
+#include "KeyAnalyser.h"
+#include "SilenceAnalyser.h"
+
+//==============================================================================
+class TrackAnalyser::AnalysisJob  : public juce::ThreadPoolJob
+{
+public:
+    AnalysisJob(TrackAnalyser& _owner, const juce::File& _trackFile)
+        : juce::ThreadPoolJob("Track analysis"), owner(_owner), trackFile(_trackFile)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        TrackAnalysis analysis;
+        std::unique_ptr<juce::AudioFormatReader> reader(owner.formatManager.createReaderFor(trackFile));
+
+        if (reader != nullptr && reader->lengthInSamples > 0) {
+            BeatAnalyser beats;
+            beats.prepare(reader->sampleRate, reader->lengthInSamples);
+            LoudnessAnalyser loudness;
+            loudness.prepare(reader->sampleRate, (int) reader->numChannels);
+            KeyAnalyser key;
+            key.prepare(reader->sampleRate);
+            SilenceAnalyser silence;
+            silence.prepare(reader->sampleRate, (int) reader->numChannels);
+
+            // decode the track once and feed every analyser from the same block
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            for (juce::int64 pos = 0; pos < reader->lengthInSamples; pos += blockSize) {
+                if (shouldExit())
+                    return jobHasFinished;
+
+                auto num = (int) juce::jmin<juce::int64>(blockSize, reader->lengthInSamples - pos);
+                reader->read(&buffer, 0, num, pos, true, true);
+                beats.process(buffer, num);
+                loudness.process(buffer, num);
+                key.process(buffer, num);
+                silence.process(buffer, num);
+            }
+            beats.finish(analysis);
+            loudness.finish(analysis);
+            key.finish(analysis);
+            silence.finish(analysis);
+        }
+        else {
+            std::cout << "TrackAnalyser: could not read " << trackFile.getFullPathName() << std::endl;
+        }
+
+        owner.jobFinished(trackFile, analysis);
+        return jobHasFinished;
+    }
+
+private:
+    static constexpr int blockSize = 65536;
+
+    TrackAnalyser& owner;
+    juce::File trackFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisJob)
+};
+
+//==============================================================================
+TrackAnalyser::TrackAnalyser()
+    : pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1))  // leave a core to the audio and message threads
+{
+    formatManager.registerBasicFormats();
+    pool.setThreadPriorities(2);
+}
+
+TrackAnalyser::~TrackAnalyser()
+{
+    urgentPool.removeAllJobs(true, 5000);
+    pool.removeAllJobs(true, 5000);
+}
+
+void TrackAnalyser::analyse(const juce::File& trackFile, bool urgent)
+{
+    auto path = trackFile.getFullPathName();
+    {
+        const juce::ScopedLock sl(lock);
+        // an urgent request may overtake a queued one, the first result wins
+        auto& queue = urgent ? pendingUrgent : pending;
+        if (queue.contains(path))
+            return;
+        queue.add(path);
+    }
+    (urgent ? urgentPool : pool).addJob(new AnalysisJob(*this, trackFile), true);
+}
+
+bool TrackAnalyser::isAnalysing(const juce::File& trackFile) const
+{
+    const juce::ScopedLock sl(lock);
+    return pending.contains(trackFile.getFullPathName())
+        || pendingUrgent.contains(trackFile.getFullPathName());
+}
+
+bool TrackAnalyser::isBusy() const
+{
+    const juce::ScopedLock sl(lock);
+    return !pending.isEmpty() || !pendingUrgent.isEmpty();
+}
+
+void TrackAnalyser::collectResults(std::vector<Result>& results)
+{
+    const juce::ScopedLock sl(lock);
+    for (auto& result : finished)
+        results.push_back(result);
+    finished.clear();
+}
+
+void TrackAnalyser::jobFinished(const juce::File& trackFile, const TrackAnalysis& analysis)
+{
+    const juce::ScopedLock sl(lock);
+    pending.removeString(trackFile.getFullPathName());
+    pendingUrgent.removeString(trackFile.getFullPathName());
+    finished.push_back({ trackFile, analysis });
+}
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    TrackAnalyser.h
+    Created: 18 Oct 2026 2:02:18pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Analyses library tracks on a pool of low priority background threads, one
+    track per job, so a whole import is spread over the cores while the audio
+    thread keeps its own.
+
+    Each job decodes its track once and feeds every analyser from the same
+    blocks. Finished results are collected by the message thread.
+*/
+class TrackAnalyser
+{
+public:
+    struct Result
+    {
+        juce::File trackFile;
+        TrackAnalysis analysis;
+    };
+
+    TrackAnalyser();
+    ~TrackAnalyser();
+
+    /**
+    *   Queue a track for analysis, unless it is already queued.
+    *   @param trackFile the track file to be analysed
+    *   @param urgent true to analyse it on a separate thread, ahead of the queue
+    */
+    void analyse(const juce::File& trackFile, bool urgent = false);
+
+    /**
+    *   Check if a track is queued or being analysed.
+    *   @param trackFile the track file
+    *   @return true if the analysis of the track is not finished yet
+    */
+    bool isAnalysing(const juce::File& trackFile) const;
+
+    /** true if any track is queued or being analysed */
+    bool isBusy() const;
+
+    /**
+    *   Move the results finished since the last call into the given vector.
+    *   @param results the vector the results are appended to
+    */
+    void collectResults(std::vector<Result>& results);
+
+private:
+    class AnalysisJob;
+
+    void jobFinished(const juce::File& trackFile, const TrackAnalysis& analysis);
+
+    juce::AudioFormatManager formatManager;
+
+    juce::CriticalSection lock;
+    juce::StringArray pending;
+    juce::StringArray pendingUrgent;
+    std::vector<Result> finished;
+
+    // declared last so the jobs are stopped before anything they use goes away
+    juce::ThreadPool pool;
+    juce::ThreadPool urgentPool{ 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackAnalyser)
+};
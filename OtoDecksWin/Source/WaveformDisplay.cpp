@@ -1,89 +1,113 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.cpp
-    Created: 12 Aug 2020 2:48:32pm
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "WaveformDisplay.h"
-
-//==============================================================================
-WaveformDisplay::WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
-                                 juce::AudioThumbnailCache& cacheToUse):
-                                 audioThumb(1000, formatManagerToUse, cacheToUse),
-                                 fileLoaded(false),
-                                 position(0)
-{
-    // In your constructor, you should add any child components, and
-    // initialise any special settings that your component needs.
-    audioThumb.addChangeListener(this);
-}
-
-WaveformDisplay::~WaveformDisplay()
-{
-}
-
-void WaveformDisplay::paint (juce::Graphics& g)
-{
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
-
-    g.setColour(juce::Colours::black);
-    g.fillAll();
-
-    g.setColour (juce::Colours::grey);
-    g.drawRect (getLocalBounds(), 1);   // draw an outline around the component
-
-    g.setColour (juce::Colour(115, 181, 221));
-    if (fileLoaded) {
-            audioThumb.drawChannel(g,
-                                   getLocalBounds(),
-                                   0,
-                                   audioThumb.getTotalLength(),
-                                   0,
-                                   1.0f);
-            g.setColour(juce::Colours::lightgreen);
-            g.drawRect(position * getWidth(), 0, getWidth() /20, getHeight());
-    }
-    else {
-        g.setFont(20.0f);
-        g.drawText("File not loaded...", getLocalBounds(),
-            juce::Justification::centred, true);   // draw some placeholder text
-    }  
-}
-
-void WaveformDisplay::resized()
-{
-    // This method is where you should set the bounds of any child
-    // components that your component contains..
-
-}
-
-void WaveformDisplay::loadURL(juce::URL audioURL)
-{    
-    audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new juce::URLInputSource(audioURL));
-    if (fileLoaded) {
-        std::cout << "wfd: loaded!" << std::endl;
-    }
-    else {
-        std::cout << "wfd: not loaded!" << std::endl;
-    }
-}
-
-void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
-{
-    std::cout << "wfd: change received!" << std::endl;
-    repaint();
-}
-
-void WaveformDisplay::setPositionRelative(double pos)
-{
-    if (pos != position) {
-        position = pos;
-        repaint();
-    }    
-}
+/*
+  ==============================================================================
+
+    WaveformDisplay.cpp
+    Created: 12 Aug 2020 2:48:32pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "WaveformDisplay.h"
+
+//==============================================================================
+WaveformDisplay::WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
+                                 juce::AudioThumbnailCache& cacheToUse):
+                                 audioThumb(1000, formatManagerToUse, cacheToUse),
+                                 fileLoaded(false),
+                                 position(0)
+{
+    // In your constructor, you should add any child components, and
+    // initialise any special settings that your component needs.
+    audioThumb.addChangeListener(this);
+}
+
+WaveformDisplay::~WaveformDisplay()
+{
+}
+
+void WaveformDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
+
+    g.setColour(juce::Colours::black);
+    g.fillAll();
+
+    g.setColour (juce::Colours::grey);
+    g.drawRect (getLocalBounds(), 1);   // draw an outline around the component
+
+    g.setColour (juce::Colour(115, 181, 221));
+    if (fileLoaded) {
+            audioThumb.drawChannel(g,
+                                   getLocalBounds(),
+                                   0,
+                                   audioThumb.getTotalLength(),
+                                   0,
+                                   1.0f);
+
+            // dim the silence which PLAY and automix skip, and mark the auto-cue point
+            auto length = audioThumb.getTotalLength();
+            if (length > 0 && autoEnd > 0) {
+                auto cueX = (float) (autoCue / length * getWidth());
+                auto endX = (float) (autoEnd / length * getWidth());
+                g.setColour(juce::Colours::black.withAlpha(0.6f));
+                g.fillRect(0.0f, 0.0f, cueX, (float) getHeight());
+                g.fillRect(endX, 0.0f, getWidth() - endX, (float) getHeight());
+                g.setColour(juce::Colour(255, 179, 71));
+                g.drawVerticalLine(juce::roundToInt(cueX), 0.0f, (float) getHeight());
+                g.drawVerticalLine(juce::jmin(juce::roundToInt(endX), getWidth() - 1), 0.0f, (float) getHeight());
+            }
+
+            g.setColour(juce::Colours::lightgreen);
+            g.drawRect(position * getWidth(), 0, getWidth() /20, getHeight());
+    }
+    else {
+        g.setFont(20.0f);
+        g.drawText("File not loaded...", getLocalBounds(),
+            juce::Justification::centred, true);   // draw some placeholder text
+    }  
+}
+
+void WaveformDisplay::resized()
+{
+    // This method is where you should set the bounds of any child
+    // components that your component contains..
+
+}
+
+void WaveformDisplay::loadURL(juce::URL audioURL)
+{    
+    audioThumb.clear();
+    autoCue = autoEnd = 0.0;
+    fileLoaded = audioThumb.setSource(new juce::URLInputSource(audioURL));
+    if (fileLoaded) {
+        std::cout << "wfd: loaded!" << std::endl;
+    }
+    else {
+        std::cout << "wfd: not loaded!" << std::endl;
+    }
+}
+
+void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    std::cout << "wfd: change received!" << std::endl;
+    repaint();
+}
+
+void WaveformDisplay::setPositionRelative(double pos)
+{
+    if (pos != position) {
+        position = pos;
+        repaint();
+    }    
+}
+
+void WaveformDisplay::setAutoCuePoints(double newAutoCue, double newAutoEnd)
+{
+    if (newAutoCue != autoCue || newAutoEnd != autoEnd) {
+        autoCue = newAutoCue;
+        autoEnd = newAutoEnd;
+        repaint();
+    }
+}
\ No newline at end of file
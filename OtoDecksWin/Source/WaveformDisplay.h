@@ -1,42 +1,51 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.h
-    Created: 12 Aug 2020 2:48:32pm
-    Author:  ashigam
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-//==============================================================================
-/*
-*/
-class WaveformDisplay  : public juce::Component,
-                         public juce::ChangeListener
-{
-public:
-    WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
-                    juce::AudioThumbnailCache& cacheToUse);
-    ~WaveformDisplay() override;
-
-    void paint (juce::Graphics&) override;
-    void resized() override;
-
-    void changeListenerCallback(juce::ChangeBroadcaster *source) override;
-
-    void loadURL(juce::URL audioURL);
-
-    /** set the relative position of the playhead */
-    void setPositionRelative(double pos);
-
-private:
-    juce::AudioThumbnail audioThumb;
-    bool fileLoaded;
-    double position;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
-};
+/*
+  ==============================================================================
+
+    WaveformDisplay.h
+    Created: 12 Aug 2020 2:48:32pm
+    Author:  ashigam
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+*/
+class WaveformDisplay  : public juce::Component,
+                         public juce::ChangeListener
+{
+public:
+    WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
+                    juce::AudioThumbnailCache& cacheToUse);
+    ~WaveformDisplay() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    void changeListenerCallback(juce::ChangeBroadcaster *source) override;
+
+    void loadURL(juce::URL audioURL);
+
+    /** set the relative position of the playhead */
+    void setPositionRelative(double pos);
+
+    /**
+    *   Mark where the audio of the track starts and ends, the silence around it is dimmed.
+    *   @param autoCue the first audible position in seconds
+    *   @param autoEnd the position after the last audible sample in seconds, 0 if unknown
+    */
+    void setAutoCuePoints(double autoCue, double autoEnd);
+
+private:
+    juce::AudioThumbnail audioThumb;
+    bool fileLoaded;
+    double position;
+    double autoCue = 0.0;
+    double autoEnd = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
+};